@@ -0,0 +1,432 @@
+#include "Benchmark.h"
+#include "Utilities.h"
+#include "TaikoSwitchDataTable.h"
+#include <chrono>
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	namespace Benchmark
+	{
+		namespace
+		{
+			// NOTE: Anything slower than this (relative to the baseline) is reported as a regression
+			constexpr f64 RegressionThreshold = 0.10;
+
+			constexpr f64 MinSecondsPerBenchmark = 0.25;
+			constexpr u32 MinIterationsPerBenchmark = 3;
+
+			// NOTE: Relative to the working directory and removed again once all write benchmarks have finished
+			constexpr std::string_view ScratchDirectoryPath = "TaikoSwitchDataTableDecryptor_benchmark_scratch";
+
+			struct CorpusSize
+			{
+				const char* Label;
+				size_t ByteSize;
+			};
+
+			// NOTE: Spanning tiny tables up to the (IV adjusted) maximum size supported by the game
+			constexpr std::array<CorpusSize, 4> CorpusSizes =
+			{
+				CorpusSize { "1kb", 0x400 },
+				CorpusSize { "16kb", 0x4000 },
+				CorpusSize { "256kb", 0x40000 },
+				CorpusSize { "2mb", MaxDecompressedGameDataTableFileSize - 0x10000 },
+			};
+
+			struct CorpusEntry
+			{
+				const char* Label;
+				std::string Json;
+				std::vector<u8> CompressedBin;
+				std::vector<u8> EncryptedBin;
+				std::vector<u8> EncryptedBinUsingLastKey;
+			};
+
+			struct BenchmarkResult
+			{
+				std::string Name;
+				f64 NanosecondsPerIteration;
+				f64 MegabytesPerSecond;
+			};
+
+			// NOTE: Written to after every iteration so that the compiler can't optimize away any of the benchmarked work
+			volatile size_t BenchmarkSink = 0;
+
+			struct XorShiftRandom
+			{
+				u32 State;
+
+				u32 Next() { State ^= (State << 13); State ^= (State >> 17); State ^= (State << 5); return State; }
+				u32 NextInRange(u32 min, u32 max) { return min + (Next() % (max - min + 1)); }
+				bool NextBool() { return (Next() & 1) != 0; }
+			};
+
+			std::vector<u8> EncodeBinFileContent(std::string_view json, const NamedEncryptionKey* key, IVMode ivMode, PeepoHappy::Compression::Deflater* reusableDeflater)
+			{
+				// NOTE: The exact same encoding the regular .json -> .bin conversion uses, just without touching the file system
+				const EncodedBinFile binFile = EncodeJsonFileContent(reinterpret_cast<const u8*>(json.data()), json.size(), key, ivMode, nullptr, reusableDeflater);
+				return (binFile.Content != nullptr) ? std::vector<u8>(binFile.Content, binFile.Content + binFile.Size) : std::vector<u8>();
+			}
+
+			size_t DecodeBinFileContent(const std::vector<u8>& binFileContent, const std::vector<NamedEncryptionKey>& namedKeys)
+			{
+				// NOTE: The exact same decoding the regular .bin -> .json conversion uses, just without touching the file system
+				return TaikoSwitchDataTableDecryptor::DecodeBinFileContent(binFileContent.data(), binFileContent.size(), namedKeys).Json.size();
+			}
+
+			template <typename Func>
+			void Measure(std::vector<BenchmarkResult>& outResults, std::string name, size_t bytesPerIteration, Func func)
+			{
+				// NOTE: Warm up caches and the allocator before measuring anything
+				BenchmarkSink = BenchmarkSink + static_cast<size_t>(func());
+
+				u32 iterations = 0;
+				f64 elapsedSeconds = 0.0;
+				const auto startTime = std::chrono::steady_clock::now();
+
+				do
+				{
+					BenchmarkSink = BenchmarkSink + static_cast<size_t>(func());
+					iterations++;
+					elapsedSeconds = std::chrono::duration<f64>(std::chrono::steady_clock::now() - startTime).count();
+				}
+				while (iterations < MinIterationsPerBenchmark || elapsedSeconds < MinSecondsPerBenchmark);
+
+				const f64 secondsPerIteration = (elapsedSeconds / iterations);
+				BenchmarkResult& result = outResults.emplace_back();
+				result.Name = std::move(name);
+				result.NanosecondsPerIteration = (secondsPerIteration * 1000000000.0);
+				result.MegabytesPerSecond = (static_cast<f64>(bytesPerIteration) / (1024.0 * 1024.0)) / secondsPerIteration;
+
+				printf("%-44s %14.0f ns %10.2f MB/s\n", result.Name.c_str(), result.NanosecondsPerIteration, result.MegabytesPerSecond);
+			}
+
+			bool WriteResults(std::string_view resultsOutputFilePath, const std::vector<BenchmarkResult>& results)
+			{
+				char buffer[256];
+				std::string json;
+				json += "{\n";
+				for (size_t i = 0; i < results.size(); i++)
+				{
+					sprintf_s(buffer, "\t\"%s\": { \"ns_per_iteration\": %.3f, \"mb_per_second\": %.3f }%s\n", results[i].Name.c_str(), results[i].NanosecondsPerIteration, results[i].MegabytesPerSecond, ((i + 1) < results.size()) ? "," : "");
+					json += buffer;
+				}
+				json += "}\n";
+
+				return PeepoHappy::IO::WriteEntireFile(resultsOutputFilePath, reinterpret_cast<const u8*>(json.data()), json.size());
+			}
+
+			// NOTE: Only understands the exact format written by WriteResults(), this is by no means a general purpose JSON parser
+			std::vector<BenchmarkResult> ParseBaselineResults(std::string_view baselineJson)
+			{
+				constexpr std::string_view valueKey = "\"ns_per_iteration\":";
+
+				std::vector<BenchmarkResult> results;
+				for (size_t valueIndex = baselineJson.find(valueKey); valueIndex != std::string_view::npos; valueIndex = baselineJson.find(valueKey, valueIndex + 1))
+				{
+					const size_t braceIndex = baselineJson.rfind('{', valueIndex);
+					const size_t nameEnd = (braceIndex != std::string_view::npos) ? baselineJson.rfind('"', braceIndex) : std::string_view::npos;
+					const size_t nameStart = (nameEnd != std::string_view::npos && nameEnd > 0) ? baselineJson.rfind('"', nameEnd - 1) : std::string_view::npos;
+					if (nameStart == std::string_view::npos)
+						continue;
+
+					const std::string valueString { PeepoHappy::ASCII::TrimLeft(baselineJson.substr(valueIndex + valueKey.size(), 32)) };
+
+					BenchmarkResult& result = results.emplace_back();
+					result.Name = baselineJson.substr(nameStart + 1, nameEnd - nameStart - 1);
+					result.NanosecondsPerIteration = strtod(valueString.c_str(), nullptr);
+				}
+				return results;
+			}
+		}
+
+		std::string GenerateSyntheticDataTableJson(size_t targetByteSize, u32 seed)
+		{
+			// NOTE: Stops adding items once the target size has been reached so the result may end up slightly larger
+			constexpr std::array<const char*, 5> difficultyNames = { "Easy", "Normal", "Hard", "Mania", "Ura" };
+
+			XorShiftRandom random = { (seed != 0) ? seed : 0xDEADBEEF };
+			char buffer[128];
+
+			std::string json;
+			json.reserve(targetByteSize + 0x1000);
+			json += "{\n\t\"items\": [\n";
+
+			for (u32 itemIndex = 0; json.size() < targetByteSize; itemIndex++)
+			{
+				char songID[8] = {};
+				for (size_t i = 0; i < 6; i++)
+					songID[i] = static_cast<char>('a' + random.NextInRange(0, 25));
+
+				json += (itemIndex > 0) ? ",\n\t\t{\n" : "\t\t{\n";
+				sprintf_s(buffer, "\t\t\t\"id\": \"%s\",\n", songID); json += buffer;
+				sprintf_s(buffer, "\t\t\t\"uniqueId\": %u,\n", itemIndex); json += buffer;
+				sprintf_s(buffer, "\t\t\t\"genreNo\": %u,\n", random.NextInRange(0, 7)); json += buffer;
+				sprintf_s(buffer, "\t\t\t\"songFileName\": \"sound/song_%s\",\n", songID); json += buffer;
+				sprintf_s(buffer, "\t\t\t\"papamama\": %s,\n", random.NextBool() ? "true" : "false"); json += buffer;
+
+				for (const char* difficulty : difficultyNames)
+				{
+					sprintf_s(buffer, "\t\t\t\"branch%s\": %s,\n", difficulty, random.NextBool() ? "true" : "false"); json += buffer;
+					sprintf_s(buffer, "\t\t\t\"star%s\": %u,\n", difficulty, random.NextInRange(1, 10)); json += buffer;
+					sprintf_s(buffer, "\t\t\t\"shinuti%s\": %u,\n", difficulty, random.NextInRange(1000, 20000) * 10); json += buffer;
+					sprintf_s(buffer, "\t\t\t\"shinuti%sDuet\": %u,\n", difficulty, random.NextInRange(1000, 20000) * 10); json += buffer;
+					sprintf_s(buffer, "\t\t\t\"score%s\": %u,\n", difficulty, random.NextInRange(100000, 1000000) * 10); json += buffer;
+				}
+
+				sprintf_s(buffer, "\t\t\t\"spikeOnEasy\": %u\n", random.NextInRange(0, 3)); json += buffer;
+				json += "\t\t}";
+			}
+
+			json += "\n\t]\n}\n";
+			return json;
+		}
+
+		int RunAllBenchmarks(const std::vector<NamedEncryptionKey>& namedKeys, IVMode ivMode, std::string_view resultsOutputFilePath, std::string_view baselineInputFilePath, u32 maxThreadCount)
+		{
+			const NamedEncryptionKey* firstKey = namedKeys.empty() ? nullptr : &namedKeys.front();
+			const NamedEncryptionKey* lastKey = namedKeys.empty() ? nullptr : &namedKeys.back();
+
+			const auto first128BitKey = std::find_if(namedKeys.begin(), namedKeys.end(), [](auto& key) { return key.KeyByteSize == PeepoHappy::Crypto::Aes128KeySize; });
+			const auto first256BitKey = std::find_if(namedKeys.begin(), namedKeys.end(), [](auto& key) { return key.KeyByteSize == PeepoHappy::Crypto::Aes256KeySize; });
+
+			if (firstKey == nullptr)
+				printf("No encrpytion keys available, only unencrypted benchmarks will be run\n");
+
+			printf("Generating synthetic DataTable corpus...\n");
+			std::vector<CorpusEntry> corpus;
+			for (const CorpusSize& size : CorpusSizes)
+			{
+				CorpusEntry& entry = corpus.emplace_back();
+				entry.Label = size.Label;
+				entry.Json = GenerateSyntheticDataTableJson(size.ByteSize, static_cast<u32>(size.ByteSize));
+				entry.CompressedBin = EncodeBinFileContent(entry.Json, nullptr, ivMode, nullptr);
+				entry.EncryptedBin = (firstKey != nullptr) ? EncodeBinFileContent(entry.Json, firstKey, ivMode, nullptr) : entry.CompressedBin;
+				entry.EncryptedBinUsingLastKey = (lastKey != nullptr) ? EncodeBinFileContent(entry.Json, lastKey, ivMode, nullptr) : entry.CompressedBin;
+			}
+
+			// NOTE: The embeddable library gets its own copy of every key and expands them once per codec
+			std::vector<std::string> nullTerminatedKeyNames;
+			std::vector<TSDT_KeyDefinition> libraryKeyDefinitions;
+			nullTerminatedKeyNames.reserve(namedKeys.size());
+			for (const NamedEncryptionKey& key : namedKeys)
+			{
+				const std::string& name = nullTerminatedKeyNames.emplace_back(key.Name);
+				const u8* keyBytes = (key.KeyByteSize == key.Key256.size()) ? key.Key256.data() : key.Key128.data();
+				libraryKeyDefinitions.push_back(TSDT_KeyDefinition { name.c_str(), keyBytes, key.KeyByteSize });
+			}
+
+			TSDT_Context* libraryContext = nullptr;
+			TSDT_Codec* libraryCodec = nullptr;
+			if (TSDT_CreateContext(nullptr, libraryKeyDefinitions.data(), libraryKeyDefinitions.size(), &libraryContext) != TSDT_RESULT_SUCCESS || TSDT_CreateCodec(libraryContext, &libraryCodec) != TSDT_RESULT_SUCCESS)
+				fprintf(stderr, "Failed to create library context, skipping library benchmarks\n");
+
+			auto libraryEncode = [&](const std::string& json, int32_t keyIndex)
+			{
+				TSDT_EncodeOptions options = {};
+				options.KeyIndex = keyIndex;
+				options.IVMode = (ivMode == IVMode::Constant) ? TSDT_IV_MODE_CONSTANT : TSDT_IV_MODE_CONTENT;
+
+				TSDT_Buffer binBuffer = {};
+				TSDT_Encode(libraryCodec, reinterpret_cast<const u8*>(json.data()), json.size(), &options, &binBuffer);
+				const size_t binSize = binBuffer.Size;
+				TSDT_FreeBuffer(libraryContext, &binBuffer);
+				return binSize;
+			};
+
+			auto libraryDecode = [&](const std::vector<u8>& binFileContent)
+			{
+				TSDT_Buffer jsonBuffer = {};
+				TSDT_Decode(libraryCodec, binFileContent.data(), binFileContent.size(), &jsonBuffer, nullptr);
+				const size_t jsonSize = jsonBuffer.Size;
+				TSDT_FreeBuffer(libraryContext, &jsonBuffer);
+				return jsonSize;
+			};
+
+			// NOTE: Reused between iterations just like every conversion thread reuses its own deflater between files
+			PeepoHappy::Compression::Deflater reusableDeflater;
+
+			std::vector<BenchmarkResult> results;
+			auto outputBuffer = std::make_unique<u8[]>(MaxDecompressedGameDataTableFileSize * 2);
+
+			for (const CorpusEntry& entry : corpus)
+			{
+				const u8* jsonData = reinterpret_cast<const u8*>(entry.Json.data());
+				const size_t jsonSize = entry.Json.size();
+				const size_t alignedCompressedSize = PeepoHappy::Crypto::Align(entry.CompressedBin.size(), PeepoHappy::Crypto::AesBlockAlignment);
+				const std::string suffix = std::string("_") + entry.Label;
+
+				Measure(results, "deflate" + suffix, jsonSize, [&] { return PeepoHappy::Compression::Deflate(jsonData, jsonSize, outputBuffer.get(), MaxDecompressedGameDataTableFileSize); });
+				Measure(results, "inflate" + suffix, jsonSize, [&] { return PeepoHappy::Compression::Inflate(entry.CompressedBin.data(), entry.CompressedBin.size(), outputBuffer.get(), MaxDecompressedGameDataTableFileSize); });
+
+				const PeepoHappy::Crypto::AesIVBytes iv = ConstantEncryptionIV;
+
+				if (first128BitKey != namedKeys.end())
+				{
+					Measure(results, "aes128_encrypt" + suffix, alignedCompressedSize, [&] { return PeepoHappy::Crypto::EncryptAes128Cbc(outputBuffer.get(), outputBuffer.get() + MaxDecompressedGameDataTableFileSize, alignedCompressedSize, first128BitKey->Key128, iv); });
+					Measure(results, "aes128_decrypt" + suffix, alignedCompressedSize, [&] { return PeepoHappy::Crypto::DecryptAes128Cbc(outputBuffer.get(), outputBuffer.get() + MaxDecompressedGameDataTableFileSize, alignedCompressedSize, first128BitKey->Key128, iv); });
+				}
+
+				if (first256BitKey != namedKeys.end())
+				{
+					Measure(results, "aes256_encrypt" + suffix, alignedCompressedSize, [&] { return PeepoHappy::Crypto::EncryptAes256Cbc(outputBuffer.get(), outputBuffer.get() + MaxDecompressedGameDataTableFileSize, alignedCompressedSize, first256BitKey->Key256, iv); });
+					Measure(results, "aes256_decrypt" + suffix, alignedCompressedSize, [&] { return PeepoHappy::Crypto::DecryptAes256Cbc(outputBuffer.get(), outputBuffer.get() + MaxDecompressedGameDataTableFileSize, alignedCompressedSize, first256BitKey->Key256, iv); });
+				}
+
+				Measure(results, "encode_unencrypted" + suffix, jsonSize, [&] { return EncodeBinFileContent(entry.Json, nullptr, ivMode, &reusableDeflater).size(); });
+				Measure(results, "decode_unencrypted" + suffix, jsonSize, [&] { return DecodeBinFileContent(entry.CompressedBin, namedKeys); });
+
+				if (firstKey != nullptr)
+				{
+					Measure(results, "encode_encrypted" + suffix, jsonSize, [&] { return EncodeBinFileContent(entry.Json, firstKey, ivMode, &reusableDeflater).size(); });
+					Measure(results, "decode_encrypted_first_key" + suffix, jsonSize, [&] { return DecodeBinFileContent(entry.EncryptedBin, namedKeys); });
+					Measure(results, "decode_encrypted_last_key" + suffix, jsonSize, [&] { return DecodeBinFileContent(entry.EncryptedBinUsingLastKey, namedKeys); });
+				}
+
+				if (libraryCodec != nullptr)
+				{
+					Measure(results, "library_encode_unencrypted" + suffix, jsonSize, [&] { return libraryEncode(entry.Json, TSDT_NO_KEY); });
+					Measure(results, "library_decode_unencrypted" + suffix, jsonSize, [&] { return libraryDecode(entry.CompressedBin); });
+
+					if (firstKey != nullptr)
+					{
+						Measure(results, "library_encode_encrypted" + suffix, jsonSize, [&] { return libraryEncode(entry.Json, 0); });
+						Measure(results, "library_decode_encrypted_first_key" + suffix, jsonSize, [&] { return libraryDecode(entry.EncryptedBin); });
+						Measure(results, "library_decode_encrypted_last_key" + suffix, jsonSize, [&] { return libraryDecode(entry.EncryptedBinUsingLastKey); });
+					}
+				}
+			}
+
+			if (lastKey != nullptr)
+			{
+				const CorpusEntry& smallestEntry = corpus.front();
+				PeepoHappy::Crypto::AesIVBytes iv = {};
+				memcpy(iv.data(), smallestEntry.EncryptedBinUsingLastKey.data(), iv.size());
+
+				const u8* contentWithoutIV = (smallestEntry.EncryptedBinUsingLastKey.data() + iv.size());
+				const size_t sizeWithoutIV = (smallestEntry.EncryptedBinUsingLastKey.size() - iv.size());
+
+				char name[64];
+				sprintf_s(name, "key_probe_all_%zu_keys", namedKeys.size());
+				Measure(results, name, 0, [&] { return TryOutAllAvailableEncrpytionKeysUntilGZipHeaderIsFound(contentWithoutIV, sizeWithoutIV, iv, namedKeys) != nullptr; });
+			}
+
+			// NOTE: Several copies of each size so that there is enough work to go around for larger thread counts
+			std::vector<const CorpusEntry*> batch;
+			for (size_t copy = 0; copy < 8; copy++)
+			{
+				for (const CorpusEntry& entry : corpus)
+					batch.push_back(&entry);
+			}
+
+			size_t batchJsonSize = 0;
+			for (const CorpusEntry* entry : batch)
+				batchJsonSize += entry->Json.size();
+
+			const u32 threadLimit = (maxThreadCount > 0) ? maxThreadCount : PeepoHappy::Threading::GetHardwareThreadCount();
+			std::vector<u32> threadCounts;
+			for (u32 threadCount = 1; threadCount < threadLimit; threadCount *= 2)
+				threadCounts.push_back(threadCount);
+			threadCounts.push_back(threadLimit);
+
+			for (const u32 threadCount : threadCounts)
+			{
+				char name[64];
+				sprintf_s(name, "batch_decode_%u_threads", threadCount);
+				Measure(results, name, batchJsonSize, [&]
+				{
+					PeepoHappy::Threading::ParallelForEachIndex(batch.size(), threadCount, [&](size_t index) { DecodeBinFileContent(batch[index]->EncryptedBin, namedKeys); });
+					return batch.size();
+				});
+			}
+
+			// NOTE: Unlike everything above these do touch the file system, comparing plain writes against making every file durable
+			//		 on its own (flush + rename per file) and making the entire batch durable using a single group commit
+			if (PeepoHappy::IO::CreateDirectoryRecursive(ScratchDirectoryPath))
+			{
+				std::vector<std::string> batchOutputFilePaths;
+				size_t batchBinSize = 0;
+				for (size_t i = 0; i < batch.size(); i++)
+				{
+					char fileName[32];
+					sprintf_s(fileName, "/%03zu.bin", i);
+					batchOutputFilePaths.push_back(std::string(ScratchDirectoryPath) + fileName);
+					batchBinSize += batch[i]->EncryptedBin.size();
+				}
+
+				Measure(results, "batch_write_unsynced", batchBinSize, [&]
+				{
+					size_t writtenCount = 0;
+					for (size_t i = 0; i < batch.size(); i++)
+						writtenCount += PeepoHappy::IO::WriteEntireFile(batchOutputFilePaths[i], batch[i]->EncryptedBin.data(), batch[i]->EncryptedBin.size());
+					return writtenCount;
+				});
+
+				Measure(results, "batch_write_flush_per_file", batchBinSize, [&]
+				{
+					size_t writtenCount = 0;
+					for (size_t i = 0; i < batch.size(); i++)
+					{
+						PeepoHappy::IO::GroupCommitWriter writer;
+						writtenCount += (writer.Stage(batchOutputFilePaths[i], batch[i]->EncryptedBin.data(), batch[i]->EncryptedBin.size()) && writer.Commit());
+					}
+					return writtenCount;
+				});
+
+				Measure(results, "batch_write_group_commit", batchBinSize, [&]
+				{
+					PeepoHappy::IO::GroupCommitWriter writer;
+					size_t stagedCount = 0;
+					for (size_t i = 0; i < batch.size(); i++)
+						stagedCount += writer.Stage(batchOutputFilePaths[i], batch[i]->EncryptedBin.data(), batch[i]->EncryptedBin.size());
+					return writer.Commit() ? stagedCount : 0;
+				});
+
+				for (const std::string& filePath : batchOutputFilePaths)
+					PeepoHappy::IO::RemoveFile(filePath);
+				PeepoHappy::IO::RemoveEmptyDirectory(ScratchDirectoryPath);
+			}
+			else
+			{
+				fprintf(stderr, "Failed to create scratch directory, skipping write benchmarks\n");
+			}
+
+			TSDT_DestroyCodec(libraryCodec);
+			TSDT_DestroyContext(libraryContext);
+
+			if (!resultsOutputFilePath.empty() && !WriteResults(resultsOutputFilePath, results))
+				fprintf(stderr, "Failed to write benchmark results\n");
+
+			if (baselineInputFilePath.empty())
+				return EXIT_WIDEPEEPOHAPPY;
+
+			const auto[baselineFileContent, baselineFileSize] = PeepoHappy::IO::ReadEntireFile(baselineInputFilePath);
+			if (baselineFileContent == nullptr)
+			{
+				fprintf(stderr, "Failed to read baseline file\n");
+				return EXIT_WIDEPEEPOSAD;
+			}
+
+			const auto baselineResults = ParseBaselineResults(std::string_view(reinterpret_cast<const char*>(baselineFileContent.get()), baselineFileSize));
+			size_t regressionCount = 0;
+
+			printf("\n");
+			printf("%-44s %14s %14s %9s\n", "Comparison against baseline", "baseline ns", "current ns", "change");
+			for (const BenchmarkResult& result : results)
+			{
+				const auto baseline = std::find_if(baselineResults.begin(), baselineResults.end(), [&](auto& b) { return b.Name == result.Name; });
+				if (baseline == baselineResults.end() || baseline->NanosecondsPerIteration <= 0.0)
+					continue;
+
+				const f64 relativeChange = (result.NanosecondsPerIteration / baseline->NanosecondsPerIteration) - 1.0;
+				const bool isRegression = (relativeChange > RegressionThreshold);
+				regressionCount += isRegression;
+
+				printf("%-44s %14.0f %14.0f %+8.1f%%%s\n", result.Name.c_str(), baseline->NanosecondsPerIteration, result.NanosecondsPerIteration, relativeChange * 100.0, isRegression ? " REGRESSION" : "");
+			}
+
+			printf("\n%zu regression(s) found\n", regressionCount);
+			return (regressionCount == 0) ? EXIT_WIDEPEEPOHAPPY : EXIT_WIDEPEEPOSAD;
+		}
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "Types.h"
+#include "DataTable.h"
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	namespace Benchmark
+	{
+		// NOTE: Roughly resembles the structure of "musicinfo.json" (an "items" array of flat song objects).
+		//		 Seeded deterministically so that results stay comparable between runs and machines
+		std::string GenerateSyntheticDataTableJson(size_t targetByteSize, u32 seed);
+
+		// NOTE: Results are written as JSON and can later be passed back in as a baseline, in which case every benchmark
+		//		 is compared against its previous result and a regression causes the run to fail.
+		//		 All .bin files are encoded using the given IV mode, with IVMode::Original falling back to IVMode::Content as there are no original files
+		int RunAllBenchmarks(const std::vector<NamedEncryptionKey>& namedKeys, IVMode ivMode, std::string_view resultsOutputFilePath, std::string_view baselineInputFilePath, u32 maxThreadCount);
+	}
+}
@@ -0,0 +1,297 @@
+#include "BuildManifest.h"
+#include <set>
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	namespace
+	{
+		constexpr std::string_view ManifestHeaderLine = "# TaikoSwitchDataTableDecryptor build manifest v1";
+		constexpr size_t ManifestFieldsPerLine = 10;
+
+		constexpr std::string_view JournalHeaderLine = "# TaikoSwitchDataTableDecryptor checkpoint journal v1";
+		constexpr size_t JournalFieldsPerLine = 6;
+
+		template <typename Func>
+		void ForEachLine(std::string_view text, Func perLineFunc)
+		{
+			while (!text.empty())
+			{
+				const size_t lineEnd = text.find('\n');
+				perLineFunc(PeepoHappy::ASCII::StripSuffix(text.substr(0, lineEnd), "\r"));
+
+				if (lineEnd == std::string_view::npos)
+					break;
+				text = text.substr(lineEnd + 1);
+			}
+		}
+
+		// NOTE: Returns the number of fields found, any beyond the output array size are ignored
+		template <size_t FieldCount>
+		size_t SplitTabSeparatedFields(std::string_view line, std::array<std::string_view, FieldCount>& outFields)
+		{
+			size_t fieldCount = 0;
+			while (fieldCount < outFields.size())
+			{
+				const size_t fieldEnd = line.find('\t');
+				outFields[fieldCount++] = line.substr(0, fieldEnd);
+
+				if (fieldEnd == std::string_view::npos)
+					break;
+				line = line.substr(fieldEnd + 1);
+			}
+			return fieldCount;
+		}
+
+		u64 ParseU64(std::string_view field)
+		{
+			u64 value = 0;
+			for (const char c : field)
+			{
+				if (c < '0' || c > '9')
+					return 0;
+				value = (value * 10) + static_cast<u64>(c - '0');
+			}
+			return value;
+		}
+
+		void AppendField(std::string& out, std::string_view field, char separator = '\t')
+		{
+			out += field;
+			out += separator;
+		}
+
+		void AppendField(std::string& out, u64 field, char separator = '\t')
+		{
+			char buffer[32];
+			sprintf_s(buffer, "%llu", static_cast<unsigned long long>(field));
+			AppendField(out, std::string_view(buffer), separator);
+		}
+	}
+
+	void BuildManifest::Load(std::string_view manifestFilePath)
+	{
+		const auto[fileContent, fileSize] = PeepoHappy::IO::ReadEntireFile(manifestFilePath);
+		if (fileContent == nullptr)
+			return;
+
+		const auto fileText = std::string_view(reinterpret_cast<const char*>(fileContent.get()), fileSize);
+
+		std::scoped_lock lock(mutex);
+		ForEachLine(fileText, [&](std::string_view line)
+		{
+			if (line.empty() || line[0] == '#')
+				return;
+
+			std::array<std::string_view, ManifestFieldsPerLine> fields = {};
+			if (SplitTabSeparatedFields(line, fields) != ManifestFieldsPerLine)
+				return;
+
+			BuildManifestEntry entry = {};
+			entry.InputFilePath = std::string(fields[0]);
+			entry.InputMetadata.Size = ParseU64(fields[1]);
+			entry.InputMetadata.LastWriteTime = ParseU64(fields[2]);
+			entry.InputDigest = PeepoHappy::Crypto::ParseSha256DigestHexString(fields[3]);
+			entry.KeyName = std::string(fields[4]);
+			entry.EncodingSettings = std::string(fields[5]);
+			entry.OutputFilePath = std::string(fields[6]);
+			entry.OutputMetadata.Size = ParseU64(fields[7]);
+			entry.OutputMetadata.LastWriteTime = ParseU64(fields[8]);
+			entry.OutputDigest = PeepoHappy::Crypto::ParseSha256DigestHexString(fields[9]);
+
+			std::string inputFilePath = entry.InputFilePath;
+			entries.insert_or_assign(std::move(inputFilePath), std::move(entry));
+		});
+	}
+
+	bool BuildManifest::Save(std::string_view manifestFilePath) const
+	{
+		std::string fileText;
+		fileText += ManifestHeaderLine;
+		fileText += '\n';
+		fileText += "# input_path\tinput_size\tinput_last_write_time\tinput_sha256\tkey_name\tencoding_settings\toutput_path\toutput_size\toutput_last_write_time\toutput_sha256\n";
+
+		{
+			std::scoped_lock lock(mutex);
+			for (const auto&[inputFilePath, entry] : entries)
+			{
+				AppendField(fileText, entry.InputFilePath);
+				AppendField(fileText, entry.InputMetadata.Size);
+				AppendField(fileText, entry.InputMetadata.LastWriteTime);
+				AppendField(fileText, PeepoHappy::Crypto::FormatSha256DigestHexString(entry.InputDigest));
+				AppendField(fileText, entry.KeyName);
+				AppendField(fileText, entry.EncodingSettings);
+				AppendField(fileText, entry.OutputFilePath);
+				AppendField(fileText, entry.OutputMetadata.Size);
+				AppendField(fileText, entry.OutputMetadata.LastWriteTime);
+				AppendField(fileText, PeepoHappy::Crypto::FormatSha256DigestHexString(entry.OutputDigest), '\n');
+			}
+		}
+
+		return PeepoHappy::IO::WriteEntireFile(manifestFilePath, reinterpret_cast<const u8*>(fileText.data()), fileText.size());
+	}
+
+	std::optional<BuildManifestEntry> BuildManifest::FindReusableEntry(std::string_view inputFilePath, std::string_view outputFilePath, std::string_view keyName, std::string_view encodingSettings) const
+	{
+		std::optional<BuildManifestEntry> entry;
+		{
+			std::scoped_lock lock(mutex);
+			if (const auto found = entries.find(inputFilePath); found != entries.end())
+				entry = found->second;
+		}
+
+		if (!entry.has_value())
+			return std::nullopt;
+
+		if (entry->KeyName != keyName || entry->EncodingSettings != encodingSettings || entry->OutputFilePath != outputFilePath)
+			return std::nullopt;
+
+		// NOTE: An output file that has been deleted or modified by anything else always has to be rewritten
+		if (entry->OutputMetadata.Size == 0 || PeepoHappy::IO::GetFileMetadata(outputFilePath) != entry->OutputMetadata)
+			return std::nullopt;
+
+		return entry;
+	}
+
+	void BuildManifest::Update(BuildManifestEntry entry)
+	{
+		std::scoped_lock lock(mutex);
+		std::string inputFilePath = entry.InputFilePath;
+		entries.insert_or_assign(std::move(inputFilePath), std::move(entry));
+	}
+
+	void BuildManifest::RefreshOutputMetadata(const std::vector<std::string>& outputFilePaths)
+	{
+		std::scoped_lock lock(mutex);
+		const std::set<std::string_view> refreshedOutputFilePaths(outputFilePaths.begin(), outputFilePaths.end());
+
+		for (auto& [inputFilePath, entry] : entries)
+		{
+			if (refreshedOutputFilePaths.count(entry.OutputFilePath) > 0)
+				entry.OutputMetadata = PeepoHappy::IO::GetFileMetadata(entry.OutputFilePath);
+		}
+	}
+
+	void BuildManifest::RemoveOutputEntries(const std::vector<std::string>& outputFilePaths)
+	{
+		std::scoped_lock lock(mutex);
+		const std::set<std::string_view> removedOutputFilePaths(outputFilePaths.begin(), outputFilePaths.end());
+
+		for (auto it = entries.begin(); it != entries.end();)
+		{
+			if (removedOutputFilePaths.count(it->second.OutputFilePath) > 0)
+				it = entries.erase(it);
+			else
+				it++;
+		}
+	}
+
+	void BuildManifest::RecordOutcome(BuildOutcome outcome)
+	{
+		outcomeCounts[static_cast<size_t>(outcome)]++;
+	}
+
+	size_t BuildManifest::GetOutcomeCount(BuildOutcome outcome) const
+	{
+		return outcomeCounts[static_cast<size_t>(outcome)];
+	}
+
+	bool CheckpointJournal::Open(std::string_view journalFilePath)
+	{
+		const auto[fileContent, fileSize] = PeepoHappy::IO::ReadEntireFile(journalFilePath);
+		auto fileText = (fileContent != nullptr) ? std::string_view(reinterpret_cast<const char*>(fileContent.get()), fileSize) : std::string_view();
+
+		// NOTE: A crash in the middle of appending leaves behind a torn last line, which is dropped (and its file simply converted again)
+		const bool endsWithTornLine = (!fileText.empty() && fileText.back() != '\n');
+		fileText = fileText.substr(0, fileText.find_last_of('\n') + 1);
+
+		std::scoped_lock lock(mutex);
+		ForEachLine(fileText, [&](std::string_view line)
+		{
+			if (line.empty() || line[0] == '#')
+				return;
+
+			std::array<std::string_view, JournalFieldsPerLine> fields = {};
+			if (SplitTabSeparatedFields(line, fields) != JournalFieldsPerLine)
+				return;
+
+			CheckpointJournalEntry entry = {};
+			entry.InputFilePath = std::string(fields[0]);
+			entry.InputMetadata.Size = ParseU64(fields[1]);
+			entry.InputMetadata.LastWriteTime = ParseU64(fields[2]);
+			entry.OutputFilePath = std::string(fields[3]);
+			entry.OutputSize = ParseU64(fields[4]);
+			entry.OutputDigest = PeepoHappy::Crypto::ParseSha256DigestHexString(fields[5]);
+
+			std::string inputFilePath = entry.InputFilePath;
+			entries.insert_or_assign(std::move(inputFilePath), std::move(entry));
+		});
+
+		stream = PeepoHappy::IO::OpenFileStream(journalFilePath, L"ab");
+		if (stream == nullptr)
+			return false;
+
+		std::string headerText;
+		if (endsWithTornLine)
+			headerText += '\n';
+		if (fileText.empty())
+		{
+			headerText += JournalHeaderLine;
+			headerText += '\n';
+			headerText += "# input_path\tinput_size\tinput_last_write_time\toutput_path\toutput_size\toutput_sha256\n";
+		}
+
+		this->journalFilePath = std::string(journalFilePath);
+		return headerText.empty() || (fwrite(headerText.data(), 1, headerText.size(), stream.get()) == headerText.size() && fflush(stream.get()) == 0);
+	}
+
+	bool CheckpointJournal::IsCompleted(std::string_view inputFilePath) const
+	{
+		std::optional<CheckpointJournalEntry> entry;
+		{
+			std::scoped_lock lock(mutex);
+			if (const auto found = entries.find(inputFilePath); found != entries.end())
+				entry = found->second;
+		}
+
+		if (!entry.has_value())
+			return false;
+
+		// NOTE: Neither file is hashed again, an input file that was modified or an output file that went missing is simply converted again
+		return (PeepoHappy::IO::GetFileMetadata(inputFilePath) == entry->InputMetadata && PeepoHappy::IO::GetFileSize(entry->OutputFilePath) == entry->OutputSize);
+	}
+
+	bool CheckpointJournal::Append(std::string_view inputFilePath, std::string_view outputFilePath, const PeepoHappy::Crypto::Sha256Digest& outputDigest, size_t outputSize)
+	{
+		CheckpointJournalEntry entry = {};
+		entry.InputFilePath = std::string(inputFilePath);
+		entry.InputMetadata = PeepoHappy::IO::GetFileMetadata(inputFilePath);
+		entry.OutputFilePath = std::string(outputFilePath);
+		entry.OutputSize = outputSize;
+		entry.OutputDigest = outputDigest;
+
+		std::string lineText;
+		AppendField(lineText, entry.InputFilePath);
+		AppendField(lineText, entry.InputMetadata.Size);
+		AppendField(lineText, entry.InputMetadata.LastWriteTime);
+		AppendField(lineText, entry.OutputFilePath);
+		AppendField(lineText, entry.OutputSize);
+		AppendField(lineText, PeepoHappy::Crypto::FormatSha256DigestHexString(entry.OutputDigest), '\n');
+
+		std::scoped_lock lock(mutex);
+		if (stream == nullptr)
+			return false;
+
+		// NOTE: Flushed right away so that every completed file survives the process crashing at any later point
+		const bool appended = (fwrite(lineText.data(), 1, lineText.size(), stream.get()) == lineText.size() && fflush(stream.get()) == 0);
+		entries.insert_or_assign(std::string(inputFilePath), std::move(entry));
+		return appended;
+	}
+
+	bool CheckpointJournal::Remove()
+	{
+		std::scoped_lock lock(mutex);
+		stream = nullptr;
+		entries.clear();
+		return PeepoHappy::IO::RemoveFile(journalFilePath);
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "Types.h"
+#include "Utilities.h"
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <optional>
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	// NOTE: The state of a single .json input file and its .bin output file at the time of the last conversion
+	struct BuildManifestEntry
+	{
+		std::string InputFilePath;
+		PeepoHappy::IO::FileMetadata InputMetadata;
+		PeepoHappy::Crypto::Sha256Digest InputDigest;
+		std::string KeyName;
+		std::string EncodingSettings;
+		std::string OutputFilePath;
+		PeepoHappy::IO::FileMetadata OutputMetadata;
+		PeepoHappy::Crypto::Sha256Digest OutputDigest;
+	};
+
+	enum class BuildOutcome : u8
+	{
+		// NOTE: Input file size and last write time unchanged, the input file was never even opened
+		SkippedInput,
+		// NOTE: Input file was read but its content turned out to be unchanged (touched or saved without any edits)
+		UnchangedInput,
+		// NOTE: Input file was converted but the output came out identical to the existing output file
+		UnchangedOutput,
+		WrittenOutput,
+		Count
+	};
+
+	// NOTE: Persisted as a tab separated text file with one entry per line, sorted by input file path.
+	//		 Internally synchronized so that it can be shared between all worker threads of a batch
+	class BuildManifest : NonCopyable
+	{
+	public:
+		// NOTE: A manifest file that doesn't exist yet is treated as empty, malformed lines are ignored (and will simply be rebuilt)
+		void Load(std::string_view manifestFilePath);
+		bool Save(std::string_view manifestFilePath) const;
+
+		// NOTE: Only returns entries whose key name and encoding settings match and whose output file hasn't changed since
+		std::optional<BuildManifestEntry> FindReusableEntry(std::string_view inputFilePath, std::string_view outputFilePath, std::string_view keyName, std::string_view encodingSettings) const;
+		void Update(BuildManifestEntry entry);
+		// NOTE: For output files that were only renamed into place after their entry had already been updated
+		void RefreshOutputMetadata(const std::vector<std::string>& outputFilePaths);
+		// NOTE: For output files whose entry had already been updated but that were never renamed into place after all,
+		//		 so that their input files are rebuilt by the next run instead of being skipped against a stale output file
+		void RemoveOutputEntries(const std::vector<std::string>& outputFilePaths);
+
+		void RecordOutcome(BuildOutcome outcome);
+		size_t GetOutcomeCount(BuildOutcome outcome) const;
+
+	private:
+		mutable std::mutex mutex;
+		std::map<std::string, BuildManifestEntry, std::less<>> entries;
+		std::array<std::atomic<size_t>, static_cast<size_t>(BuildOutcome::Count)> outcomeCounts = {};
+	};
+
+	// NOTE: A batch conversion that has finished converting the input file into the output file with the given size and SHA-256
+	struct CheckpointJournalEntry
+	{
+		std::string InputFilePath;
+		PeepoHappy::IO::FileMetadata InputMetadata;
+		std::string OutputFilePath;
+		u64 OutputSize;
+		PeepoHappy::Crypto::Sha256Digest OutputDigest;
+	};
+
+	// NOTE: Append-only counterpart to the build manifest that is written while a batch is still running, one line per converted file,
+	//		 so that an interrupted batch can be resumed by skipping every input file it had already finished.
+	//		 Internally synchronized so that it can be shared between all worker threads of a batch
+	class CheckpointJournal : NonCopyable
+	{
+	public:
+		// NOTE: Loads all entries left behind by an earlier interrupted run (if any) and opens the file for appending new ones
+		bool Open(std::string_view journalFilePath);
+
+		// NOTE: Only compares file metadata so that resuming doesn't require hashing any of the previously converted files
+		bool IsCompleted(std::string_view inputFilePath) const;
+		bool Append(std::string_view inputFilePath, std::string_view outputFilePath, const PeepoHappy::Crypto::Sha256Digest& outputDigest, size_t outputSize);
+
+		// NOTE: Once the whole batch has been converted successfully there is nothing left to resume
+		bool Remove();
+
+	private:
+		mutable std::mutex mutex;
+		std::map<std::string, CheckpointJournalEntry, std::less<>> entries;
+		PeepoHappy::IO::FileStream stream;
+		std::string journalFilePath;
+	};
+}
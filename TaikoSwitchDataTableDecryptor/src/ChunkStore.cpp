@@ -0,0 +1,270 @@
+#include "ChunkStore.h"
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	namespace
+	{
+		constexpr std::string_view VersionHeaderLine = "# TaikoSwitchDataTableDecryptor chunk store version v1";
+
+		// NOTE: Chunk boundaries are placed where the rolling hash of the preceding bytes matches the mask, giving an average chunk size of
+		//		 roughly min + 8KB. Only the top bits are tested since the low bits of a gear hash only depend on the last few bytes
+		constexpr size_t MinChunkSize = (2 * 1024);
+		constexpr size_t MaxChunkSize = (64 * 1024);
+		constexpr u64 ChunkBoundaryMask = (0x1FFFull << 51);
+
+		constexpr std::array<u64, 256> GenerateGearTable()
+		{
+			// NOTE: SplitMix64 so that the table (and with that every chunk boundary) is identical on every machine and build
+			std::array<u64, 256> table = {};
+			u64 state = 0x5441494B4F444154ull;
+			for (u64& entry : table)
+			{
+				u64 z = (state += 0x9E3779B97F4A7C15ull);
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+				entry = (z ^ (z >> 31));
+			}
+			return table;
+		}
+
+		constexpr std::array<u64, 256> GearTable = GenerateGearTable();
+
+		size_t FindNextChunkSize(const u8* data, size_t dataSize)
+		{
+			if (dataSize <= MinChunkSize)
+				return dataSize;
+
+			const size_t searchEnd = std::min(dataSize, MaxChunkSize);
+			u64 hash = 0;
+			for (size_t i = MinChunkSize; i < searchEnd; i++)
+			{
+				hash = (hash << 1) + GearTable[data[i]];
+				if ((hash & ChunkBoundaryMask) == 0)
+					return (i + 1);
+			}
+			return searchEnd;
+		}
+
+		std::string_view PopField(std::string_view& line, char separator)
+		{
+			const size_t fieldEnd = line.find(separator);
+			const std::string_view field = line.substr(0, fieldEnd);
+			line = (fieldEnd == std::string_view::npos) ? std::string_view() : line.substr(fieldEnd + 1);
+			return field;
+		}
+
+		bool ParseU64(std::string_view field, u64& outValue)
+		{
+			outValue = 0;
+			for (const char c : field)
+			{
+				if (c < '0' || c > '9')
+					return false;
+				outValue = (outValue * 10) + static_cast<u64>(c - '0');
+			}
+			return !field.empty();
+		}
+
+		// NOTE: Version names end up as file names so anything that could escape the versions directory is rejected
+		bool IsValidVersionName(std::string_view versionName)
+		{
+			return !versionName.empty() && versionName != "." && versionName != ".." && versionName.find_first_of("/\\:*?\"<>|\t\r\n") == std::string_view::npos;
+		}
+	}
+
+	ChunkStore::ChunkStore(std::string_view directoryPath) : directoryPath(directoryPath)
+	{
+	}
+
+	bool ChunkStore::AddTable(std::string_view tableName, const u8* content, size_t contentSize, ChunkStoreTable& outTable)
+	{
+		outTable.Name = std::string(tableName);
+		outTable.Size = contentSize;
+		outTable.Digest = PeepoHappy::Crypto::HashSha256(content, contentSize);
+		outTable.Chunks.clear();
+
+		// NOTE: Deflate can slightly expand incompressible data, the gzip header and trailer add a few bytes on top
+		const size_t compressedBufferSize = (MaxChunkSize + (MaxChunkSize / 8) + 64);
+		auto compressedBuffer = PeepoHappy::Memory::MakeTrackedBuffer(compressedBufferSize);
+
+		for (size_t offset = 0; offset < contentSize;)
+		{
+			const size_t chunkSize = FindNextChunkSize(content + offset, contentSize - offset);
+			const ChunkStoreChunk chunk = { PeepoHappy::Crypto::HashSha256(content + offset, chunkSize), static_cast<u32>(chunkSize) };
+			const std::string chunkFilePath = FormatChunkFilePath(chunk.Digest);
+
+			if (PeepoHappy::IO::GetFileSize(chunkFilePath) > 0)
+			{
+				reusedChunkCount++;
+				reusedChunkByteSize += chunkSize;
+			}
+			else
+			{
+				const size_t compressedSize = PeepoHappy::Compression::Deflate(content + offset, chunkSize, compressedBuffer.get(), compressedBufferSize);
+				if (compressedSize == 0)
+					return false;
+
+				if (!PeepoHappy::IO::CreateDirectoryRecursive(PeepoHappy::Path::GetDirectoryName(chunkFilePath)) || !PeepoHappy::IO::WriteEntireFileAtomically(chunkFilePath, compressedBuffer.get(), compressedSize))
+					return false;
+
+				storedChunkCount++;
+				storedChunkByteSize += chunkSize;
+				compressedChunkByteSize += compressedSize;
+			}
+
+			outTable.Chunks.push_back(chunk);
+			offset += chunkSize;
+		}
+
+		return true;
+	}
+
+	bool ChunkStore::SaveVersion(std::string_view versionName, const std::vector<ChunkStoreTable>& tables) const
+	{
+		if (!IsValidVersionName(versionName))
+			return false;
+
+		std::string fileText;
+		fileText += VersionHeaderLine;
+		fileText += '\n';
+		fileText += "# table_name\ttable_size\ttable_sha256\tchunk_sha256:chunk_size,...\n";
+
+		for (const ChunkStoreTable& table : tables)
+		{
+			char sizeBuffer[32];
+			sprintf_s(sizeBuffer, "%llu", static_cast<unsigned long long>(table.Size));
+
+			fileText += table.Name;
+			fileText += '\t';
+			fileText += sizeBuffer;
+			fileText += '\t';
+			fileText += PeepoHappy::Crypto::FormatSha256DigestHexString(table.Digest);
+			fileText += '\t';
+			for (size_t i = 0; i < table.Chunks.size(); i++)
+			{
+				sprintf_s(sizeBuffer, "%u", table.Chunks[i].Size);
+				if (i > 0)
+					fileText += ',';
+				fileText += PeepoHappy::Crypto::FormatSha256DigestHexString(table.Chunks[i].Digest);
+				fileText += ':';
+				fileText += sizeBuffer;
+			}
+			fileText += '\n';
+		}
+
+		const std::string versionFilePath = FormatVersionFilePath(versionName);
+		return PeepoHappy::IO::CreateDirectoryRecursive(PeepoHappy::Path::GetDirectoryName(versionFilePath)) &&
+			PeepoHappy::IO::WriteEntireFileAtomically(versionFilePath, reinterpret_cast<const u8*>(fileText.data()), fileText.size());
+	}
+
+	bool ChunkStore::LoadVersion(std::string_view versionName, std::vector<ChunkStoreTable>& outTables) const
+	{
+		outTables.clear();
+		if (!IsValidVersionName(versionName))
+			return false;
+
+		const auto[fileContent, fileSize] = PeepoHappy::IO::ReadEntireFile(FormatVersionFilePath(versionName));
+		if (fileContent == nullptr)
+			return false;
+
+		std::string_view fileText = std::string_view(reinterpret_cast<const char*>(fileContent.get()), fileSize);
+		while (!fileText.empty())
+		{
+			std::string_view line = PeepoHappy::ASCII::StripSuffix(PopField(fileText, '\n'), "\r");
+			if (line.empty() || line[0] == '#')
+				continue;
+
+			ChunkStoreTable table = {};
+			table.Name = std::string(PopField(line, '\t'));
+			if (table.Name.empty() || !ParseU64(PopField(line, '\t'), table.Size))
+				return false;
+			table.Digest = PeepoHappy::Crypto::ParseSha256DigestHexString(PopField(line, '\t'));
+
+			u64 chunksSize = 0;
+			while (!line.empty())
+			{
+				std::string_view chunkField = PopField(line, ',');
+				ChunkStoreChunk chunk = {};
+				u64 chunkSize = 0;
+				chunk.Digest = PeepoHappy::Crypto::ParseSha256DigestHexString(PopField(chunkField, ':'));
+				if (!ParseU64(chunkField, chunkSize) || chunkSize == 0 || chunkSize > MaxChunkSize)
+					return false;
+
+				chunk.Size = static_cast<u32>(chunkSize);
+				chunksSize += chunkSize;
+				table.Chunks.push_back(chunk);
+			}
+
+			if (chunksSize != table.Size)
+				return false;
+			outTables.push_back(std::move(table));
+		}
+
+		return true;
+	}
+
+	std::pair<PeepoHappy::Memory::TrackedBuffer, size_t> ChunkStore::ReconstructTable(const ChunkStoreTable& table) const
+	{
+		auto tableBuffer = PeepoHappy::Memory::MakeTrackedBuffer(std::max<size_t>(static_cast<size_t>(table.Size), 1));
+		size_t offset = 0;
+
+		for (const ChunkStoreChunk& chunk : table.Chunks)
+		{
+			const auto[compressedContent, compressedSize] = PeepoHappy::IO::ReadEntireFile(FormatChunkFilePath(chunk.Digest));
+			if (compressedContent == nullptr || (offset + chunk.Size) > table.Size)
+				return { nullptr, 0 };
+
+			const size_t chunkEnd = (offset + chunk.Size);
+			bool overflowed = false;
+			const bool inflated = PeepoHappy::Compression::InflateStreamed(compressedContent.get(), compressedSize, [&](const u8* data, size_t dataSize)
+			{
+				if (overflowed || dataSize > (chunkEnd - offset))
+				{
+					overflowed = true;
+					return;
+				}
+				memcpy(tableBuffer.get() + offset, data, dataSize);
+				offset += dataSize;
+			});
+
+			if (!inflated || overflowed || offset != chunkEnd)
+				return { nullptr, 0 };
+		}
+
+		if (offset != table.Size || PeepoHappy::Crypto::HashSha256(tableBuffer.get(), offset) != table.Digest)
+			return { nullptr, 0 };
+
+		return { std::move(tableBuffer), offset };
+	}
+
+	void ChunkStore::PrintSummary() const
+	{
+		printf("Chunk store: %zu new chunk(s) (%llu bytes, %llu compressed), %zu reused chunk(s) (%llu bytes)\n",
+			static_cast<size_t>(storedChunkCount), static_cast<unsigned long long>(storedChunkByteSize), static_cast<unsigned long long>(compressedChunkByteSize),
+			static_cast<size_t>(reusedChunkCount), static_cast<unsigned long long>(reusedChunkByteSize));
+	}
+
+	std::string ChunkStore::FormatChunkFilePath(const PeepoHappy::Crypto::Sha256Digest& digest) const
+	{
+		const std::string digestHexString = PeepoHappy::Crypto::FormatSha256DigestHexString(digest);
+
+		std::string chunkFilePath;
+		chunkFilePath.reserve(directoryPath.size() + digestHexString.size() + 16);
+		chunkFilePath += directoryPath;
+		chunkFilePath += "/chunks/";
+		chunkFilePath += std::string_view(digestHexString).substr(0, 2);
+		chunkFilePath += '/';
+		chunkFilePath += digestHexString;
+		chunkFilePath += ".gz";
+		return chunkFilePath;
+	}
+
+	std::string ChunkStore::FormatVersionFilePath(std::string_view versionName) const
+	{
+		std::string versionFilePath = directoryPath;
+		versionFilePath += "/versions/";
+		versionFilePath += versionName;
+		versionFilePath += ".txt";
+		return versionFilePath;
+	}
+}
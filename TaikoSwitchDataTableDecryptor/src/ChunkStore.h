@@ -0,0 +1,54 @@
+#pragma once
+#include "Types.h"
+#include "Utilities.h"
+#include <mutex>
+#include <atomic>
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	struct ChunkStoreChunk
+	{
+		PeepoHappy::Crypto::Sha256Digest Digest;
+		u32 Size;
+	};
+
+	// NOTE: A single decoded table of a stored version, reconstructed by concatenating all of its chunks
+	struct ChunkStoreTable
+	{
+		std::string Name;
+		u64 Size;
+		PeepoHappy::Crypto::Sha256Digest Digest;
+		std::vector<ChunkStoreChunk> Chunks;
+	};
+
+	// NOTE: Content addressed store of decoded JSON tables of any number of game versions. Every table is split into content defined chunks
+	//		 (so that an edit somewhere inside of a table only ever changes the chunks around it) and each chunk is stored exactly once,
+	//		 compressed as "{directory}/chunks/{first two hex digits}/{chunk hex digits}.gz", no matter how many tables and versions share it.
+	//		 Each version is a text file "{directory}/versions/{version}.txt" listing the chunks of all of its tables.
+	//		 Chunks are written atomically so that multiple versions can be added concurrently, even by different processes
+	class ChunkStore : NonCopyable
+	{
+	public:
+		explicit ChunkStore(std::string_view directoryPath);
+
+		// NOTE: Thread safe, only the chunks not already inside the store are compressed and written
+		bool AddTable(std::string_view tableName, const u8* content, size_t contentSize, ChunkStoreTable& outTable);
+		bool SaveVersion(std::string_view versionName, const std::vector<ChunkStoreTable>& tables) const;
+		bool LoadVersion(std::string_view versionName, std::vector<ChunkStoreTable>& outTables) const;
+
+		// NOTE: Returns null if any chunk is missing or corrupted or if the result doesn't match the SHA-256 of the table
+		std::pair<PeepoHappy::Memory::TrackedBuffer, size_t> ReconstructTable(const ChunkStoreTable& table) const;
+
+		void PrintSummary() const;
+
+	private:
+		std::string FormatChunkFilePath(const PeepoHappy::Crypto::Sha256Digest& digest) const;
+		std::string FormatVersionFilePath(std::string_view versionName) const;
+
+	private:
+		std::string directoryPath;
+
+		std::atomic<size_t> storedChunkCount = 0, reusedChunkCount = 0;
+		std::atomic<u64> storedChunkByteSize = 0, compressedChunkByteSize = 0, reusedChunkByteSize = 0;
+	};
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "Types.h"
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	// NOTE: Spoken over the local named pipe served by the 'serve' command. Every request and response consists of a fixed size header
+	//		 followed by a UTF-8 text field and a binary payload of the sizes specified in the header (in that order, without any padding).
+	//		 Any number of requests can be sent one after another over the same connection with each one being answered by exactly one response
+	namespace DaemonProtocol
+	{
+		constexpr std::string_view DefaultPipeName = "TaikoSwitchDataTableDecryptor";
+
+		constexpr u32 RequestMagic = 0x51544454;	// NOTE: "TDTQ"
+		constexpr u32 ResponseMagic = 0x52544454;	// NOTE: "TDTR"
+		constexpr u32 Version = 1;
+
+		constexpr u32 MaxTextSize = 0x1000;
+		constexpr u32 MaxPayloadSize = 0x400000;
+
+		enum class Operation : u32
+		{
+			// NOTE: Text: Absolute path of a .bin or .json input file, converted on disk the same way as by the default command
+			ConvertFile,
+			// NOTE: Text: Key name (empty for unencrypted output), Payload: JSON -> Response Payload: .bin file content
+			EncodeBuffer,
+			// NOTE: Payload: .bin file content -> Response Text: Detected key name (empty if unencrypted), Response Payload: JSON
+			DecodeBuffer,
+			// NOTE: Stops the server once all other in-flight requests have been answered
+			Shutdown,
+		};
+
+		enum class Status : u32
+		{
+			Success,
+			// NOTE: Response Text: Error message
+			Failure,
+		};
+
+#pragma pack(push, 1)
+		struct RequestHeader
+		{
+			u32 Magic;
+			u32 Version;
+			Operation RequestOperation;
+			// NOTE: Index into IVModeNames, only used by ConvertFile (for .json input files) and EncodeBuffer
+			u32 EncryptionIVMode;
+			u32 TextSize;
+			u32 PayloadSize;
+		};
+
+		struct ResponseHeader
+		{
+			u32 Magic;
+			Status ResponseStatus;
+			u32 TextSize;
+			u32 PayloadSize;
+		};
+#pragma pack(pop)
+
+		static_assert(sizeof(RequestHeader) == 24);
+		static_assert(sizeof(ResponseHeader) == 16);
+	}
+}
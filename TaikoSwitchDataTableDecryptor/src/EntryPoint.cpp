@@ -1,201 +1,2245 @@
 #include "Types.h"
 #include "Utilities.h"
+#include "DataTable.h"
+#include "Statistics.h"
+#include "Benchmark.h"
+#include "BuildManifest.h"
+#include "OutputCache.h"
+#include "DaemonProtocol.h"
+#include "TarArchive.h"
+#include "RomFS.h"
+#include "ShardClaims.h"
+#include "ChunkStore.h"
+#include "TableDiff.h"
+#include <chrono>
+#include <future>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <map>
+#include <deque>
+#include <thread>
 
 namespace TaikoSwitchDataTableDecryptor
 {
-	// NOTE: Sucks for modders, makes sense for them to do it though...
-	constexpr size_t MaxDecompressedGameDataTableFileSize = 0x200000;
+	// NOTE: Same as DecodeBinFileContent() but reports why decoding failed (as well as input files that aren't encrypted)
+	DecodedJsonFile DecryptAndDecompressBinFileContent(const u8* binFileContent, size_t binFileSize, const std::vector<NamedEncryptionKey>& namedKeys)
+	{
+		DecodedJsonFile result = DecodeBinFileContent(binFileContent, binFileSize, namedKeys);
+		if (result.Status != DataTableStatus::Success)
+			fprintf(stderr, "%s\n", GetDataTableStatusMessage(result.Status));
+		else if (result.Key == nullptr)
+			fprintf(stderr, "Input file not encrypted. This should still work fine but likely means the file comes from either an earlier version or different game\n");
+		return result;
+	}
+
+	int ReadAndWriteEncryptedAndOrCompressedBinToJsonFile(std::string_view binInputFilePath, const std::vector<NamedEncryptionKey>& namedKeys, CheckpointJournal* journal = nullptr)
+	{
+		const auto[binFileContent, binFileSize] = Statistics::TimeStage(Statistics::Stage::Read, PeepoHappy::IO::ReadEntireFile, binInputFilePath);
+		if (auto* stats = Statistics::ThisThreadFileStatistics; stats != nullptr)
+			stats->BytesIn = binFileSize;
+
+		if (binFileContent == nullptr)
+		{
+			fprintf(stderr, "Failed to read input file\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		const DecodedJsonFile jsonFile = DecryptAndDecompressBinFileContent(binFileContent.get(), binFileSize, namedKeys);
+		if (jsonFile.Json.empty())
+			return EXIT_WIDEPEEPOSAD;
+
+		const std::string jsonOutputFilePath = FormatJsonOutputFilePathUsingNamedKey(binInputFilePath, jsonFile.Key);
+		if (!Statistics::TimeStage(Statistics::Stage::Write, PeepoHappy::IO::WriteEntireFile, jsonOutputFilePath, reinterpret_cast<const u8*>(jsonFile.Json.data()), jsonFile.Json.size()))
+		{
+			fprintf(stderr, "Failed to write JSON output file\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		if (journal != nullptr)
+			journal->Append(binInputFilePath, jsonOutputFilePath, PeepoHappy::Crypto::HashSha256(reinterpret_cast<const u8*>(jsonFile.Json.data()), jsonFile.Json.size()), jsonFile.Json.size());
+
+		return EXIT_WIDEPEEPOHAPPY;
+	}
+
+	// NOTE: Everything needed to check a freshly written .bin file against its JSON source without reading either back from disk
+	struct PendingRoundTripVerification
+	{
+		std::string BinOutputFilePath;
+		PeepoHappy::Memory::TrackedBuffer OwningBinFileBuffer;
+		const u8* BinFileContent;
+		size_t BinFileSize;
+		const NamedEncryptionKey* Key;
+		size_t JsonFileSize;
+		PeepoHappy::Crypto::Sha256Digest JsonFileDigest;
+		// NOTE: Output files awaiting verification are only appended to the journal once they have passed it
+		CheckpointJournal* Journal;
+		std::string JsonInputFilePath;
+		PeepoHappy::Crypto::Sha256Digest BinFileDigest;
+	};
+
+	bool VerifyRoundTrip(const PendingRoundTripVerification& pending)
+	{
+		Statistics::ScopedStageTimer verifyTimer(Statistics::Stage::Verify);
+
+		const u8* compressedData = pending.BinFileContent;
+		size_t compressedDataSize = pending.BinFileSize;
+		PeepoHappy::Memory::TrackedBuffer decryptedBuffer = nullptr;
+
+		if (pending.Key != nullptr)
+		{
+			PeepoHappy::Crypto::AesIVBytes iv = {};
+			memcpy(iv.data(), pending.BinFileContent, iv.size());
+
+			compressedDataSize = (pending.BinFileSize - iv.size());
+			decryptedBuffer = PeepoHappy::Memory::MakeTrackedBuffer(compressedDataSize);
+
+			if (!DecryptUsingNamedKey(*pending.Key, pending.BinFileContent + iv.size(), decryptedBuffer.get(), compressedDataSize, iv))
+			{
+				fprintf(stderr, "Round-trip verification of '%s' failed: Unable to decrypt output\n", pending.BinOutputFilePath.c_str());
+				return false;
+			}
+			compressedData = decryptedBuffer.get();
+		}
+
+		PeepoHappy::Crypto::Sha256Hasher hasher;
+		size_t decompressedSize = 0;
+
+		if (!PeepoHappy::Compression::InflateStreamed(compressedData, compressedDataSize, [&hasher](const u8* chunk, size_t chunkSize) { hasher.Update(chunk, chunkSize); }, &decompressedSize))
+		{
+			fprintf(stderr, "Round-trip verification of '%s' failed: Unable to decompress output\n", pending.BinOutputFilePath.c_str());
+			return false;
+		}
+
+		if (decompressedSize != pending.JsonFileSize || hasher.Finish() != pending.JsonFileDigest)
+		{
+			fprintf(stderr, "Round-trip verification of '%s' failed: Decoded output does not match JSON input\n", pending.BinOutputFilePath.c_str());
+			return false;
+		}
+
+		if (pending.Journal != nullptr)
+			pending.Journal->Append(pending.JsonInputFilePath, pending.BinOutputFilePath, pending.BinFileDigest, pending.BinFileSize);
+
+		return true;
+	}
+
+	// NOTE: Same as EncodeJsonFileContent() but takes the original IV from the existing output file and reports why encoding failed
+	EncodedBinFile CompressAndEncryptJsonFileContent(const u8* jsonFileContent, size_t jsonFileSize, const NamedEncryptionKey* key, IVMode ivMode, std::string_view binOutputFilePath, PeepoHappy::Compression::Deflater* reusableDeflater)
+	{
+		PeepoHappy::Crypto::AesIVBytes originalIV = {};
+		const bool originalIVFound = (key != nullptr && ivMode == IVMode::Original) && ReadEncryptionIVFromBinFile(binOutputFilePath, originalIV);
+
+		if (key != nullptr && ivMode == IVMode::Original && !originalIVFound)
+			printf("No existing encrypted output file found to take the IV from. Falling back to a content derived IV\n");
+
+		EncodedBinFile result = EncodeJsonFileContent(jsonFileContent, jsonFileSize, key, ivMode, originalIVFound ? &originalIV : nullptr, reusableDeflater);
+		if (result.Status != DataTableStatus::Success)
+			fprintf(stderr, "Failed to encode JSON file (%s)\n", GetDataTableStatusMessage(result.Status));
+		return result;
+	}
+
+	// NOTE: Settings and (internally synchronized) state shared by all .json -> .bin conversions of a batch
+	struct JsonToBinConversionOptions
+	{
+		IVMode EncryptionIVMode = IVMode::Constant;
+		BuildManifest* Manifest = nullptr;
+		OutputCache* Cache = nullptr;
+		PeepoHappy::IO::GroupCommitWriter* Writer = nullptr;
+		CheckpointJournal* Journal = nullptr;
+	};
+
+	// NOTE: When outPendingVerification is provided the output buffer is handed over to it instead of being freed
+	//		 so that the caller can decide when (and on which thread) to verify the round-trip.
+	//		 When a manifest is provided unchanged input files are skipped and unchanged output files aren't rewritten.
+	//		 When a cache is provided it is consulted before compressing and encrypting anything.
+	//		 When a writer is provided the output file is only staged and has to be committed by the caller.
+	//		 When a journal is provided every output file that has been written (or was already up to date) is appended to it
+	int ReadAndWriteJsonToCompressedAndOrEncryptedBinFile(std::string_view jsonInputFilePath, const std::vector<NamedEncryptionKey>& namedKeys, const JsonToBinConversionOptions& conversionOptions, PendingRoundTripVerification* outPendingVerification = nullptr, PeepoHappy::Compression::Deflater* reusableDeflater = nullptr)
+	{
+		BuildManifest* const manifest = conversionOptions.Manifest;
+		const auto[binOutputFilePath, keyUsedForInitialDecrpytion] = ParseJsonInputFilePathUsingNamedKeysAndFormatBinOutputFilePath(jsonInputFilePath, namedKeys);
+		const std::string_view keyName = (keyUsedForInitialDecrpytion != nullptr) ? keyUsedForInitialDecrpytion->Name : std::string_view();
+
+		// NOTE: Outputs using the original IV depend on the previously written output file rather than just the input file
+		OutputCache* const cache = (keyUsedForInitialDecrpytion == nullptr || conversionOptions.EncryptionIVMode != IVMode::Original) ? conversionOptions.Cache : nullptr;
+		const std::string encodingSettings = (manifest != nullptr || cache != nullptr) ? FormatEncodingSettings(conversionOptions.EncryptionIVMode) : std::string();
+
+		std::optional<BuildManifestEntry> previousEntry;
+		PeepoHappy::IO::FileMetadata jsonFileMetadata = {};
+		if (manifest != nullptr)
+		{
+			jsonFileMetadata = PeepoHappy::IO::GetFileMetadata(jsonInputFilePath);
+			previousEntry = manifest->FindReusableEntry(jsonInputFilePath, binOutputFilePath, keyName, encodingSettings);
+
+			if (previousEntry.has_value() && previousEntry->InputMetadata == jsonFileMetadata)
+			{
+				manifest->RecordOutcome(BuildOutcome::SkippedInput);
+				return EXIT_WIDEPEEPOHAPPY;
+			}
+		}
+
+		const auto[jsonFileContent, jsonFileSize] = Statistics::TimeStage(Statistics::Stage::Read, PeepoHappy::IO::ReadEntireFile, jsonInputFilePath);
+		if (auto* stats = Statistics::ThisThreadFileStatistics; stats != nullptr)
+			stats->BytesIn = stats->DecompressedBytes = jsonFileSize;
+
+		if (jsonFileContent == nullptr)
+		{
+			fprintf(stderr, "Failed to read input file\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+		else if ((jsonFileSize + PeepoHappy::Crypto::AesIVSize) >= MaxDecompressedGameDataTableFileSize)
+		{
+			fprintf(stderr, "Input file too large. DataTable files are limited to %zu bytes\n", MaxDecompressedGameDataTableFileSize);
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		const bool jsonFileDigestNeeded = (manifest != nullptr || cache != nullptr || outPendingVerification != nullptr);
+		const PeepoHappy::Crypto::Sha256Digest jsonFileDigest = jsonFileDigestNeeded ? PeepoHappy::Crypto::HashSha256(jsonFileContent.get(), jsonFileSize) : PeepoHappy::Crypto::Sha256Digest {};
+		if (previousEntry.has_value() && previousEntry->InputDigest == jsonFileDigest)
+		{
+			previousEntry->InputMetadata = jsonFileMetadata;
+			manifest->Update(std::move(*previousEntry));
+			manifest->RecordOutcome(BuildOutcome::UnchangedInput);
+			return EXIT_WIDEPEEPOHAPPY;
+		}
+
+		if (keyUsedForInitialDecrpytion == nullptr)
+			printf("No known encrpytion key signature found in input file name. Output file will not be encrpyted\n");
+
+		EncodedBinFile binFile = {};
+		const PeepoHappy::Crypto::Sha256Digest cacheKey = (cache != nullptr) ? OutputCache::ComputeKey(jsonFileDigest, keyName, encodingSettings) : PeepoHappy::Crypto::Sha256Digest {};
+		if (cache != nullptr)
+		{
+			// NOTE: Without anything else needing the output content in memory (or its digest) the cached entry can be copied directly
+			if (manifest == nullptr && outPendingVerification == nullptr && conversionOptions.Writer == nullptr && conversionOptions.Journal == nullptr)
+			{
+				u64 copiedFileSize = 0;
+				if (Statistics::TimeStage(Statistics::Stage::Write, [&]() { return cache->TryCopyTo(cacheKey, binOutputFilePath, copiedFileSize); }))
+				{
+					if (auto* stats = Statistics::ThisThreadFileStatistics; stats != nullptr)
+						stats->BytesOut = copiedFileSize;
+					return EXIT_WIDEPEEPOHAPPY;
+				}
+			}
+			else if (auto[cachedFileContent, cachedFileSize] = Statistics::TimeStage(Statistics::Stage::Read, [&]() { return cache->TryRead(cacheKey); }); cachedFileContent != nullptr)
+			{
+				binFile.Content = cachedFileContent.get();
+				binFile.Size = cachedFileSize;
+				binFile.OwningBuffer = std::move(cachedFileContent);
+			}
+		}
+
+		if (binFile.Content == nullptr)
+		{
+			binFile = CompressAndEncryptJsonFileContent(jsonFileContent.get(), jsonFileSize, keyUsedForInitialDecrpytion, conversionOptions.EncryptionIVMode, binOutputFilePath, reusableDeflater);
+			if (binFile.Content == nullptr)
+				return EXIT_WIDEPEEPOSAD;
+
+			if (cache != nullptr)
+				cache->Store(cacheKey, binFile.Content, binFile.Size);
+		}
+
+		const u8* binFileContent = binFile.Content;
+		const size_t binFileSize = binFile.Size;
+
+		if (auto* stats = Statistics::ThisThreadFileStatistics; stats != nullptr)
+			stats->BytesOut = binFileSize;
+
+		const PeepoHappy::Crypto::Sha256Digest binFileDigest = (manifest != nullptr || conversionOptions.Journal != nullptr) ? PeepoHappy::Crypto::HashSha256(binFileContent, binFileSize) : PeepoHappy::Crypto::Sha256Digest {};
+		if (previousEntry.has_value() && previousEntry->OutputDigest == binFileDigest)
+		{
+			manifest->RecordOutcome(BuildOutcome::UnchangedOutput);
+		}
+		else
+		{
+			const bool outputWritten = (conversionOptions.Writer != nullptr) ?
+				Statistics::TimeStage(Statistics::Stage::Write, [&]() { return conversionOptions.Writer->Stage(binOutputFilePath, binFileContent, binFileSize); }) :
+				Statistics::TimeStage(Statistics::Stage::Write, PeepoHappy::IO::WriteEntireFile, binOutputFilePath, binFileContent, binFileSize);
+
+			if (!outputWritten)
+			{
+				fprintf(stderr, "Failed to write %s output file\n", (keyUsedForInitialDecrpytion != nullptr) ? "encrypted" : "compressed");
+				return EXIT_WIDEPEEPOSAD;
+			}
+
+			if (manifest != nullptr)
+				manifest->RecordOutcome(BuildOutcome::WrittenOutput);
+		}
+
+		if (conversionOptions.Journal != nullptr && outPendingVerification == nullptr)
+			conversionOptions.Journal->Append(jsonInputFilePath, binOutputFilePath, binFileDigest, binFileSize);
+
+		if (manifest != nullptr)
+		{
+			BuildManifestEntry entry = {};
+			entry.InputFilePath = std::string(jsonInputFilePath);
+			entry.InputMetadata = jsonFileMetadata;
+			entry.InputDigest = jsonFileDigest;
+			entry.KeyName = std::string(keyName);
+			entry.EncodingSettings = encodingSettings;
+			entry.OutputFilePath = binOutputFilePath;
+			entry.OutputMetadata = PeepoHappy::IO::GetFileMetadata(binOutputFilePath);
+			entry.OutputDigest = binFileDigest;
+			manifest->Update(std::move(entry));
+		}
+
+		if (outPendingVerification != nullptr)
+		{
+			outPendingVerification->BinOutputFilePath = binOutputFilePath;
+			outPendingVerification->BinFileContent = binFileContent;
+			outPendingVerification->BinFileSize = binFileSize;
+			outPendingVerification->OwningBinFileBuffer = std::move(binFile.OwningBuffer);
+			outPendingVerification->Key = keyUsedForInitialDecrpytion;
+			outPendingVerification->JsonFileSize = jsonFileSize;
+			outPendingVerification->JsonFileDigest = jsonFileDigest;
+			outPendingVerification->Journal = conversionOptions.Journal;
+			outPendingVerification->JsonInputFilePath = std::string(jsonInputFilePath);
+			outPendingVerification->BinFileDigest = binFileDigest;
+		}
+
+		return EXIT_WIDEPEEPOHAPPY;
+	}
+
+	enum class Command
+	{
+		Convert,
+		Verify,
+		Benchmark,
+		Watch,
+		Serve,
+		Client,
+		Decode,
+		Encode,
+		Tar,
+		RomFS,
+		LayeredFS,
+		Store,
+		Extract,
+		Diff,
+	};
+
+	enum class IOBackend : u8
+	{
+		// NOTE: Each worker thread reads its input file and writes its output file itself using ReadEntireFile() / WriteEntireFile()
+		Blocking,
+		// NOTE: A single thread keeps many reads and writes in flight through an AsyncFileQueue while the worker threads only compute
+		Overlapped,
+		// NOTE: The same as overlapped except that the reads and writes are performed by a few dedicated I/O threads using blocking I/O
+		Threaded,
+		Count
+	};
+
+	constexpr std::array<const char*, static_cast<size_t>(IOBackend::Count)> IOBackendNames =
+	{
+		"blocking",
+		"overlapped",
+		"threaded",
+	};
+
+	constexpr u32 DefaultIOQueueDepth = 16;
+	constexpr u32 DefaultIOThreadCount = 2;
+	constexpr u32 DefaultShardSize = 64;
+	constexpr u32 DefaultShardClaimTimeoutSeconds = 60;
+	constexpr u32 ShardPollIntervalMilliseconds = 1000;
+	constexpr u64 DefaultOutputCacheMaxByteSize = (1024ull * 1024 * 1024);
+	constexpr u32 DefaultWatchDebounceMilliseconds = 25;
+
+	struct CommandLineOptions
+	{
+		u32 ThreadCount = 0;
+		u64 MemoryBudget = 0;
+		bool VerifyAfterWrite = false;
+		bool DurableWrites = false;
+		bool Deduplicate = false;
+		std::string_view StatsOutputFilePath;
+		std::string_view TraceOutputFilePath;
+		std::string_view BaselineFilePath;
+		std::string_view ManifestFilePath;
+		std::string_view JournalFilePath;
+		std::string_view ShardDirectoryPath;
+		u32 ShardSize = DefaultShardSize;
+		u32 ShardClaimTimeoutSeconds = DefaultShardClaimTimeoutSeconds;
+		std::string_view CacheDirectoryPath;
+		u64 CacheMaxByteSize = DefaultOutputCacheMaxByteSize;
+		u32 WatchDebounceMilliseconds = DefaultWatchDebounceMilliseconds;
+		std::string_view PipeName = DaemonProtocol::DefaultPipeName;
+		bool ShutdownServer = false;
+		std::string_view KeyName;
+		std::string_view OutputPath;
+		std::string_view OriginalDirectoryPath;
+		std::string_view StoreDirectoryPath;
+		std::string_view VersionName;
+		IVMode EncryptionIVMode = IVMode::Constant;
+		IOBackend IO = IOBackend::Blocking;
+		u32 IOQueueDepth = DefaultIOQueueDepth;
+		u32 IOThreadCount = DefaultIOThreadCount;
+		std::vector<std::string_view> InputPaths;
+	};
+
+	CommandLineOptions ParseCommandLineOptions(int argc, const char** argv)
+	{
+		CommandLineOptions options = {};
+		for (int i = 0; i < argc; i++)
+		{
+			const std::string_view argument = std::string_view(argv[i]);
+			if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--verify"))
+				options.VerifyAfterWrite = true;
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--durable"))
+				options.DurableWrites = true;
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--dedup"))
+				options.Deduplicate = true;
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--stats") && (i + 1) < argc)
+				options.StatsOutputFilePath = std::string_view(argv[++i]);
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--trace") && (i + 1) < argc)
+				options.TraceOutputFilePath = std::string_view(argv[++i]);
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--baseline") && (i + 1) < argc)
+				options.BaselineFilePath = std::string_view(argv[++i]);
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--manifest") && (i + 1) < argc)
+				options.ManifestFilePath = std::string_view(argv[++i]);
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--journal") && (i + 1) < argc)
+				options.JournalFilePath = std::string_view(argv[++i]);
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--shards") && (i + 1) < argc)
+				options.ShardDirectoryPath = std::string_view(argv[++i]);
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--shard-size") && (i + 1) < argc)
+				options.ShardSize = static_cast<u32>(std::max(1, atoi(argv[++i])));
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--claim-timeout") && (i + 1) < argc)
+				options.ShardClaimTimeoutSeconds = static_cast<u32>(std::max(1, atoi(argv[++i])));
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--cache") && (i + 1) < argc)
+				options.CacheDirectoryPath = std::string_view(argv[++i]);
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--cache-size") && (i + 1) < argc)
+				options.CacheMaxByteSize = static_cast<u64>(std::max(0, atoi(argv[++i]))) * 1024 * 1024;
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--iv") && (i + 1) < argc)
+			{
+				const std::string_view ivModeName = std::string_view(argv[++i]);
+				if (const IVMode ivMode = ParseIVMode(ivModeName); ivMode != IVMode::Count)
+					options.EncryptionIVMode = ivMode;
+				else
+					fprintf(stderr, "Ignoring unknown IV mode '%.*s'\n", static_cast<int>(ivModeName.size()), ivModeName.data());
+			}
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--io") && (i + 1) < argc)
+			{
+				const std::string_view backendName = std::string_view(argv[++i]);
+				const auto foundBackend = std::find_if(IOBackendNames.begin(), IOBackendNames.end(), [&](const char* name) { return PeepoHappy::ASCII::MatchesInsensitive(backendName, name); });
+				if (foundBackend != IOBackendNames.end())
+					options.IO = static_cast<IOBackend>(std::distance(IOBackendNames.begin(), foundBackend));
+				else
+					fprintf(stderr, "Ignoring unknown I/O backend '%.*s'\n", static_cast<int>(backendName.size()), backendName.data());
+			}
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--queue-depth") && (i + 1) < argc)
+				options.IOQueueDepth = static_cast<u32>(std::max(1, atoi(argv[++i])));
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--io-threads") && (i + 1) < argc)
+				options.IOThreadCount = static_cast<u32>(std::max(1, atoi(argv[++i])));
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--key") && (i + 1) < argc)
+				options.KeyName = std::string_view(argv[++i]);
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--output") && (i + 1) < argc)
+				options.OutputPath = std::string_view(argv[++i]);
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--store") && (i + 1) < argc)
+				options.StoreDirectoryPath = std::string_view(argv[++i]);
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--name") && (i + 1) < argc)
+				options.VersionName = std::string_view(argv[++i]);
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--original") && (i + 1) < argc)
+				options.OriginalDirectoryPath = std::string_view(argv[++i]);
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--pipe") && (i + 1) < argc)
+				options.PipeName = std::string_view(argv[++i]);
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--shutdown"))
+				options.ShutdownServer = true;
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--debounce") && (i + 1) < argc)
+				options.WatchDebounceMilliseconds = static_cast<u32>(std::max(0, atoi(argv[++i])));
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--threads") && (i + 1) < argc)
+				options.ThreadCount = static_cast<u32>(std::max(0, atoi(argv[++i])));
+			else if (PeepoHappy::ASCII::MatchesInsensitive(argument, "--memory-budget") && (i + 1) < argc)
+				options.MemoryBudget = static_cast<u64>(std::max(0, atoi(argv[++i]))) * 1024 * 1024;
+			else if (PeepoHappy::ASCII::StartsWith(argument, "--"))
+				fprintf(stderr, "Ignoring unknown option '%.*s'\n", static_cast<int>(argument.size()), argument.data());
+			else
+				options.InputPaths.push_back(argument);
+		}
+		return options;
+	}
+
+	// NOTE: Rough upper bound of the memory needed to process a single file, mirroring the buffers allocated along the way
+	//		 plus some headroom for the zlib stream state (which for deflate is ~256KB using the default settings)
+	u64 EstimatePeakMemoryUsage(std::string_view inputFilePath)
+	{
+		constexpr u64 zlibStreamStateHeadroom = 0x60000;
+		const u64 fileSize = PeepoHappy::IO::GetFileSize(inputFilePath);
+
+		if (PeepoHappy::Path::HasFileExtension(inputFilePath, ".json"))
+			return fileSize + (MaxDecompressedGameDataTableFileSize * 2) + zlibStreamStateHeadroom;
+		else
+			return (fileSize * 2) + MaxDecompressedGameDataTableFileSize + zlibStreamStateHeadroom;
+	}
+
+	int ConvertInputFile(std::string_view inputFilePath, const std::vector<NamedEncryptionKey>& namedKeys, const JsonToBinConversionOptions& conversionOptions, PendingRoundTripVerification* outPendingVerification, PeepoHappy::Compression::Deflater* reusableDeflater = nullptr)
+	{
+		if (PeepoHappy::Path::HasFileExtension(inputFilePath, ".bin"))
+			return ReadAndWriteEncryptedAndOrCompressedBinToJsonFile(inputFilePath, namedKeys, conversionOptions.Journal);
+
+		if (PeepoHappy::Path::HasFileExtension(inputFilePath, ".json"))
+			return ReadAndWriteJsonToCompressedAndOrEncryptedBinFile(inputFilePath, namedKeys, conversionOptions, outPendingVerification, reusableDeflater);
+
+		fprintf(stderr, "Unexpected file extension\n");
+		return EXIT_WIDEPEEPOSAD;
+	}
+
+	int ConvertAllInputFilesInParallel(const CommandLineOptions& options, const std::vector<NamedEncryptionKey>& namedKeys, const JsonToBinConversionOptions& conversionOptions)
+	{
+		std::vector<u64> estimatedMemoryUsages;
+		estimatedMemoryUsages.reserve(options.InputPaths.size());
+		for (const std::string_view inputFilePath : options.InputPaths)
+			estimatedMemoryUsages.push_back(EstimatePeakMemoryUsage(inputFilePath));
+
+		std::atomic<size_t> failedCount = 0;
+		PeepoHappy::Threading::BudgetedParallelForEachIndex(estimatedMemoryUsages, options.ThreadCount, options.MemoryBudget, [&](size_t index)
+		{
+			Statistics::ScopedFileStatistics scopedFileStatistics(Statistics::BeginFile(options.InputPaths[index]));
+
+			PendingRoundTripVerification pending = {};
+			int fileExitCode = ConvertInputFile(options.InputPaths[index], namedKeys, conversionOptions, options.VerifyAfterWrite ? &pending : nullptr);
+
+			if (fileExitCode == EXIT_WIDEPEEPOHAPPY && options.VerifyAfterWrite && pending.BinFileContent != nullptr && !VerifyRoundTrip(pending))
+				fileExitCode = EXIT_WIDEPEEPOSAD;
+
+			if (fileExitCode != EXIT_WIDEPEEPOHAPPY)
+				failedCount++;
+		});
+
+		return (failedCount == 0) ? EXIT_WIDEPEEPOHAPPY : EXIT_WIDEPEEPOSAD;
+	}
+
+	int ConvertAllInputFilesSequentially(const CommandLineOptions& options, const std::vector<NamedEncryptionKey>& namedKeys, const JsonToBinConversionOptions& conversionOptions)
+	{
+		int exitCode = EXIT_WIDEPEEPOHAPPY;
+		std::future<bool> previousVerification;
+
+		auto waitForPreviousVerification = [&]()
+		{
+			if (previousVerification.valid() && !previousVerification.get())
+				exitCode = EXIT_WIDEPEEPOSAD;
+		};
+
+		for (const std::string_view inputFilePath : options.InputPaths)
+		{
+			Statistics::FileStatistics* fileStatistics = Statistics::BeginFile(inputFilePath);
+			auto pending = std::make_unique<PendingRoundTripVerification>();
+
+			int fileExitCode = EXIT_WIDEPEEPOSAD;
+			{
+				Statistics::ScopedFileStatistics scopedFileStatistics(fileStatistics);
+				fileExitCode = ConvertInputFile(inputFilePath, namedKeys, conversionOptions, options.VerifyAfterWrite ? pending.get() : nullptr);
+			}
+
+			// NOTE: Only started once this thread has stopped recording into the file statistics so that the verification thread is the only one writing to them
+			if (fileExitCode == EXIT_WIDEPEEPOHAPPY && options.VerifyAfterWrite && pending->BinFileContent != nullptr)
+			{
+				waitForPreviousVerification();
+				previousVerification = std::async(std::launch::async, [pending = std::move(pending), fileStatistics]() mutable
+				{
+					Statistics::ScopedFileStatistics scopedFileStatistics(fileStatistics);
+					const bool verified = VerifyRoundTrip(*pending);
+
+					// NOTE: The future keeps this lambda alive until the next file is being verified,
+					//		 so the buffers are released right away to have them attributed to this file instead
+					pending = nullptr;
+					return verified;
+				});
+			}
+
+			if (fileExitCode != EXIT_WIDEPEEPOHAPPY)
+				exitCode = EXIT_WIDEPEEPOSAD;
+		}
+
+		waitForPreviousVerification();
+		return exitCode;
+	}
+
+	struct ConvertedFileContent
+	{
+		std::string OutputFilePath;
+		PeepoHappy::Memory::TrackedBuffer OwningBuffer;
+		const u8* Content;
+		size_t Size;
+		PeepoHappy::Crypto::Sha256Digest Digest;
+		const NamedEncryptionKey* Key;
+	};
+
+	// NOTE: The in-memory part of ConvertInputFile() for input files that have already been read, the content is null on failure
+	ConvertedFileContent ConvertInputFileContent(std::string_view inputFilePath, const u8* inputFileContent, size_t inputFileSize, const std::vector<NamedEncryptionKey>& namedKeys, IVMode ivMode)
+	{
+		ConvertedFileContent result = {};
+		if (auto* stats = Statistics::ThisThreadFileStatistics; stats != nullptr)
+			stats->BytesIn = inputFileSize;
+
+		if (PeepoHappy::Path::HasFileExtension(inputFilePath, ".bin"))
+		{
+			DecodedJsonFile jsonFile = DecryptAndDecompressBinFileContent(inputFileContent, inputFileSize, namedKeys);
+			if (jsonFile.Json.empty())
+				return result;
+
+			result.OutputFilePath = FormatJsonOutputFilePathUsingNamedKey(inputFilePath, jsonFile.Key);
+			result.Key = jsonFile.Key;
+			result.Content = reinterpret_cast<const u8*>(jsonFile.Json.data());
+			result.Size = jsonFile.Json.size();
+			result.OwningBuffer = std::move(jsonFile.OwningBuffer);
+			return result;
+		}
+
+		if (PeepoHappy::Path::HasFileExtension(inputFilePath, ".json"))
+		{
+			if (auto* stats = Statistics::ThisThreadFileStatistics; stats != nullptr)
+				stats->DecompressedBytes = inputFileSize;
+
+			if ((inputFileSize + PeepoHappy::Crypto::AesIVSize) >= MaxDecompressedGameDataTableFileSize)
+			{
+				fprintf(stderr, "Input file too large. DataTable files are limited to %zu bytes\n", MaxDecompressedGameDataTableFileSize);
+				return result;
+			}
+
+			const auto[binOutputFilePath, keyUsedForInitialDecrpytion] = ParseJsonInputFilePathUsingNamedKeysAndFormatBinOutputFilePath(inputFilePath, namedKeys);
+			if (keyUsedForInitialDecrpytion == nullptr)
+				printf("No known encrpytion key signature found in input file name. Output file will not be encrpyted\n");
+
+			EncodedBinFile binFile = CompressAndEncryptJsonFileContent(inputFileContent, inputFileSize, keyUsedForInitialDecrpytion, ivMode, binOutputFilePath, nullptr);
+			if (binFile.Content == nullptr)
+				return result;
+
+			if (auto* stats = Statistics::ThisThreadFileStatistics; stats != nullptr)
+				stats->BytesOut = binFile.Size;
+
+			result.OutputFilePath = binOutputFilePath;
+			result.Key = keyUsedForInitialDecrpytion;
+			result.Content = binFile.Content;
+			result.Size = binFile.Size;
+			result.OwningBuffer = std::move(binFile.OwningBuffer);
+			return result;
+		}
+
+		fprintf(stderr, "Unexpected file extension\n");
+		return result;
+	}
+
+	// NOTE: The calling thread does nothing but drive the I/O of the entire batch through the queue, keeping up to queue depth input files
+	//		 being read ahead at once and writing each output file as soon as it is ready, while all decoding and encoding happens on the worker threads.
+	//		 Workers hand their results back by posting a notification to the queue so that only ever a single thread has to wait on it.
+	//		 Even with a single worker thread reading and writing other files therefore overlaps with compressing and encrypting the current one
+	int ConvertAllInputFilesUsingAsyncIO(const CommandLineOptions& options, const std::vector<NamedEncryptionKey>& namedKeys, CheckpointJournal* journal, PeepoHappy::IO::AsyncFileQueue& queue)
+	{
+		const size_t fileCount = options.InputPaths.size();
+		std::vector<ConvertedFileContent> convertedFiles(fileCount);
+		std::vector<u32> inputBufferIndices(fileCount, PeepoHappy::IO::AsyncFileQueue::InvalidBufferIndex);
+
+		size_t failedCount = 0, finishedCount = 0, nextInputIndex = 0;
+		auto finishFile = [&](size_t index, bool success)
+		{
+			if (!success)
+				failedCount++;
+			convertedFiles[index] = {};
+			finishedCount++;
+		};
+
+		// NOTE: Declared last so that the workers are joined before anything they reference goes away
+		PeepoHappy::Threading::ThreadPool workers((options.ThreadCount > 0) ? options.ThreadCount : PeepoHappy::Threading::GetHardwareThreadCount());
+
+		while (finishedCount < fileCount)
+		{
+			while (nextInputIndex < fileCount && queue.HasFreeBuffer())
+			{
+				const size_t index = nextInputIndex++;
+				if (!queue.SubmitRead(options.InputPaths[index], index))
+				{
+					fprintf(stderr, "Failed to read input file '%.*s'\n", static_cast<int>(options.InputPaths[index].size()), options.InputPaths[index].data());
+					finishFile(index, false);
+				}
+			}
+
+			if (finishedCount >= fileCount)
+				break;
+
+			const PeepoHappy::IO::AsyncFileCompletion completion = queue.WaitForCompletion();
+			if (completion.Operation == PeepoHappy::IO::AsyncFileOperation::Posted && !completion.Success)
+			{
+				fprintf(stderr, "Failed to wait for I/O completion\n");
+				return EXIT_WIDEPEEPOSAD;
+			}
+
+			const size_t index = static_cast<size_t>(completion.Tag);
+
+			switch (completion.Operation)
+			{
+			case PeepoHappy::IO::AsyncFileOperation::Read:
+			{
+				if (!completion.Success)
+				{
+					fprintf(stderr, "Failed to read input file '%.*s'\n", static_cast<int>(options.InputPaths[index].size()), options.InputPaths[index].data());
+					finishFile(index, false);
+					break;
+				}
+
+				inputBufferIndices[index] = completion.BufferIndex;
+				workers.Submit([&, index, inputFileContent = completion.Data, inputFileSize = completion.Size]()
+				{
+					Statistics::ScopedFileStatistics scopedFileStatistics(Statistics::BeginFile(options.InputPaths[index]));
+					ConvertedFileContent convertedFile = ConvertInputFileContent(options.InputPaths[index], inputFileContent, inputFileSize, namedKeys, options.EncryptionIVMode);
+					if (journal != nullptr && convertedFile.Content != nullptr)
+						convertedFile.Digest = PeepoHappy::Crypto::HashSha256(convertedFile.Content, convertedFile.Size);
+
+					convertedFiles[index] = std::move(convertedFile);
+					queue.Post(index);
+				});
+				break;
+			}
+			case PeepoHappy::IO::AsyncFileOperation::Posted:
+			{
+				queue.ReleaseBuffer(inputBufferIndices[index]);
+				inputBufferIndices[index] = PeepoHappy::IO::AsyncFileQueue::InvalidBufferIndex;
+
+				const ConvertedFileContent& convertedFile = convertedFiles[index];
+				if (convertedFile.Content == nullptr)
+				{
+					finishFile(index, false);
+				}
+				else if (!queue.SubmitWrite(convertedFile.OutputFilePath, convertedFile.Content, convertedFile.Size, index))
+				{
+					fprintf(stderr, "Failed to write output file '%s'\n", convertedFile.OutputFilePath.c_str());
+					finishFile(index, false);
+				}
+				break;
+			}
+			case PeepoHappy::IO::AsyncFileOperation::Write:
+			{
+				const ConvertedFileContent& convertedFile = convertedFiles[index];
+				if (!completion.Success)
+					fprintf(stderr, "Failed to write output file '%s'\n", convertedFile.OutputFilePath.c_str());
+				else if (journal != nullptr)
+					journal->Append(options.InputPaths[index], convertedFile.OutputFilePath, convertedFile.Digest, convertedFile.Size);
+				finishFile(index, completion.Success);
+				break;
+			}
+			}
+		}
+
+		return (failedCount == 0) ? EXIT_WIDEPEEPOHAPPY : EXIT_WIDEPEEPOSAD;
+	}
+
+	// NOTE: The output of the first input file with a given deduplication key, shared with all other input files with the same key
+	struct DeduplicatedOutput
+	{
+		bool Success;
+		std::string OutputFilePath;
+		const NamedEncryptionKey* Key;
+		size_t Size;
+		PeepoHappy::Crypto::Sha256Digest Digest;
+	};
+
+	// NOTE: Everything that determines the content of the output file: the input content itself, the conversion direction
+	//		 and for .json input files the key named by the file name (the IV being either constant or derived from the content)
+	std::string FormatDeduplicationKey(std::string_view inputFilePath, const u8* inputFileContent, size_t inputFileSize, const std::vector<NamedEncryptionKey>& namedKeys)
+	{
+		std::string key = PeepoHappy::Crypto::FormatSha256DigestHexString(PeepoHappy::Crypto::HashSha256(inputFileContent, inputFileSize));
+		key += '\t';
+		key += PeepoHappy::Path::GetFileExtension(inputFilePath);
+
+		if (PeepoHappy::Path::HasFileExtension(inputFilePath, ".json"))
+		{
+			const NamedEncryptionKey* namedKey = ParseJsonInputFilePathUsingNamedKeysAndFormatBinOutputFilePath(inputFilePath, namedKeys).second;
+			key += '\t';
+			key += (namedKey != nullptr) ? namedKey->Name : std::string_view();
+		}
+		return key;
+	}
+
+	// NOTE: Each input file is hashed right after being read. Only the first one of every set of identical input files is actually decoded (or encoded)
+	//		 while all others wait for its output file, which is then copied to their own output paths by the OS.
+	//		 Never hard linked since most write paths rewrite existing output files in place, so rebuilding a single one of them later on
+	//		 would otherwise silently change all of its duplicates as well (which might belong to entirely different game versions)
+	int ConvertAllInputFilesDeduplicated(const CommandLineOptions& options, const std::vector<NamedEncryptionKey>& namedKeys, CheckpointJournal* journal)
+	{
+		std::vector<u64> estimatedMemoryUsages;
+		estimatedMemoryUsages.reserve(options.InputPaths.size());
+		for (const std::string_view inputFilePath : options.InputPaths)
+			estimatedMemoryUsages.push_back(EstimatePeakMemoryUsage(inputFilePath));
+
+		std::mutex outputsMutex;
+		std::map<std::string, std::shared_future<DeduplicatedOutput>, std::less<>> outputs;
+
+		std::atomic<size_t> failedCount = 0, duplicateCount = 0;
+		std::atomic<u64> duplicateByteSize = 0;
+
+		// NOTE: Files only ever wait on outputs of files that are already being converted, which can therefore never end up waiting on each other
+		PeepoHappy::Threading::BudgetedParallelForEachIndex(estimatedMemoryUsages, (options.ThreadCount > 0) ? options.ThreadCount : 1, options.MemoryBudget, [&](size_t index)
+		{
+			const std::string_view inputFilePath = options.InputPaths[index];
+			Statistics::ScopedFileStatistics scopedFileStatistics(Statistics::BeginFile(inputFilePath));
+
+			auto[inputFileContent, inputFileSize] = Statistics::TimeStage(Statistics::Stage::Read, PeepoHappy::IO::ReadEntireFile, inputFilePath);
+			if (inputFileContent == nullptr)
+			{
+				fprintf(stderr, "Failed to read input file '%.*s'\n", static_cast<int>(inputFilePath.size()), inputFilePath.data());
+				failedCount++;
+				return;
+			}
+
+			std::promise<DeduplicatedOutput> ownedOutput;
+			std::shared_future<DeduplicatedOutput> sharedOutput;
+			bool isOwner = false;
+			{
+				std::string deduplicationKey = FormatDeduplicationKey(inputFilePath, inputFileContent.get(), inputFileSize, namedKeys);
+				std::scoped_lock lock(outputsMutex);
+				auto& output = outputs[std::move(deduplicationKey)];
+				if (!output.valid())
+				{
+					output = ownedOutput.get_future().share();
+					isOwner = true;
+				}
+				sharedOutput = output;
+			}
+
+			if (isOwner)
+			{
+				const ConvertedFileContent convertedFile = ConvertInputFileContent(inputFilePath, inputFileContent.get(), inputFileSize, namedKeys, options.EncryptionIVMode);
+				inputFileContent = nullptr;
+
+				DeduplicatedOutput output = { false, convertedFile.OutputFilePath, convertedFile.Key, convertedFile.Size, {} };
+				if (convertedFile.Content != nullptr)
+				{
+					output.Success = Statistics::TimeStage(Statistics::Stage::Write, PeepoHappy::IO::WriteEntireFile, convertedFile.OutputFilePath, convertedFile.Content, convertedFile.Size);
+					if (!output.Success)
+						fprintf(stderr, "Failed to write output file '%s'\n", convertedFile.OutputFilePath.c_str());
+					else if (journal != nullptr)
+						output.Digest = PeepoHappy::Crypto::HashSha256(convertedFile.Content, convertedFile.Size);
+				}
+
+				if (output.Success && journal != nullptr)
+					journal->Append(inputFilePath, output.OutputFilePath, output.Digest, output.Size);
+				if (!output.Success)
+					failedCount++;
+
+				ownedOutput.set_value(std::move(output));
+				return;
+			}
+
+			inputFileContent = nullptr;
+			duplicateCount++;
+			duplicateByteSize += inputFileSize;
+
+			const DeduplicatedOutput& output = sharedOutput.get();
+			if (!output.Success)
+			{
+				fprintf(stderr, "Skipping '%.*s' as its identical input file failed to convert\n", static_cast<int>(inputFilePath.size()), inputFilePath.data());
+				failedCount++;
+				return;
+			}
+
+			const std::string outputFilePath = PeepoHappy::Path::HasFileExtension(inputFilePath, ".bin") ?
+				FormatJsonOutputFilePathUsingNamedKey(inputFilePath, output.Key) :
+				ParseJsonInputFilePathUsingNamedKeysAndFormatBinOutputFilePath(inputFilePath, namedKeys).first;
+
+			// NOTE: The same input file specified more than once
+			if (outputFilePath == output.OutputFilePath)
+				return;
+
+			// NOTE: Removed first in case it is still a hard link left behind by an older build, which copying over would write through
+			const bool outputWritten = Statistics::TimeStage(Statistics::Stage::Write, [&]()
+			{
+				PeepoHappy::IO::RemoveFile(outputFilePath);
+				return PeepoHappy::IO::DuplicateFile(output.OutputFilePath, outputFilePath);
+			});
+
+			if (!outputWritten)
+			{
+				fprintf(stderr, "Failed to write output file '%s'\n", outputFilePath.c_str());
+				failedCount++;
+			}
+			else if (journal != nullptr)
+			{
+				journal->Append(inputFilePath, outputFilePath, output.Digest, output.Size);
+			}
+		});
+
+		printf("%zu of %zu input file(s) were duplicates, skipped converting %.2f MB\n",
+			duplicateCount.load(), options.InputPaths.size(), static_cast<double>(duplicateByteSize) / (1024.0 * 1024.0));
+
+		return (failedCount == 0) ? EXIT_WIDEPEEPOHAPPY : EXIT_WIDEPEEPOSAD;
+	}
+
+	// NOTE: By default input files are converted one after another with the round-trip verification of each written .bin file
+	//		 running on a separate thread while the next input file is already being compressed.
+	//		 With more than one thread files are instead spread across workers (admitted based on the memory budget)
+	//		 with each worker verifying its own output directly.
+	//		 With a manifest only .json input files that changed since the last run are converted again
+	int ConvertAllInputFiles(const CommandLineOptions& options, const std::vector<NamedEncryptionKey>& namedKeys)
+	{
+		if (options.InputPaths.empty())
+		{
+			fprintf(stderr, "No input files specified\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		std::unique_ptr<BuildManifest> manifest = nullptr;
+		if (!options.ManifestFilePath.empty())
+		{
+			manifest = std::make_unique<BuildManifest>();
+			manifest->Load(options.ManifestFilePath);
+		}
+
+		JsonToBinConversionOptions conversionOptions = {};
+		conversionOptions.EncryptionIVMode = options.EncryptionIVMode;
+		conversionOptions.Manifest = manifest.get();
+
+		std::unique_ptr<OutputCache> cache = nullptr;
+		if (!options.CacheDirectoryPath.empty())
+		{
+			cache = std::make_unique<OutputCache>(options.CacheDirectoryPath, options.CacheMaxByteSize);
+			conversionOptions.Cache = cache.get();
+		}
+
+		std::unique_ptr<PeepoHappy::IO::GroupCommitWriter> writer = nullptr;
+		if (options.DurableWrites)
+		{
+			writer = std::make_unique<PeepoHappy::IO::GroupCommitWriter>();
+			conversionOptions.Writer = writer.get();
+		}
+
+		// NOTE: Only the input files not yet completed by an earlier interrupted run of the same batch are passed on
+		CommandLineOptions batchOptions = options;
+		std::unique_ptr<CheckpointJournal> journal = nullptr;
+		if (!options.JournalFilePath.empty())
+		{
+			// NOTE: Durable output files only appear once the whole batch has been committed, so an interrupted batch never has anything to resume
+			if (writer != nullptr)
+			{
+				fprintf(stderr, "Ignoring '--journal' when combined with '--durable'\n");
+			}
+			else
+			{
+				journal = std::make_unique<CheckpointJournal>();
+				if (!journal->Open(options.JournalFilePath))
+				{
+					fprintf(stderr, "Failed to open checkpoint journal\n");
+					return EXIT_WIDEPEEPOSAD;
+				}
+
+				batchOptions.InputPaths.clear();
+				for (const std::string_view inputFilePath : options.InputPaths)
+				{
+					if (!journal->IsCompleted(inputFilePath))
+						batchOptions.InputPaths.push_back(inputFilePath);
+				}
+
+				if (const size_t completedCount = (options.InputPaths.size() - batchOptions.InputPaths.size()); completedCount > 0)
+					printf("Resuming batch, skipping %zu already converted file(s)\n", completedCount);
+				conversionOptions.Journal = journal.get();
+			}
+		}
+
+		bool convertedUsingAsyncIO = false, convertedDeduplicated = false;
+		int exitCode = EXIT_WIDEPEEPOHAPPY;
+		if (options.Deduplicate)
+		{
+			// NOTE: Outputs of duplicates are only ever copied from the first file, anything that depends on more than the input content can't be deduplicated
+			if (manifest != nullptr || cache != nullptr || writer != nullptr || options.VerifyAfterWrite || options.EncryptionIVMode == IVMode::Original)
+			{
+				fprintf(stderr, "Deduplication doesn't support '--manifest', '--cache', '--durable', '--verify' or '--iv original'. Converting every input file separately\n");
+			}
+			else
+			{
+				exitCode = ConvertAllInputFilesDeduplicated(batchOptions, namedKeys, journal.get());
+				convertedDeduplicated = true;
+			}
+		}
+
+		if (!convertedDeduplicated && (options.IO == IOBackend::Overlapped || options.IO == IOBackend::Threaded))
+		{
+			// NOTE: Everything beyond plain conversions needs more than the content of the input file, so those simply keep using blocking I/O
+			if (manifest != nullptr || cache != nullptr || writer != nullptr || options.VerifyAfterWrite || options.EncryptionIVMode == IVMode::Original)
+			{
+				fprintf(stderr, "Pipelined I/O doesn't support '--manifest', '--cache', '--durable', '--verify' or '--iv original'. Falling back to blocking I/O\n");
+			}
+			else if (PeepoHappy::IO::AsyncFileQueue queue(options.IOQueueDepth, MaxDecompressedGameDataTableFileSize, (options.IO == IOBackend::Threaded) ? options.IOThreadCount : 0); queue.IsValid())
+			{
+				exitCode = ConvertAllInputFilesUsingAsyncIO(batchOptions, namedKeys, journal.get(), queue);
+				convertedUsingAsyncIO = true;
+			}
+			else
+			{
+				fprintf(stderr, "Failed to create I/O completion port. Falling back to blocking I/O\n");
+			}
+		}
+
+		if (!convertedUsingAsyncIO && !convertedDeduplicated)
+		{
+			exitCode = (options.ThreadCount > 1) ?
+				ConvertAllInputFilesInParallel(batchOptions, namedKeys, conversionOptions) :
+				ConvertAllInputFilesSequentially(batchOptions, namedKeys, conversionOptions);
+		}
+
+		if (writer != nullptr)
+		{
+			// NOTE: Even if some files failed, all others are still committed the same way they would have been written without '--durable'
+			if (!writer->Commit())
+			{
+				fprintf(stderr, "Failed to commit output files\n");
+				exitCode = EXIT_WIDEPEEPOSAD;
+			}
+
+			if (manifest != nullptr)
+			{
+				manifest->RefreshOutputMetadata(writer->GetCommittedFilePaths());
+				manifest->RemoveOutputEntries(writer->GetDiscardedFilePaths());
+			}
+		}
+
+		if (manifest != nullptr)
+		{
+			printf("%zu file(s) skipped, %zu unchanged, %zu rebuilt with identical output, %zu written\n",
+				manifest->GetOutcomeCount(BuildOutcome::SkippedInput),
+				manifest->GetOutcomeCount(BuildOutcome::UnchangedInput),
+				manifest->GetOutcomeCount(BuildOutcome::UnchangedOutput),
+				manifest->GetOutcomeCount(BuildOutcome::WrittenOutput));
+
+			if (!manifest->Save(options.ManifestFilePath))
+				fprintf(stderr, "Failed to write build manifest\n");
+		}
+
+		if (cache != nullptr)
+		{
+			cache->EvictLeastRecentlyUsed();
+			cache->PrintSummary();
+		}
+
+		// NOTE: Kept around after any failure so that rerunning the same batch only retries the files that failed
+		if (journal != nullptr && exitCode == EXIT_WIDEPEEPOHAPPY && !journal->Remove())
+			fprintf(stderr, "Failed to remove checkpoint journal\n");
+
+		return exitCode;
+	}
+
+	// NOTE: Every worker process started using the same input files and shard directory walks the same list of shards, converting each one
+	//		 it manages to claim as a regular batch, until every shard has been finished by one of them. Shards claimed by other workers are
+	//		 checked again in regular intervals so that the claims of crashed workers are taken over once they have become stale
+	int ConvertAllInputFilesUsingSharedShards(const CommandLineOptions& options, const std::vector<NamedEncryptionKey>& namedKeys)
+	{
+		if (options.InputPaths.empty())
+		{
+			fprintf(stderr, "No input files specified\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		// NOTE: Both are a single file rewritten by whichever batch runs, so every worker converting its own shards would keep overwriting
+		//		 (or for the journal, removing) the entries of all others
+		if (!options.ManifestFilePath.empty() || !options.JournalFilePath.empty())
+		{
+			fprintf(stderr, "'--shards' can't be combined with '--manifest' or '--journal'\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		ShardClaimDirectory claims(options.ShardDirectoryPath, options.ShardClaimTimeoutSeconds);
+		if (!claims.IsValid())
+		{
+			fprintf(stderr, "Failed to create shard directory\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		struct Shard
+		{
+			std::string Name;
+			size_t FirstInputIndex;
+			size_t InputCount;
+			bool Finished;
+		};
+
+		std::vector<Shard> shards;
+		for (size_t firstInputIndex = 0; firstInputIndex < options.InputPaths.size(); firstInputIndex += options.ShardSize)
+		{
+			const size_t inputCount = std::min<size_t>(options.ShardSize, options.InputPaths.size() - firstInputIndex);
+
+			// NOTE: Named after the input files it contains so that workers accidentally started using different input files never mix up their shards
+			constexpr u8 separator = '\0';
+			PeepoHappy::Crypto::Sha256Hasher hasher;
+			for (size_t i = firstInputIndex; i < (firstInputIndex + inputCount); i++)
+			{
+				hasher.Update(reinterpret_cast<const u8*>(options.InputPaths[i].data()), options.InputPaths[i].size());
+				hasher.Update(&separator, sizeof(separator));
+			}
+
+			char shardName[64];
+			sprintf_s(shardName, "shard_%04zu_%.16s", shards.size(), PeepoHappy::Crypto::FormatSha256DigestHexString(hasher.Finish()).c_str());
+			shards.push_back(Shard { shardName, firstInputIndex, inputCount, false });
+		}
+
+		CommandLineOptions shardOptions = options;
+		shardOptions.ShardDirectoryPath = {};
+
+		size_t remainingCount = shards.size(), convertedCount = 0, failedCount = 0;
+		while (remainingCount > 0)
+		{
+			for (Shard& shard : shards)
+			{
+				if (shard.Finished)
+					continue;
+
+				const ShardClaimResult claimResult = claims.TryClaim(shard.Name);
+				if (claimResult == ShardClaimResult::ClaimedByOther)
+					continue;
+
+				if (claimResult == ShardClaimResult::TakenOver)
+					printf("Taking over stale claim of %s\n", shard.Name.c_str());
+
+				if (claimResult != ShardClaimResult::Done)
+				{
+					shardOptions.InputPaths.assign(options.InputPaths.begin() + shard.FirstInputIndex, options.InputPaths.begin() + shard.FirstInputIndex + shard.InputCount);
+					const int shardExitCode = ConvertAllInputFiles(shardOptions, namedKeys);
+
+					// NOTE: Failed shards are still marked as done so that other workers don't keep retrying them, the summary records the failure instead
+					char summary[64];
+					sprintf_s(summary, "files=%zu\t%s", shard.InputCount, (shardExitCode == EXIT_WIDEPEEPOHAPPY) ? "succeeded" : "failed");
+					if (!claims.Finish(shard.Name, summary))
+						fprintf(stderr, "Failed to mark %s as done\n", shard.Name.c_str());
+
+					if (shardExitCode != EXIT_WIDEPEEPOHAPPY)
+						failedCount++;
+					convertedCount++;
+				}
+
+				shard.Finished = true;
+				remainingCount--;
+			}
+
+			if (remainingCount > 0)
+				std::this_thread::sleep_for(std::chrono::milliseconds(ShardPollIntervalMilliseconds));
+		}
+
+		printf("%zu of %zu shard(s) converted by this worker\n", convertedCount, shards.size());
+		return (failedCount == 0) ? EXIT_WIDEPEEPOHAPPY : EXIT_WIDEPEEPOSAD;
+	}
+
+	// NOTE: Waits for '.json' files inside the input directory to be written and converts only those once they haven't been written to
+	//		 for the debounce duration (editors tend to save in multiple steps). The keys are parsed and the zlib stream state is allocated
+	//		 only once upfront so that each rebuild only costs reading, compressing, encrypting and writing a single file
+	int WatchDirectoryAndConvertChangedJsonFiles(const CommandLineOptions& options, const std::vector<NamedEncryptionKey>& namedKeys)
+	{
+		if (options.InputPaths.size() != 1 || !PeepoHappy::IO::DirectoryExists(options.InputPaths.front()))
+		{
+			fprintf(stderr, "Expected a single input directory to watch\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		const std::string_view watchedDirectoryPath = options.InputPaths.front();
+		PeepoHappy::IO::DirectoryWatcher watcher(watchedDirectoryPath);
+		if (!watcher.IsValid())
+		{
+			fprintf(stderr, "Failed to watch input directory\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		std::unique_ptr<OutputCache> cache = nullptr;
+		JsonToBinConversionOptions conversionOptions = {};
+		conversionOptions.EncryptionIVMode = options.EncryptionIVMode;
+		if (!options.CacheDirectoryPath.empty())
+		{
+			cache = std::make_unique<OutputCache>(options.CacheDirectoryPath, options.CacheMaxByteSize);
+			conversionOptions.Cache = cache.get();
+		}
+
+		PeepoHappy::Compression::Deflater reusableDeflater;
+		const auto debounceDuration = std::chrono::milliseconds(options.WatchDebounceMilliseconds);
+
+		// NOTE: File path -> time of the most recent change
+		std::map<std::string, std::chrono::steady_clock::time_point> pendingFilePaths;
+
+		printf("Watching '%.*s' for changes to '.json' files...\n", static_cast<int>(watchedDirectoryPath.size()), watchedDirectoryPath.data());
+		while (true)
+		{
+			u32 timeoutMilliseconds = std::numeric_limits<u32>::max();
+			if (!pendingFilePaths.empty())
+			{
+				auto earliestChangeTime = std::chrono::steady_clock::time_point::max();
+				for (const auto&[filePath, changeTime] : pendingFilePaths)
+					earliestChangeTime = std::min(earliestChangeTime, changeTime);
+
+				const auto remainingDuration = (earliestChangeTime + debounceDuration) - std::chrono::steady_clock::now();
+				timeoutMilliseconds = static_cast<u32>(std::max<i64>(0, std::chrono::duration_cast<std::chrono::milliseconds>(remainingDuration).count()));
+			}
+
+			const bool watchSuccessful = watcher.WaitForChanges(timeoutMilliseconds, [&](std::string_view relativeFilePath)
+			{
+				if (relativeFilePath.empty())
+				{
+					fprintf(stderr, "Too many changes at once, some of them might have been missed\n");
+					return;
+				}
+
+				if (!PeepoHappy::Path::HasFileExtension(relativeFilePath, ".json"))
+					return;
+
+				std::string filePath { watchedDirectoryPath };
+				filePath += '/';
+				filePath += relativeFilePath;
+				pendingFilePaths[std::move(filePath)] = std::chrono::steady_clock::now();
+			});
+
+			if (!watchSuccessful)
+			{
+				fprintf(stderr, "Failed to wait for changes to the input directory\n");
+				return EXIT_WIDEPEEPOSAD;
+			}
+
+			const auto now = std::chrono::steady_clock::now();
+			for (auto it = pendingFilePaths.begin(); it != pendingFilePaths.end();)
+			{
+				if ((now - it->second) < debounceDuration)
+				{
+					++it;
+					continue;
+				}
+
+				const auto startTime = std::chrono::steady_clock::now();
+				const int exitCode = ReadAndWriteJsonToCompressedAndOrEncryptedBinFile(it->first, namedKeys, conversionOptions, nullptr, &reusableDeflater);
+				const auto elapsedMilliseconds = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+				if (exitCode == EXIT_WIDEPEEPOHAPPY)
+					printf("Rebuilt '%s' in %.2f ms\n", it->first.c_str(), elapsedMilliseconds);
+				else
+					fprintf(stderr, "Failed to rebuild '%s'\n", it->first.c_str());
+
+				it = pendingFilePaths.erase(it);
+			}
+		}
+	}
+
+	constexpr size_t StandardStreamChunkSize = 0x10000;
+
+	// NOTE: Decrypts and decompresses stdin to stdout one chunk at a time, so neither side ever has to be held in memory (or on disk) as a whole
+	int DecodeStandardInputToStandardOutput(const CommandLineOptions& options, const std::vector<NamedEncryptionKey>& namedKeys)
+	{
+		PeepoHappy::IO::SetStandardStreamsToBinaryMode();
+
+		auto inputBuffer = PeepoHappy::Memory::MakeTrackedBuffer(StandardStreamChunkSize);
+		auto decryptedBuffer = PeepoHappy::Memory::MakeTrackedBuffer(StandardStreamChunkSize);
+
+		size_t inputSize = fread(inputBuffer.get(), 1, StandardStreamChunkSize, stdin);
+		if (inputSize <= 10)
+		{
+			fprintf(stderr, "Unexpected end of input\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		// NOTE: The first chunk always contains the IV and the first encrypted block which is all that's needed to find the right key
+		const NamedEncryptionKey* key = nullptr;
+		PeepoHappy::Crypto::AesIVBytes iv = {};
+		size_t inputOffset = 0;
+
+		if (!PeepoHappy::Compression::HasValidGZipHeader(inputBuffer.get(), inputSize))
+		{
+			memcpy(iv.data(), inputBuffer.get(), iv.size());
+			inputOffset = iv.size();
+
+			if (!options.KeyName.empty())
+			{
+				if ((key = FindNamedEncryptionKey(namedKeys, options.KeyName)) == nullptr)
+				{
+					fprintf(stderr, "Unknown key name '%.*s'\n", static_cast<int>(options.KeyName.size()), options.KeyName.data());
+					return EXIT_WIDEPEEPOSAD;
+				}
+			}
+			else if ((key = TryOutAllAvailableEncrpytionKeysUntilGZipHeaderIsFound(inputBuffer.get() + iv.size(), inputSize - iv.size(), iv, namedKeys)) == nullptr)
+			{
+				fprintf(stderr, "No matching encrpytion key definition found for input\n");
+				return EXIT_WIDEPEEPOSAD;
+			}
+		}
+
+		bool reachedNullTerminator = false, writeFailed = false;
+		size_t jsonSize = 0;
+
+		auto writeJsonChunk = [&](const u8* chunk, size_t chunkSize)
+		{
+			// NOTE: Same as the regular .bin -> .json conversion which also stops at the first null character
+			if (reachedNullTerminator)
+				return;
+
+			const size_t chunkLength = strnlen(reinterpret_cast<const char*>(chunk), chunkSize);
+			reachedNullTerminator = (chunkLength < chunkSize);
+			writeFailed |= (fwrite(chunk, 1, chunkLength, stdout) != chunkLength);
+			jsonSize += chunkLength;
+		};
+
+		PeepoHappy::Compression::Inflater inflater;
+		while (true)
+		{
+			const u8* data = (inputBuffer.get() + inputOffset);
+			const size_t dataSize = (inputSize - inputOffset);
+			size_t consumedSize = dataSize;
+
+			if (key != nullptr)
+			{
+				// NOTE: Only whole blocks can be decrypted, the remaining bytes are carried over into the next chunk.
+				//		 Continuing the CBC chain only requires the last encrypted block of the previous chunk as the next IV
+				consumedSize = (dataSize - (dataSize % PeepoHappy::Crypto::AesBlockAlignment));
+				if (consumedSize > 0)
+				{
+					if (!DecryptUsingNamedKey(*key, data, decryptedBuffer.get(), consumedSize, iv))
+					{
+						fprintf(stderr, "Failed to decrypt input\n");
+						return EXIT_WIDEPEEPOSAD;
+					}
+
+					memcpy(iv.data(), data + consumedSize - iv.size(), iv.size());
+				}
+			}
+
+			if (!inflater.Update((key != nullptr) ? decryptedBuffer.get() : data, consumedSize, writeJsonChunk))
+			{
+				fprintf(stderr, "Failed to decompress input\n");
+				return EXIT_WIDEPEEPOSAD;
+			}
+
+			const size_t carriedOverSize = (dataSize - consumedSize);
+			memmove(inputBuffer.get(), data + consumedSize, carriedOverSize);
+
+			const size_t readSize = fread(inputBuffer.get() + carriedOverSize, 1, StandardStreamChunkSize - carriedOverSize, stdin);
+			inputSize = (carriedOverSize + readSize);
+			inputOffset = 0;
+
+			if (readSize == 0)
+				break;
+		}
+
+		fflush(stdout);
+		if (ferror(stdin) || inputSize > 0)
+		{
+			fprintf(stderr, "Unexpected end of encrypted input\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		if (!inflater.IsFinished() || jsonSize <= 0)
+		{
+			fprintf(stderr, "Truncated or corrupted input\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		if (writeFailed || ferror(stdout))
+		{
+			fprintf(stderr, "Failed to write output\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		return EXIT_WIDEPEEPOHAPPY;
+	}
+
+	// NOTE: Compresses and encrypts stdin to stdout one chunk at a time. Only a content derived IV requires holding on to
+	//		 all of the compressed data (never the uncompressed input) since the IV has to be written before any of the encrypted data
+	int EncodeStandardInputToStandardOutput(const CommandLineOptions& options, const std::vector<NamedEncryptionKey>& namedKeys)
+	{
+		const NamedEncryptionKey* key = options.KeyName.empty() ? nullptr : FindNamedEncryptionKey(namedKeys, options.KeyName);
+		if (!options.KeyName.empty() && key == nullptr)
+		{
+			fprintf(stderr, "Unknown key name '%.*s'\n", static_cast<int>(options.KeyName.size()), options.KeyName.data());
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		IVMode ivMode = options.EncryptionIVMode;
+		if (ivMode == IVMode::Original)
+		{
+			fprintf(stderr, "There is no existing output file to take the IV from when writing to stdout. Falling back to a content derived IV\n");
+			ivMode = IVMode::Content;
+		}
+
+		PeepoHappy::IO::SetStandardStreamsToBinaryMode();
+
+		const bool encryptWhileCompressing = (key != nullptr && ivMode == IVMode::Constant);
+		bool writeFailed = false, encryptFailed = false;
+
+		PeepoHappy::Crypto::AesIVBytes iv = {};
+		std::vector<u8> pendingCompressedData, encryptedData;
+
+		auto writeOutput = [&](const u8* data, size_t dataSize)
+		{
+			writeFailed |= (fwrite(data, 1, dataSize, stdout) != dataSize);
+		};
+
+		auto encryptAndWritePendingCompressedData = [&](size_t alignedSize)
+		{
+			encryptedData.resize(alignedSize);
+			if (!EncryptUsingNamedKey(*key, pendingCompressedData.data(), encryptedData.data(), alignedSize, iv))
+			{
+				encryptFailed = true;
+				return;
+			}
+
+			// NOTE: Continuing the CBC chain with the last encrypted block as the IV of the next chunk
+			memcpy(iv.data(), encryptedData.data() + alignedSize - iv.size(), iv.size());
+			writeOutput(encryptedData.data(), alignedSize);
+			pendingCompressedData.erase(pendingCompressedData.begin(), pendingCompressedData.begin() + alignedSize);
+		};
+
+		auto onCompressedChunk = [&](const u8* chunk, size_t chunkSize)
+		{
+			if (key == nullptr)
+				return writeOutput(chunk, chunkSize);
+
+			pendingCompressedData.insert(pendingCompressedData.end(), chunk, chunk + chunkSize);
+			if (encryptWhileCompressing && pendingCompressedData.size() >= StandardStreamChunkSize)
+				encryptAndWritePendingCompressedData(pendingCompressedData.size() - (pendingCompressedData.size() % PeepoHappy::Crypto::AesBlockAlignment));
+		};
+
+		if (encryptWhileCompressing)
+		{
+			iv = ConstantEncryptionIV;
+			writeOutput(iv.data(), iv.size());
+		}
+
+		auto inputBuffer = PeepoHappy::Memory::MakeTrackedBuffer(StandardStreamChunkSize);
+		PeepoHappy::Compression::Deflater deflater;
+		size_t jsonSize = 0;
+
+		for (size_t readSize = 0; (readSize = fread(inputBuffer.get(), 1, StandardStreamChunkSize, stdin)) > 0; jsonSize += readSize)
+		{
+			if (!deflater.Update(inputBuffer.get(), readSize, onCompressedChunk))
+			{
+				fprintf(stderr, "Failed to compress input\n");
+				return EXIT_WIDEPEEPOSAD;
+			}
+		}
+
+		if (ferror(stdin) || jsonSize <= 0)
+		{
+			fprintf(stderr, "Failed to read input\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		if (!deflater.Finish(onCompressedChunk))
+		{
+			fprintf(stderr, "Failed to compress input\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		if (key != nullptr)
+		{
+			// NOTE: Everything before has been flushed in multiples of the block size, so this is also the alignment of the total compressed size
+			const size_t remainingSize = pendingCompressedData.size();
+			const size_t alignedSize = PeepoHappy::Crypto::Align(remainingSize, PeepoHappy::Crypto::AesBlockAlignment);
+			pendingCompressedData.resize(alignedSize, GetEncryptionPaddingByte(*key, alignedSize - remainingSize));
+
+			if (!encryptWhileCompressing)
+			{
+				iv = ChooseEncryptionIV(ivMode, *key, pendingCompressedData.data(), pendingCompressedData.size(), nullptr);
+				writeOutput(iv.data(), iv.size());
+			}
+
+			if (alignedSize > 0)
+				encryptAndWritePendingCompressedData(alignedSize);
+		}
+
+		fflush(stdout);
+		if (encryptFailed)
+		{
+			fprintf(stderr, "Failed to encrypt input\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		if (writeFailed || ferror(stdout))
+		{
+			fprintf(stderr, "Failed to write output\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		if (jsonSize >= MaxDecompressedGameDataTableFileSize)
+			fprintf(stderr, "Input JSON is larger than the %zu bytes supported by the game\n", MaxDecompressedGameDataTableFileSize);
+
+		return EXIT_WIDEPEEPOHAPPY;
+	}
+
+	// NOTE: Any .bin member directly inside of a "datatable" directory, no matter how deep (so "romfs/datatable/*.bin" is picked up too)
+	bool IsDataTableBinTarMember(const TarMember& member)
+	{
+		return member.IsRegularFile && PeepoHappy::Path::HasFileExtension(member.Path, ".bin") &&
+			PeepoHappy::ASCII::MatchesInsensitive(PeepoHappy::Path::GetFileName(PeepoHappy::Path::GetDirectoryName(member.Path)), "datatable");
+	}
+
+	// NOTE: Archives and images are untrusted input so paths taken from them must never be able to escape the output directory
+	bool IsSafeRelativeOutputPath(std::string_view memberPath)
+	{
+		if (memberPath.empty() || memberPath.front() == '/' || memberPath.front() == '\\' || memberPath.find(':') != std::string_view::npos)
+			return false;
+
+		while (!memberPath.empty())
+		{
+			const size_t separator = memberPath.find_first_of("/\\");
+			if (memberPath.substr(0, separator) == "..")
+				return false;
+			if (separator == std::string_view::npos)
+				break;
+			memberPath = memberPath.substr(separator + 1);
+		}
+		return true;
+	}
+
+	struct ConvertedTarMember
+	{
+		std::string InputPath;
+		std::string OutputPath;
+		u64 ModificationTime;
+		DecodedJsonFile JsonFile;
+	};
+
+	// NOTE: Decodes every DataTable .bin member of a tar stream while the rest of it is still being read, without ever unpacking anything to disk.
+	//		 Only a fixed number of members are in flight at once (keeping memory usage bounded no matter the size of the archive)
+	//		 and their output is written strictly in input order, either as another tar stream or into a directory
+	int ConvertTarStreamBinMembersToJson(const CommandLineOptions& options, const std::vector<NamedEncryptionKey>& namedKeys)
+	{
+		const std::string_view inputFilePath = options.InputPaths.empty() ? "-" : options.InputPaths.front();
+		const std::string_view outputPath = options.OutputPath.empty() ? "-" : options.OutputPath;
+		const bool readFromStandardInput = (inputFilePath == "-");
+		const bool writeToStandardOutput = (outputPath == "-");
+		const bool writeToDirectory = !writeToStandardOutput && !PeepoHappy::Path::HasFileExtension(outputPath, ".tar");
+
+		if (readFromStandardInput || writeToStandardOutput)
+			PeepoHappy::IO::SetStandardStreamsToBinaryMode();
+
+		PeepoHappy::IO::FileStream inputFileStream = readFromStandardInput ? nullptr : PeepoHappy::IO::OpenFileStream(inputFilePath, L"rb");
+		if (!readFromStandardInput && inputFileStream == nullptr)
+		{
+			fprintf(stderr, "Failed to open input file '%.*s'\n", static_cast<int>(inputFilePath.size()), inputFilePath.data());
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		PeepoHappy::IO::FileStream outputFileStream = (writeToStandardOutput || writeToDirectory) ? nullptr : PeepoHappy::IO::OpenFileStream(outputPath, L"wb");
+		if (!writeToStandardOutput && !writeToDirectory && outputFileStream == nullptr)
+		{
+			fprintf(stderr, "Failed to create output file '%.*s'\n", static_cast<int>(outputPath.size()), outputPath.data());
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		TarReader reader(readFromStandardInput ? stdin : inputFileStream.get());
+		TarWriter writer(writeToStandardOutput ? stdout : outputFileStream.get());
+
+		const u32 threadCount = (options.ThreadCount > 0) ? options.ThreadCount : PeepoHappy::Threading::GetHardwareThreadCount();
+		// NOTE: Enough to keep every worker busy while the oldest member is still being written, with each one holding at most ~2MB of decompressed JSON
+		const size_t maxInFlightCount = static_cast<size_t>(threadCount) * 2;
+
+		size_t convertedCount = 0, failedCount = 0, skippedCount = 0;
+		bool outputFailed = false;
+
+		PeepoHappy::Threading::ThreadPool threadPool(threadCount);
+		std::deque<std::future<ConvertedTarMember>> inFlightMembers;
+
+		auto writeOldestInFlightMember = [&]()
+		{
+			ConvertedTarMember member = inFlightMembers.front().get();
+			inFlightMembers.pop_front();
+
+			if (member.JsonFile.Json.empty())
+			{
+				fprintf(stderr, "Failed to convert '%s'\n", member.InputPath.c_str());
+				failedCount++;
+				return;
+			}
+
+			const u8* jsonData = reinterpret_cast<const u8*>(member.JsonFile.Json.data());
+			const size_t jsonSize = member.JsonFile.Json.size();
+
+			if (writeToDirectory)
+			{
+				const std::string outputFilePath = std::string(outputPath) + "/" + member.OutputPath;
+				if (!PeepoHappy::IO::CreateDirectoryRecursive(PeepoHappy::Path::GetDirectoryName(outputFilePath)) || !PeepoHappy::IO::WriteEntireFile(outputFilePath, jsonData, jsonSize))
+				{
+					fprintf(stderr, "Failed to write output file '%s'\n", outputFilePath.c_str());
+					failedCount++;
+					return;
+				}
+			}
+			else if (!writer.WriteMember(member.OutputPath, jsonData, jsonSize, member.ModificationTime))
+			{
+				// NOTE: There is no way to recover a tar stream that has been cut off halfway through a member
+				fprintf(stderr, "Failed to write output tar stream\n");
+				outputFailed = true;
+				failedCount++;
+				return;
+			}
+
+			convertedCount++;
+		};
+
+		TarMember member = {};
+		while (!outputFailed && reader.ReadNextMember(member))
+		{
+			if (!IsDataTableBinTarMember(member))
+			{
+				skippedCount++;
+				continue;
+			}
+
+			if (writeToDirectory && !IsSafeRelativeOutputPath(member.Path))
+			{
+				fprintf(stderr, "Skipping unsafe member path '%s'\n", member.Path.c_str());
+				failedCount++;
+				continue;
+			}
+
+			if (member.Size >= MaxDecompressedGameDataTableFileSize)
+			{
+				fprintf(stderr, "Skipping '%s'. DataTable files are limited to %zu bytes\n", member.Path.c_str(), MaxDecompressedGameDataTableFileSize);
+				failedCount++;
+				continue;
+			}
+
+			auto binFileContent = PeepoHappy::Memory::MakeTrackedBuffer(static_cast<size_t>(member.Size));
+			if (!reader.ReadMemberContent(binFileContent.get(), static_cast<size_t>(member.Size)))
+				break;
+
+			// NOTE: Wrapped inside a shared pointer because std::function requires a copyable callable
+			auto task = std::make_shared<std::packaged_task<ConvertedTarMember()>>(
+				[&namedKeys, memberPath = member.Path, modificationTime = member.ModificationTime, binFileSize = static_cast<size_t>(member.Size), binFileContent = std::move(binFileContent)]()
+			{
+				Statistics::ScopedFileStatistics scopedFileStatistics(Statistics::BeginFile(memberPath));
+				if (auto* stats = Statistics::ThisThreadFileStatistics; stats != nullptr)
+					stats->BytesIn = binFileSize;
+
+				ConvertedTarMember result = {};
+				result.InputPath = memberPath;
+				result.ModificationTime = modificationTime;
+				result.JsonFile = DecryptAndDecompressBinFileContent(binFileContent.get(), binFileSize, namedKeys);
+				result.OutputPath = FormatJsonOutputFilePathUsingNamedKey(memberPath, result.JsonFile.Key);
+				return result;
+			});
+
+			inFlightMembers.push_back(task->get_future());
+			threadPool.Submit([task]() { (*task)(); });
+
+			if (inFlightMembers.size() >= maxInFlightCount)
+				writeOldestInFlightMember();
+		}
+
+		// NOTE: Anything still in flight after the output failed is simply waited on by the thread pool destructor and discarded
+		while (!outputFailed && !inFlightMembers.empty())
+			writeOldestInFlightMember();
+
+		if (!writeToDirectory && !outputFailed && !writer.Finish())
+		{
+			fprintf(stderr, "Failed to write output tar stream\n");
+			outputFailed = true;
+		}
+
+		fprintf(stderr, "%zu member(s) converted, %zu failed, %zu skipped\n", convertedCount, failedCount, skippedCount);
+		return (failedCount == 0 && !outputFailed && !reader.HasFailed()) ? EXIT_WIDEPEEPOHAPPY : EXIT_WIDEPEEPOSAD;
+	}
+
+	constexpr std::string_view RomFSDataTableDirectoryPath = "datatable";
+
+	// NOTE: Decodes every .bin file inside the "datatable" directory of a RomFS image straight out of the memory mapped image,
+	//		 so that a full dump can be processed without extracting (or even copying) any of its files first
+	int ConvertRomFSImageDataTableFilesToJson(const CommandLineOptions& options, const std::vector<NamedEncryptionKey>& namedKeys)
+	{
+		if (options.InputPaths.empty())
+		{
+			fprintf(stderr, "No input RomFS image specified\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		const std::string_view imageFilePath = options.InputPaths.front();
+		PeepoHappy::IO::MemoryMappedFile imageFile;
+		if (!imageFile.Open(imageFilePath))
+		{
+			fprintf(stderr, "Failed to open input file '%.*s'\n", static_cast<int>(imageFilePath.size()), imageFilePath.data());
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		RomFSImage image;
+		if (!image.Parse(imageFile.GetData(), imageFile.GetSize()))
+		{
+			fprintf(stderr, "Invalid RomFS image\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		const u32 dataTableDirectoryOffset = image.FindDirectory(RomFSDataTableDirectoryPath);
+		if (dataTableDirectoryOffset == RomFSImage::InvalidEntryOffset)
+		{
+			fprintf(stderr, "No '%.*s' directory found inside RomFS image\n", static_cast<int>(RomFSDataTableDirectoryPath.size()), RomFSDataTableDirectoryPath.data());
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		// NOTE: Still converts whatever could be read before the malformed entry but never reports success for a partial directory
+		std::vector<RomFSFile> binFiles;
+		const bool allFilesListed = image.GetFilesInDirectory(dataTableDirectoryOffset, binFiles);
+		if (!allFilesListed)
+			fprintf(stderr, "Malformed file entry inside the '%.*s' directory of the RomFS image, only the first %zu file(s) are listed\n", static_cast<int>(RomFSDataTableDirectoryPath.size()), RomFSDataTableDirectoryPath.data(), binFiles.size());
+
+		binFiles.erase(std::remove_if(binFiles.begin(), binFiles.end(), [](const RomFSFile& file) { return !PeepoHappy::Path::HasFileExtension(file.Name, ".bin"); }), binFiles.end());
+
+		// NOTE: Mirrors the layout of an extracted dump, so "romfs.bin" turns into "romfs/datatable/*.json" unless specified otherwise
+		const std::string outputDirectoryPath = options.OutputPath.empty() ?
+			(std::string(PeepoHappy::Path::TrimFileExtension(imageFilePath)) + "/" + std::string(RomFSDataTableDirectoryPath)) :
+			std::string(options.OutputPath);
+
+		if (!PeepoHappy::IO::CreateDirectoryRecursive(outputDirectoryPath))
+		{
+			fprintf(stderr, "Failed to create output directory '%s'\n", outputDirectoryPath.c_str());
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		std::atomic<size_t> failedCount = 0;
+		const u32 threadCount = (options.ThreadCount > 0) ? options.ThreadCount : PeepoHappy::Threading::GetHardwareThreadCount();
+
+		PeepoHappy::Threading::ParallelForEachIndex(binFiles.size(), threadCount, [&](size_t index)
+		{
+			const RomFSFile& binFile = binFiles[index];
+			const std::string binFilePath = outputDirectoryPath + "/" + std::string(binFile.Name);
+
+			Statistics::ScopedFileStatistics scopedFileStatistics(Statistics::BeginFile(binFilePath));
+			if (auto* stats = Statistics::ThisThreadFileStatistics; stats != nullptr)
+				stats->BytesIn = binFile.Size;
+
+			if (!IsSafeRelativeOutputPath(binFile.Name) || binFile.Name.find_first_of("/\\") != std::string_view::npos)
+			{
+				fprintf(stderr, "Skipping unsafe file name '%.*s'\n", static_cast<int>(binFile.Name.size()), binFile.Name.data());
+				failedCount++;
+				return;
+			}
+
+			const DecodedJsonFile jsonFile = DecryptAndDecompressBinFileContent(binFile.Data, binFile.Size, namedKeys);
+			const std::string jsonOutputFilePath = FormatJsonOutputFilePathUsingNamedKey(binFilePath, jsonFile.Key);
+
+			if (jsonFile.Json.empty() || !Statistics::TimeStage(Statistics::Stage::Write, PeepoHappy::IO::WriteEntireFile, jsonOutputFilePath, reinterpret_cast<const u8*>(jsonFile.Json.data()), jsonFile.Json.size()))
+			{
+				fprintf(stderr, "Failed to convert '%.*s'\n", static_cast<int>(binFile.Name.size()), binFile.Name.data());
+				failedCount++;
+			}
+		});
+
+		printf("Converted %zu of %zu DataTable file(s) into '%s'\n", binFiles.size() - failedCount, binFiles.size(), outputDirectoryPath.c_str());
+		return (failedCount == 0 && allFilesListed) ? EXIT_WIDEPEEPOHAPPY : EXIT_WIDEPEEPOSAD;
+	}
+
+	// NOTE: The path of a file found inside the directory relative to that directory
+	std::string_view GetRelativeFilePath(std::string_view filePath, std::string_view directoryPath)
+	{
+		std::string_view relativePath = filePath.substr(directoryPath.size());
+		while (!relativePath.empty() && (relativePath.front() == '/' || relativePath.front() == '\\'))
+			relativePath.remove_prefix(1);
+		return relativePath;
+	}
+
+	// NOTE: Relative paths that refer to the same file on Windows (ignoring case and path separators) share the same lookup key
+	std::string MakeRelativeFilePathLookupKey(std::string_view relativePath)
+	{
+		std::string lookupKey { relativePath };
+		for (char& c : lookupKey)
+			c = (c == '\\') ? '/' : PeepoHappy::ASCII::ToLowerCase(c);
+		return lookupKey;
+	}
+
+	enum class LayeredFSFileAction : u8
+	{
+		// NOTE: The output file is already up to date and isn't touched at all
+		Unchanged,
+		// NOTE: The original .bin file is copied into the output directory. Never hard linked, since any tool later writing to the output file
+		//		 in place would then silently modify the original dump as well
+		Copy,
+		// NOTE: The .json input file differs from the original and is converted into a new .bin file
+		Write,
+		Count
+	};
+
+	struct LayeredFSFile
+	{
+		std::string RelativeBinFilePath;
+		std::string OriginalBinFilePath;
+		std::string JsonInputFilePath;
+		const NamedEncryptionKey* Key;
+		LayeredFSFileAction Action;
+		std::string StagedFilePath;
+		bool HadPreviousFile;
+	};
+
+	constexpr std::string_view LayeredFSStagedFileSuffix = ".staged";
+	constexpr std::string_view LayeredFSPreviousFileSuffix = ".previous";
+
+	// NOTE: Writes (or copies) the file next to its output file path without replacing the output file itself yet
+	bool StageLayeredFSFile(LayeredFSFile& file, std::string_view outputFilePath, const std::vector<NamedEncryptionKey>& namedKeys, IVMode ivMode)
+	{
+		bool copyOriginal = file.JsonInputFilePath.empty();
+		EncodedBinFile binFile = {};
+
+		if (!file.JsonInputFilePath.empty())
+		{
+			const auto[jsonFileContent, jsonFileSize] = Statistics::TimeStage(Statistics::Stage::Read, PeepoHappy::IO::ReadEntireFile, file.JsonInputFilePath);
+			if (jsonFileContent == nullptr)
+			{
+				fprintf(stderr, "Failed to read input file '%s'\n", file.JsonInputFilePath.c_str());
+				return false;
+			}
+
+			// NOTE: A .json file that was extracted but never edited decodes to the exact same JSON as its original
+			if (!file.OriginalBinFilePath.empty())
+			{
+				const auto[originalFileContent, originalFileSize] = Statistics::TimeStage(Statistics::Stage::Read, PeepoHappy::IO::ReadEntireFile, file.OriginalBinFilePath);
+				const DecodedJsonFile originalJsonFile = (originalFileContent != nullptr) ? DecryptAndDecompressBinFileContent(originalFileContent.get(), originalFileSize, namedKeys) : DecodedJsonFile {};
+				copyOriginal = (!originalJsonFile.Json.empty() && originalJsonFile.Key == file.Key && originalJsonFile.Json == std::string_view(reinterpret_cast<const char*>(jsonFileContent.get()), jsonFileSize));
+			}
+
+			if (!copyOriginal)
+			{
+				binFile = CompressAndEncryptJsonFileContent(jsonFileContent.get(), jsonFileSize, file.Key, ivMode, file.OriginalBinFilePath, nullptr);
+				if (binFile.Content == nullptr)
+					return false;
+			}
+		}
+
+		file.StagedFilePath = std::string(outputFilePath) + std::string(LayeredFSStagedFileSuffix);
+		Statistics::ScopedStageTimer writeTimer(Statistics::Stage::Write);
+
+		// NOTE: Output files that are still hard linked to their original (as done by earlier versions) are always replaced to break the link
+		const bool outputFileIsLinked = (PeepoHappy::IO::GetFileLinkCount(outputFilePath) > 1);
+
+		if (copyOriginal)
+		{
+			// NOTE: Copying preserves the size and last write time of the original
+			if (!outputFileIsLinked && PeepoHappy::IO::GetFileMetadata(outputFilePath) == PeepoHappy::IO::GetFileMetadata(file.OriginalBinFilePath))
+			{
+				file.Action = LayeredFSFileAction::Unchanged;
+				return true;
+			}
+
+			file.Action = LayeredFSFileAction::Copy;
+			if (PeepoHappy::IO::DuplicateFile(file.OriginalBinFilePath, file.StagedFilePath))
+				return true;
+
+			fprintf(stderr, "Failed to copy '%s'\n", file.OriginalBinFilePath.c_str());
+			return false;
+		}
+
+		if (const auto[existingFileContent, existingFileSize] = PeepoHappy::IO::ReadEntireFile(outputFilePath); !outputFileIsLinked && existingFileContent != nullptr && existingFileSize == binFile.Size && memcmp(existingFileContent.get(), binFile.Content, binFile.Size) == 0)
+		{
+			file.Action = LayeredFSFileAction::Unchanged;
+			return true;
+		}
+
+		file.Action = LayeredFSFileAction::Write;
+		if (PeepoHappy::IO::WriteEntireFile(file.StagedFilePath, binFile.Content, binFile.Size))
+			return true;
+
+		fprintf(stderr, "Failed to write '%s'\n", file.StagedFilePath.c_str());
+		return false;
+	}
+
+	// NOTE: Assembles a LayeredFS "romfs/datatable" directory out of the original .bin files of a dump and a directory of (partially) edited .json files.
+	//		 Only .json files whose content actually differs from their original are converted, every other .bin file is copied from its original.
+	//		 All output files are staged next to their destination first and only renamed into place once every single one of them succeeded.
+	//		 If any of the renames fails all previous ones are undone again, so that a failed build never leaves behind a partially updated output directory
+	int BuildLayeredFSDataTableDirectory(const CommandLineOptions& options, const std::vector<NamedEncryptionKey>& namedKeys)
+	{
+		if (options.InputPaths.empty() || options.OriginalDirectoryPath.empty() || options.OutputPath.empty())
+		{
+			fprintf(stderr, "Expected an input '.json' directory, an '--original' '.bin' directory and an '--output' directory\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		const std::string_view jsonDirectoryPath = options.InputPaths.front();
+
+		std::map<std::string, LayeredFSFile> filesByLookupKey;
+		PeepoHappy::IO::ForEachFileInDirectory(options.OriginalDirectoryPath, [&](std::string_view filePath)
+		{
+			if (!PeepoHappy::Path::HasFileExtension(filePath, ".bin"))
+				return;
+
+			const std::string_view relativePath = GetRelativeFilePath(filePath, options.OriginalDirectoryPath);
+			LayeredFSFile& file = filesByLookupKey[MakeRelativeFilePathLookupKey(relativePath)];
+			file.RelativeBinFilePath = relativePath;
+			file.OriginalBinFilePath = filePath;
+		});
+
+		PeepoHappy::IO::ForEachFileInDirectory(jsonDirectoryPath, [&](std::string_view filePath)
+		{
+			if (!PeepoHappy::Path::HasFileExtension(filePath, ".json"))
+				return;
+
+			const auto[relativeBinFilePath, key] = ParseJsonInputFilePathUsingNamedKeysAndFormatBinOutputFilePath(GetRelativeFilePath(filePath, jsonDirectoryPath), namedKeys);
+			LayeredFSFile& file = filesByLookupKey[MakeRelativeFilePathLookupKey(relativeBinFilePath)];
+			if (file.RelativeBinFilePath.empty())
+				file.RelativeBinFilePath = relativeBinFilePath;
+			file.JsonInputFilePath = filePath;
+			file.Key = key;
+		});
 
-	constexpr std::string_view EncrpytionKeysIniFileName = "TaikoSwitchDataTableEncrpytionKeys.ini";
+		std::vector<LayeredFSFile> files;
+		files.reserve(filesByLookupKey.size());
+		for (auto& entry : filesByLookupKey)
+			files.push_back(std::move(entry.second));
+
+		std::atomic<size_t> failedCount = 0;
+		const u32 threadCount = (options.ThreadCount > 0) ? options.ThreadCount : PeepoHappy::Threading::GetHardwareThreadCount();
+
+		PeepoHappy::Threading::ParallelForEachIndex(files.size(), threadCount, [&](size_t index)
+		{
+			LayeredFSFile& file = files[index];
+			Statistics::ScopedFileStatistics scopedFileStatistics(Statistics::BeginFile(file.JsonInputFilePath.empty() ? file.OriginalBinFilePath : file.JsonInputFilePath));
+
+			const std::string outputFilePath = std::string(options.OutputPath) + "/" + file.RelativeBinFilePath;
+			if (!PeepoHappy::IO::CreateDirectoryRecursive(PeepoHappy::Path::GetDirectoryName(outputFilePath)) || !StageLayeredFSFile(file, outputFilePath, namedKeys, options.EncryptionIVMode))
+				failedCount++;
+		});
+
+		auto removeStagedFiles = [&]()
+		{
+			for (const LayeredFSFile& file : files)
+			{
+				if (file.Action != LayeredFSFileAction::Unchanged && !file.StagedFilePath.empty())
+					PeepoHappy::IO::RemoveFile(file.StagedFilePath);
+			}
+		};
+
+		if (failedCount > 0)
+		{
+			removeStagedFiles();
+			fprintf(stderr, "%zu file(s) failed, the output directory has been left unchanged\n", failedCount.load());
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		// NOTE: Only metadata operations left at this point. Every existing output file is moved aside before being replaced
+		//		 so that it can be moved back if any later rename fails
+		std::array<size_t, static_cast<size_t>(LayeredFSFileAction::Count)> actionCounts = {};
+		std::vector<const LayeredFSFile*> replacedFiles;
+		bool replaceFailed = false;
+
+		for (LayeredFSFile& file : files)
+		{
+			actionCounts[static_cast<size_t>(file.Action)]++;
+			if (file.Action == LayeredFSFileAction::Unchanged)
+				continue;
+
+			const std::string outputFilePath = std::string(options.OutputPath) + "/" + file.RelativeBinFilePath;
+			const std::string previousFilePath = outputFilePath + std::string(LayeredFSPreviousFileSuffix);
+
+			file.HadPreviousFile = (PeepoHappy::IO::GetFileMetadata(outputFilePath) != PeepoHappy::IO::FileMetadata {});
+			const bool movedAside = file.HadPreviousFile && PeepoHappy::IO::RenameFile(outputFilePath, previousFilePath);
+
+			if ((file.HadPreviousFile && !movedAside) || !PeepoHappy::IO::RenameFile(file.StagedFilePath, outputFilePath))
+			{
+				fprintf(stderr, "Failed to replace '%s'\n", outputFilePath.c_str());
+				if (movedAside)
+					PeepoHappy::IO::RenameFile(previousFilePath, outputFilePath);
+
+				replaceFailed = true;
+				break;
+			}
+
+			replacedFiles.push_back(&file);
+		}
+
+		if (replaceFailed)
+		{
+			size_t restoreFailedCount = 0;
+			for (auto it = replacedFiles.rbegin(); it != replacedFiles.rend(); it++)
+			{
+				const std::string outputFilePath = std::string(options.OutputPath) + "/" + (*it)->RelativeBinFilePath;
+				const std::string previousFilePath = outputFilePath + std::string(LayeredFSPreviousFileSuffix);
+
+				if ((*it)->HadPreviousFile ? !PeepoHappy::IO::RenameFile(previousFilePath, outputFilePath) : !PeepoHappy::IO::RemoveFile(outputFilePath))
+				{
+					fprintf(stderr, "Failed to restore '%s'\n", outputFilePath.c_str());
+					restoreFailedCount++;
+				}
+			}
+			removeStagedFiles();
+
+			if (restoreFailedCount == 0)
+				fprintf(stderr, "Failed to replace all output files, the output directory has been left unchanged\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
 
-	struct NamedEncryptionKey
-	{
-		std::string_view Name;
-		size_t KeyByteSize;
-		PeepoHappy::Crypto::Aes128KeyBytes Key128;
-		PeepoHappy::Crypto::Aes256KeyBytes Key256;
-	};
+		for (const LayeredFSFile* file : replacedFiles)
+		{
+			if (file->HadPreviousFile)
+				PeepoHappy::IO::RemoveFile(std::string(options.OutputPath) + "/" + file->RelativeBinFilePath + std::string(LayeredFSPreviousFileSuffix));
+		}
 
-	bool DecryptUsingNamedKey(const NamedEncryptionKey& namedKey, const u8* inEncryptedData, u8* outDecryptedData, size_t inOutDataSize, PeepoHappy::Crypto::AesIVBytes iv)
-	{
-		if (namedKey.KeyByteSize == namedKey.Key128.size())
-			return PeepoHappy::Crypto::DecryptAes128Cbc(inEncryptedData, outDecryptedData, inOutDataSize, namedKey.Key128, iv);
-		else if (namedKey.KeyByteSize == namedKey.Key256.size())
-			return PeepoHappy::Crypto::DecryptAes256Cbc(inEncryptedData, outDecryptedData, inOutDataSize, namedKey.Key256, iv);
-		else
-			assert(false);
+		printf("%zu file(s) written, %zu copied, %zu unchanged\n",
+			actionCounts[static_cast<size_t>(LayeredFSFileAction::Write)],
+			actionCounts[static_cast<size_t>(LayeredFSFileAction::Copy)],
+			actionCounts[static_cast<size_t>(LayeredFSFileAction::Unchanged)]);
 
-		return false;
+		return (failedCount == 0) ? EXIT_WIDEPEEPOHAPPY : EXIT_WIDEPEEPOSAD;
 	}
 
-	bool EncryptUsingNamedKey(const NamedEncryptionKey& namedKey, const u8* inDecryptedData, u8* outEncryptedData, size_t inOutDataSize, PeepoHappy::Crypto::AesIVBytes iv)
+	bool WriteDaemonResponse(PeepoHappy::IO::NamedPipe& pipe, DaemonProtocol::Status status, std::string_view text, const u8* payload = nullptr, size_t payloadSize = 0)
 	{
-		if (namedKey.KeyByteSize == namedKey.Key128.size())
-			return PeepoHappy::Crypto::EncryptAes128Cbc(inDecryptedData, outEncryptedData, inOutDataSize, namedKey.Key128, iv);
-		else if (namedKey.KeyByteSize == namedKey.Key256.size())
-			return PeepoHappy::Crypto::EncryptAes256Cbc(inDecryptedData, outEncryptedData, inOutDataSize, namedKey.Key256, iv);
-		else
-			assert(false);
+		DaemonProtocol::ResponseHeader header = {};
+		header.Magic = DaemonProtocol::ResponseMagic;
+		header.ResponseStatus = status;
+		header.TextSize = static_cast<u32>(text.size());
+		header.PayloadSize = static_cast<u32>(payloadSize);
 
-		return false;
+		return pipe.WriteAll(&header, sizeof(header)) && pipe.WriteAll(text.data(), text.size()) && pipe.WriteAll(payload, payloadSize);
 	}
 
-	std::vector<NamedEncryptionKey> ReadAndParseEncrpytionKeysIniFile(std::unique_ptr<u8[]>& outIniFileContent)
+	// NOTE: Returns false once the client has disconnected (or can't be served anymore) and the next one should be waited for instead
+	bool ServeDaemonRequest(PeepoHappy::IO::NamedPipe& pipe, const std::vector<NamedEncryptionKey>& namedKeys, const JsonToBinConversionOptions& baseConversionOptions, PeepoHappy::Compression::Deflater& reusableDeflater, std::atomic<bool>& outShutdownRequested)
 	{
-		std::vector<NamedEncryptionKey> namedKeys;
-
-#if 1 // NOTE: I think this makes more sense here, don't wanna fail to load the file just because of a different working directory
-		auto[iniFileContent, iniFileSize] = PeepoHappy::IO::ReadEntireFile(PeepoHappy::UTF8::GetExecutableDirectory() + "/" + std::string(EncrpytionKeysIniFileName));
-#else
-		auto[iniFileContent, iniFileSize] = PeepoHappy::IO::ReadEntireFile(EncrpytionKeysIniFileName);
-#endif
+		DaemonProtocol::RequestHeader header = {};
+		if (!pipe.ReadExact(&header, sizeof(header)))
+			return false;
 
-		if (iniFileContent != nullptr)
+		// NOTE: There is no way to find the start of the next request after a malformed one, so the connection is dropped
+		if (header.Magic != DaemonProtocol::RequestMagic || header.Version != DaemonProtocol::Version || header.TextSize > DaemonProtocol::MaxTextSize || header.PayloadSize > DaemonProtocol::MaxPayloadSize)
 		{
-			const auto iniFileStringView = std::string_view(reinterpret_cast<const char*>(iniFileContent.get()), iniFileSize);
+			WriteDaemonResponse(pipe, DaemonProtocol::Status::Failure, "Invalid request header");
+			return false;
+		}
 
-			if (!PeepoHappy::UTF8::AppearsToUse8BitCodeUnits(iniFileStringView.substr(0, std::min<size_t>(32, iniFileStringView.size()))))
-				fprintf(stderr, "INI file does not appear to be UTF-8 encoded\n");
+		std::string text(header.TextSize, '\0');
+		auto payload = (header.PayloadSize > 0) ? PeepoHappy::Memory::MakeTrackedBuffer(header.PayloadSize) : nullptr;
+		if (!pipe.ReadExact(text.data(), text.size()) || !pipe.ReadExact(payload.get(), header.PayloadSize))
+			return false;
 
-			PeepoHappy::IO::ParseIniFileContent(iniFileStringView, [&namedKeys](std::string_view iniSection, std::string_view iniKey, std::string_view iniValue)
-			{
-				if (iniSection == "datatable_keys")
-				{
-					NamedEncryptionKey newKey;
-					newKey.Name = iniKey;
-					newKey.Key128 = PeepoHappy::Crypto::ParseAes128KeyHexByteString(iniValue);
-					newKey.Key256 = PeepoHappy::Crypto::ParseAes256KeyHexByteString(iniValue);
+		if (header.EncryptionIVMode >= static_cast<u32>(IVMode::Count))
+			return WriteDaemonResponse(pipe, DaemonProtocol::Status::Failure, "Unknown IV mode");
 
-					const bool upperHalfOf256KeyAllZeros = std::all_of(newKey.Key256.begin() + (PeepoHappy::Crypto::Aes256KeySize / 2), newKey.Key256.end(), [](u8 byte) { return byte == 0x00; });
-					newKey.KeyByteSize = upperHalfOf256KeyAllZeros ? PeepoHappy::Crypto::Aes128KeySize : PeepoHappy::Crypto::Aes256KeySize;
+		JsonToBinConversionOptions conversionOptions = baseConversionOptions;
+		conversionOptions.EncryptionIVMode = static_cast<IVMode>(header.EncryptionIVMode);
 
-					namedKeys.push_back(std::move(newKey));
-				}
-			});
+		switch (header.RequestOperation)
+		{
+		case DaemonProtocol::Operation::ConvertFile:
+		{
+			if (ConvertInputFile(text, namedKeys, conversionOptions, nullptr, &reusableDeflater) != EXIT_WIDEPEEPOHAPPY)
+				return WriteDaemonResponse(pipe, DaemonProtocol::Status::Failure, "Failed to convert input file (see server output for details)");
+			return WriteDaemonResponse(pipe, DaemonProtocol::Status::Success, "");
+		}
+		case DaemonProtocol::Operation::EncodeBuffer:
+		{
+			const NamedEncryptionKey* key = text.empty() ? nullptr : FindNamedEncryptionKey(namedKeys, text);
+			if (!text.empty() && key == nullptr)
+				return WriteDaemonResponse(pipe, DaemonProtocol::Status::Failure, "Unknown key name");
+			if (header.PayloadSize == 0)
+				return WriteDaemonResponse(pipe, DaemonProtocol::Status::Failure, "Empty input JSON");
+			if ((header.PayloadSize + PeepoHappy::Crypto::AesIVSize) >= MaxDecompressedGameDataTableFileSize)
+				return WriteDaemonResponse(pipe, DaemonProtocol::Status::Failure, "Input JSON too large");
 
-			if (namedKeys.empty())
-				fprintf(stderr, "No encrpytion key definition(s) found\n");
+			const EncodedBinFile binFile = CompressAndEncryptJsonFileContent(payload.get(), header.PayloadSize, key, conversionOptions.EncryptionIVMode, "", &reusableDeflater);
+			if (binFile.Content == nullptr)
+				return WriteDaemonResponse(pipe, DaemonProtocol::Status::Failure, "Failed to compress and encrypt JSON");
+			return WriteDaemonResponse(pipe, DaemonProtocol::Status::Success, "", binFile.Content, binFile.Size);
 		}
-		else
+		case DaemonProtocol::Operation::DecodeBuffer:
 		{
-			fprintf(stderr, "Failed to read '%.*s'\n", static_cast<int>(EncrpytionKeysIniFileName.size()), EncrpytionKeysIniFileName.data());
+			const DecodedJsonFile jsonFile = DecryptAndDecompressBinFileContent(payload.get(), header.PayloadSize, namedKeys);
+			if (jsonFile.Json.empty())
+				return WriteDaemonResponse(pipe, DaemonProtocol::Status::Failure, "Failed to decrypt and decompress input");
+			return WriteDaemonResponse(pipe, DaemonProtocol::Status::Success, (jsonFile.Key != nullptr) ? jsonFile.Key->Name : "", reinterpret_cast<const u8*>(jsonFile.Json.data()), jsonFile.Json.size());
+		}
+		case DaemonProtocol::Operation::Shutdown:
+		{
+			outShutdownRequested = true;
+			WriteDaemonResponse(pipe, DaemonProtocol::Status::Success, "");
+			return false;
+		}
+		default:
+		{
+			return WriteDaemonResponse(pipe, DaemonProtocol::Status::Failure, "Unknown operation");
+		}
 		}
-
-		outIniFileContent = std::move(iniFileContent);
-		return namedKeys;
 	}
 
-	// NOTE: { "datatable/musicinfo.bin", NamedKey{"jp_ver169", ...} } -> "datatable/musicinfo jp_ver169.json"
-	std::string FormatJsonOutputFilePathUsingNamedKey(std::string_view binFilePath, const NamedEncryptionKey* key)
+	// NOTE: Every worker thread serves its own instance of the named pipe (one client at a time) using its own zlib deflate stream and expanded AES keys,
+	//		 so that none of the startup costs (parsing the keys, expanding key schedules and allocating zlib state) are paid more than once per worker
+	int ServeDaemonRequestsUntilShutdown(const CommandLineOptions& options, const std::vector<NamedEncryptionKey>& namedKeys)
 	{
-		std::string formattedFilePath { PeepoHappy::Path::TrimFileExtension(binFilePath) };
-		if (key != nullptr && !key->Name.empty())
+		const u32 workerCount = (options.ThreadCount > 0) ? options.ThreadCount : PeepoHappy::Threading::GetHardwareThreadCount();
+
+		std::unique_ptr<OutputCache> cache = nullptr;
+		JsonToBinConversionOptions baseConversionOptions = {};
+		if (!options.CacheDirectoryPath.empty())
 		{
-			formattedFilePath += " ";
-			formattedFilePath += key->Name;
+			cache = std::make_unique<OutputCache>(options.CacheDirectoryPath, options.CacheMaxByteSize);
+			baseConversionOptions.Cache = cache.get();
 		}
-		formattedFilePath += ".json";
-		return formattedFilePath;
-	}
 
-	// NOTE: ("datatable/musicinfo jp_ver169.json") -> { "datatable/musicinfo.bin", NamedKey{"jp_ver169", ...} } 
-	std::pair<std::string, const NamedEncryptionKey*> ParseJsonInputFilePathUsingNamedKeysAndFormatBinOutputFilePath(std::string_view jsonFilePath, const std::vector<NamedEncryptionKey>& namedKeys)
-	{
-		const auto fileNameWithoutExtension = PeepoHappy::Path::GetFileName(jsonFilePath, false);
-		const auto filePathWithoutExtension = PeepoHappy::Path::TrimFileExtension(jsonFilePath);
+		std::atomic<bool> shutdownRequested = false;
+		std::atomic<u32> failedWorkerCount = 0;
 
-		for (const auto& namedKey : namedKeys)
+		std::mutex exitMutex;
+		std::condition_variable exitCondition;
+		u32 exitedWorkerCount = 0;
+
+		auto serveClientsUntilShutdown = [&]()
 		{
-			if (PeepoHappy::ASCII::EndsWithInsensitive(fileNameWithoutExtension, namedKey.Name))
+			PeepoHappy::IO::NamedPipe pipe;
+			if (!pipe.Create(options.PipeName))
 			{
-				const auto filePathWithoutKeySuffix = PeepoHappy::ASCII::TrimRight(filePathWithoutExtension.substr(0, filePathWithoutExtension.size() - namedKey.Name.size()));
-				return { std::string(filePathWithoutKeySuffix) + ".bin", &namedKey };
+				fprintf(stderr, "Failed to create named pipe instance\n");
+				failedWorkerCount++;
+				return;
 			}
-		}
-		return { std::string(PeepoHappy::Path::TrimFileExtension(jsonFilePath)) + ".bin", nullptr };
-	}
 
-	const NamedEncryptionKey* TryOutAllAvailableEncrpytionKeysUntilGZipHeaderIsFound(const u8* encryptedFileContent, size_t fileSize, PeepoHappy::Crypto::AesIVBytes iv, const std::vector<NamedEncryptionKey>& namedKeys)
-	{
-		std::array<u8, 16> decryptedHeaderBuffer = {};
-		if (fileSize <= decryptedHeaderBuffer.size())
+			PeepoHappy::Compression::Deflater reusableDeflater;
+			while (!shutdownRequested)
+			{
+				if (!pipe.WaitForClient())
+				{
+					if (shutdownRequested)
+						break;
+
+					fprintf(stderr, "Failed to wait for client\n");
+					failedWorkerCount++;
+					return;
+				}
+
+				while (!shutdownRequested && ServeDaemonRequest(pipe, namedKeys, baseConversionOptions, reusableDeflater, shutdownRequested))
+					continue;
+
+				pipe.DisconnectClient();
+			}
+
+			// NOTE: Wake up all other workers still waiting for a client so that they get to see the shutdown request too
+			for (u32 i = 0; i < workerCount; i++)
+			{
+				PeepoHappy::IO::NamedPipe wakeUpPipe;
+				wakeUpPipe.Connect(options.PipeName, 0);
+			}
+		};
+
+		auto workerFunc = [&]()
 		{
-			fprintf(stderr, "Unexpected end of encrypted file\n");
-			return nullptr;
-		}
+			serveClientsUntilShutdown();
+
+			std::scoped_lock lock(exitMutex);
+			exitedWorkerCount++;
+			exitCondition.notify_all();
+		};
+
+		printf("Serving conversion requests on '\\\\.\\pipe\\%.*s' using %u worker thread(s)...\n", static_cast<int>(options.PipeName.size()), options.PipeName.data(), workerCount);
 
-		// NOTE: ~~Backwards because newer version keys which are more likely to be used are most likely defined last~~
-		//		 turns out everyone already got into the habbit of placing new ones at the top
-		for (const NamedEncryptionKey& namedKey : namedKeys)
+		std::vector<std::thread> workerThreads;
+		workerThreads.reserve(workerCount);
+		for (u32 i = 0; i < workerCount; i++)
+			workerThreads.emplace_back(workerFunc);
+
+		// NOTE: Workers connected to an idle client are stuck inside a blocking read and would never get to see the shutdown request on their own,
+		//		 so once it has been received their reads are cancelled. This is repeated until all of them have exited
+		//		 because a worker might only have been about to start its next read at the time it was cancelled
 		{
-			decryptedHeaderBuffer = {};
-			if (!DecryptUsingNamedKey(namedKey, encryptedFileContent, decryptedHeaderBuffer.data(), decryptedHeaderBuffer.size(), iv))
+			std::unique_lock lock(exitMutex);
+			while (exitedWorkerCount < workerCount)
 			{
-				fprintf(stderr, "Failed to decrypt input file header\n");
-				return nullptr;
+				if (shutdownRequested)
+				{
+					for (auto& workerThread : workerThreads)
+						PeepoHappy::Threading::CancelBlockingIO(workerThread);
+				}
+				exitCondition.wait_for(lock, std::chrono::milliseconds(shutdownRequested ? 10 : 250));
 			}
+		}
 
-			if (PeepoHappy::Compression::HasValidGZipHeader(decryptedHeaderBuffer.data(), decryptedHeaderBuffer.size()))
-				return &namedKey;
+		for (auto& workerThread : workerThreads)
+			workerThread.join();
+
+		if (cache != nullptr)
+		{
+			cache->EvictLeastRecentlyUsed();
+			cache->PrintSummary();
 		}
 
-		return nullptr;
+		return (failedWorkerCount == 0) ? EXIT_WIDEPEEPOHAPPY : EXIT_WIDEPEEPOSAD;
 	}
 
-	bool DecompressAndWriteDataTableJsonFile(const u8* compressedData, size_t compressedDataSize, std::string_view jsonOutputFilePath)
+	int SendDaemonRequest(PeepoHappy::IO::NamedPipe& pipe, DaemonProtocol::Operation operation, IVMode ivMode, std::string_view text)
 	{
-		auto decompressedBuffer = std::make_unique<u8[]>(MaxDecompressedGameDataTableFileSize);
-		if (!PeepoHappy::Compression::Inflate(compressedData, compressedDataSize, decompressedBuffer.get(), MaxDecompressedGameDataTableFileSize))
+		DaemonProtocol::RequestHeader header = {};
+		header.Magic = DaemonProtocol::RequestMagic;
+		header.Version = DaemonProtocol::Version;
+		header.RequestOperation = operation;
+		header.EncryptionIVMode = static_cast<u32>(ivMode);
+		header.TextSize = static_cast<u32>(text.size());
+		header.PayloadSize = 0;
+
+		DaemonProtocol::ResponseHeader response = {};
+		if (!pipe.WriteAll(&header, sizeof(header)) || !pipe.WriteAll(text.data(), text.size()) || !pipe.ReadExact(&response, sizeof(response)) || response.Magic != DaemonProtocol::ResponseMagic)
 		{
-			fprintf(stderr, "Failed to decompress input file\n");
-			return false;
+			fprintf(stderr, "Lost connection to server\n");
+			return EXIT_WIDEPEEPOSAD;
 		}
 
-		const size_t jsonLength = strnlen(reinterpret_cast<const char*>(decompressedBuffer.get()), MaxDecompressedGameDataTableFileSize);
-		const std::string_view jsonString = std::string_view(reinterpret_cast<const char*>(decompressedBuffer.get()), jsonLength);
-
-		if (jsonLength <= 0)
+		std::string responseText(std::min(response.TextSize, DaemonProtocol::MaxTextSize), '\0');
+		if (!pipe.ReadExact(responseText.data(), responseText.size()) || response.PayloadSize > 0)
 		{
-			fprintf(stderr, "Empty json... did decompression fail?\n");
-			return false;
+			fprintf(stderr, "Unexpected response from server\n");
+			return EXIT_WIDEPEEPOSAD;
 		}
 
-		if (!PeepoHappy::IO::WriteEntireFile(jsonOutputFilePath, reinterpret_cast<const u8*>(jsonString.data()), jsonString.size()))
+		if (response.ResponseStatus != DaemonProtocol::Status::Success)
 		{
-			fprintf(stderr, "Failed to write JSON output file\n");
-			return false;
+			fprintf(stderr, "%.*s: %s\n", static_cast<int>(text.size()), text.data(), responseText.c_str());
+			return EXIT_WIDEPEEPOSAD;
 		}
 
-		return true;
+		return EXIT_WIDEPEEPOHAPPY;
 	}
 
-	int ReadAndWriteEncryptedAndOrCompressedBinToJsonFile(std::string_view binInputFilePath, const std::vector<NamedEncryptionKey>& namedKeys)
+	// NOTE: Forwards all input files to a running server over a single connection instead of converting them in this process
+	int SendAllInputFilesToDaemon(const CommandLineOptions& options)
 	{
-		const auto[binFileContent, binFileSize] = PeepoHappy::IO::ReadEntireFile(binInputFilePath);
-		if (binFileContent == nullptr)
+		constexpr u32 connectTimeoutMilliseconds = 5000;
+
+		PeepoHappy::IO::NamedPipe pipe;
+		if (!pipe.Connect(options.PipeName, connectTimeoutMilliseconds))
 		{
-			fprintf(stderr, "Failed to read input file\n");
+			fprintf(stderr, "Failed to connect to server '%.*s'. Is it running?\n", static_cast<int>(options.PipeName.size()), options.PipeName.data());
 			return EXIT_WIDEPEEPOSAD;
 		}
-		else if (binFileSize <= 10)
+
+		int exitCode = EXIT_WIDEPEEPOHAPPY;
+		for (const std::string_view inputFilePath : options.InputPaths)
 		{
-			fprintf(stderr, "Unexpected end of file\n");
-			return EXIT_WIDEPEEPOSAD;
+			// NOTE: The server might be running inside a different working directory
+			if (SendDaemonRequest(pipe, DaemonProtocol::Operation::ConvertFile, options.EncryptionIVMode, PeepoHappy::IO::GetFullPath(inputFilePath)) != EXIT_WIDEPEEPOHAPPY)
+				exitCode = EXIT_WIDEPEEPOSAD;
 		}
 
-		if (binFileSize >= MaxDecompressedGameDataTableFileSize)
+		if (options.ShutdownServer && SendDaemonRequest(pipe, DaemonProtocol::Operation::Shutdown, IVMode::Constant, "") != EXIT_WIDEPEEPOHAPPY)
+			exitCode = EXIT_WIDEPEEPOSAD;
+
+		return exitCode;
+	}
+
+	struct DataTableVerificationResult
+	{
+		size_t FileSize;
+		size_t DecompressedSize;
+		const NamedEncryptionKey* Key;
+		const char* ErrorMessage;
+	};
+
+	// NOTE: Runs the exact same key detection + decryption + decompression steps as the .bin -> .json conversion
+	//		 but discards the decompressed output, requiring a fully valid GZip stream (end of stream + CRC32) to succeed
+	DataTableVerificationResult VerifyDataTableBinFile(std::string_view binInputFilePath, const std::vector<NamedEncryptionKey>& namedKeys)
+	{
+		DataTableVerificationResult result = {};
+
+		const auto[binFileContent, binFileSize] = Statistics::TimeStage(Statistics::Stage::Read, PeepoHappy::IO::ReadEntireFile, binInputFilePath);
+		result.FileSize = binFileSize;
+
+		if (binFileContent == nullptr)
 		{
-			fprintf(stderr, "Input file too large. DataTable files are limited to %zu bytes\n", MaxDecompressedGameDataTableFileSize);
-			return EXIT_WIDEPEEPOSAD;
+			result.ErrorMessage = "Failed to read input file";
+			return result;
 		}
-
-		if (PeepoHappy::Compression::HasValidGZipHeader(binFileContent.get(), binFileSize))
+		else if (binFileSize <= 10)
 		{
-			printf("Input file not encrypted. This should still work fine but likely means the file comes from either an earlier version or different game\n");
-			if (!DecompressAndWriteDataTableJsonFile(binFileContent.get(), binFileSize, FormatJsonOutputFilePathUsingNamedKey(binInputFilePath, nullptr)))
-				return EXIT_WIDEPEEPOSAD;
+			result.ErrorMessage = "Unexpected end of file";
+			return result;
 		}
-		else
+		else if (binFileSize >= MaxDecompressedGameDataTableFileSize)
+		{
+			result.ErrorMessage = "Input file too large";
+			return result;
+		}
+
+		const u8* compressedData = binFileContent.get();
+		size_t compressedDataSize = binFileSize;
+		PeepoHappy::Memory::TrackedBuffer decryptedBuffer = nullptr;
+
+		if (!PeepoHappy::Compression::HasValidGZipHeader(binFileContent.get(), binFileSize))
 		{
 			PeepoHappy::Crypto::AesIVBytes iv = {};
 			memcpy(iv.data(), binFileContent.get(), iv.size());
@@ -203,95 +2247,431 @@ namespace TaikoSwitchDataTableDecryptor
 			const size_t binFileSizeWithoutIV = (binFileSize - iv.size());
 			const u8* binFileContentWithoutIV = (binFileContent.get() + iv.size());
 
-			const NamedEncryptionKey* foundNamedKey = TryOutAllAvailableEncrpytionKeysUntilGZipHeaderIsFound(binFileContentWithoutIV, binFileSizeWithoutIV, iv, namedKeys);
-			if (foundNamedKey == nullptr)
+			result.Key = TryOutAllAvailableEncrpytionKeysUntilGZipHeaderIsFound(binFileContentWithoutIV, binFileSizeWithoutIV, iv, namedKeys);
+			if (result.Key == nullptr)
 			{
-				printf("No matching encrpytion key definition found for input file\n");
-				return EXIT_WIDEPEEPOSAD;
+				result.ErrorMessage = "No matching encrpytion key definition found";
+				return result;
 			}
 
-			auto decryptedBuffer = std::make_unique<u8[]>(binFileSizeWithoutIV);
-			if (!DecryptUsingNamedKey(*foundNamedKey, binFileContentWithoutIV, decryptedBuffer.get(), binFileSizeWithoutIV, iv))
-				fprintf(stderr, "Failed to decrypt input file\n");
+			decryptedBuffer = PeepoHappy::Memory::MakeTrackedBuffer(binFileSizeWithoutIV);
+			if (!Statistics::TimeStage(Statistics::Stage::Decrypt, DecryptUsingNamedKey, *result.Key, binFileContentWithoutIV, decryptedBuffer.get(), binFileSizeWithoutIV, iv))
+			{
+				result.ErrorMessage = "Failed to decrypt input file";
+				return result;
+			}
 
-			if (!DecompressAndWriteDataTableJsonFile(decryptedBuffer.get(), binFileSizeWithoutIV, FormatJsonOutputFilePathUsingNamedKey(binInputFilePath, foundNamedKey)))
-				return EXIT_WIDEPEEPOSAD;
+			compressedData = decryptedBuffer.get();
+			compressedDataSize = binFileSizeWithoutIV;
 		}
 
-		return EXIT_WIDEPEEPOHAPPY;
+		const bool inflateSuccessful = Statistics::TimeStage(Statistics::Stage::Inflate, PeepoHappy::Compression::InflateStreamed, compressedData, compressedDataSize, [](const u8*, size_t) {}, &result.DecompressedSize);
+
+		if (auto* stats = Statistics::ThisThreadFileStatistics; stats != nullptr)
+		{
+			stats->BytesIn = result.FileSize;
+			stats->CompressedBytes = compressedDataSize;
+			stats->DecompressedBytes = result.DecompressedSize;
+		}
+
+		if (!inflateSuccessful)
+		{
+			result.ErrorMessage = "Failed to decompress input file (missing end of stream or CRC mismatch)";
+			return result;
+		}
+
+		if (result.DecompressedSize <= 0)
+			result.ErrorMessage = "Empty json... did decompression fail?";
+		else if (result.DecompressedSize > MaxDecompressedGameDataTableFileSize)
+			result.ErrorMessage = "Decompressed file too large";
+
+		return result;
 	}
 
-	int ReadAndWriteJsonToCompressedAndOrEncryptedBinFile(std::string_view jsonInputFilePath, const std::vector<NamedEncryptionKey>& namedKeys)
+	int VerifyAllDataTableBinFiles(const std::vector<std::string>& binInputFilePaths, const std::vector<NamedEncryptionKey>& namedKeys, u32 threadCount, u64 memoryBudget)
 	{
-		const auto[jsonFileContent, jsonFileSize] = PeepoHappy::IO::ReadEntireFile(jsonInputFilePath);
-		if (jsonFileContent == nullptr)
+		if (binInputFilePaths.empty())
 		{
-			fprintf(stderr, "Failed to read input file\n");
+			fprintf(stderr, "No '.bin' input files found\n");
 			return EXIT_WIDEPEEPOSAD;
 		}
-		else if ((jsonFileSize + PeepoHappy::Crypto::AesIVSize) >= MaxDecompressedGameDataTableFileSize)
+
+		std::vector<DataTableVerificationResult> results(binInputFilePaths.size());
+
+		std::vector<u64> estimatedMemoryUsages;
+		estimatedMemoryUsages.reserve(binInputFilePaths.size());
+		for (const std::string& binInputFilePath : binInputFilePaths)
+			estimatedMemoryUsages.push_back(EstimatePeakMemoryUsage(binInputFilePath));
+
+		const auto startTime = std::chrono::steady_clock::now();
+		PeepoHappy::Threading::BudgetedParallelForEachIndex(estimatedMemoryUsages, (threadCount > 0) ? threadCount : PeepoHappy::Threading::GetHardwareThreadCount(), memoryBudget, [&](size_t index)
 		{
-			fprintf(stderr, "Input file too large. DataTable files are limited to %zu bytes\n", MaxDecompressedGameDataTableFileSize);
-			return EXIT_WIDEPEEPOSAD;
+			Statistics::ScopedFileStatistics scopedFileStatistics(Statistics::BeginFile(binInputFilePaths[index]));
+			results[index] = VerifyDataTableBinFile(binInputFilePaths[index], namedKeys);
+		});
+		const auto elapsedSeconds = std::chrono::duration<f64>(std::chrono::steady_clock::now() - startTime).count();
+
+		size_t failedCount = 0, totalFileSize = 0, totalDecompressedSize = 0;
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const auto& result = results[i];
+			const auto keyName = (result.Key != nullptr) ? result.Key->Name : std::string_view("unencrypted");
+
+			if (result.ErrorMessage == nullptr)
+				printf("[OK]   %s (%.*s, %zu -> %zu bytes)\n", binInputFilePaths[i].c_str(), static_cast<int>(keyName.size()), keyName.data(), result.FileSize, result.DecompressedSize);
+			else
+				printf("[FAIL] %s (%s)\n", binInputFilePaths[i].c_str(), result.ErrorMessage);
+
+			failedCount += (result.ErrorMessage != nullptr);
+			totalFileSize += result.FileSize;
+			totalDecompressedSize += result.DecompressedSize;
 		}
 
+		const f64 megabytesPerSecond = (elapsedSeconds > 0.0) ? (static_cast<f64>(totalFileSize) / (1024.0 * 1024.0) / elapsedSeconds) : 0.0;
+		printf("\n");
+		printf("Verified %zu file(s), %zu passed, %zu failed\n", results.size(), results.size() - failedCount, failedCount);
+		printf("Read %zu bytes, decompressed %zu bytes in %.3f seconds (%.2f MB/s)\n", totalFileSize, totalDecompressedSize, elapsedSeconds, megabytesPerSecond);
 
-		auto singleAllocationCombinedBuffers = std::make_unique<u8[]>(MaxDecompressedGameDataTableFileSize * 2);
-		u8* compressedBuffer = (singleAllocationCombinedBuffers.get() + 0);
-		u8* encryptedBufferWithIV = (singleAllocationCombinedBuffers.get() + MaxDecompressedGameDataTableFileSize);
-		u8* encryptedBuffer = (encryptedBufferWithIV + PeepoHappy::Crypto::AesIVSize);
+		return (failedCount == 0) ? EXIT_WIDEPEEPOHAPPY : EXIT_WIDEPEEPOSAD;
+	}
 
-		const size_t compressedSize = PeepoHappy::Compression::Deflate(jsonFileContent.get(), jsonFileSize, compressedBuffer, MaxDecompressedGameDataTableFileSize);
-		const size_t alignedSize = PeepoHappy::Crypto::Align(compressedSize, PeepoHappy::Crypto::AesBlockAlignment);
-		const size_t alignedSizeWithIV = (alignedSize + PeepoHappy::Crypto::AesIVSize);
-		const size_t numberOfAlignmentBytesAdded = (alignedSize - compressedSize);
+	// NOTE: Directories are searched recursively for files with a matching extension, regular file paths are taken as is
+	std::vector<std::string> GatherInputFilePaths(const std::vector<std::string_view>& inputPaths, std::string_view fileExtension)
+	{
+		std::vector<std::string> filePaths;
+		for (const std::string_view inputPath : inputPaths)
+		{
+			if (PeepoHappy::IO::DirectoryExists(inputPath))
+			{
+				PeepoHappy::IO::ForEachFileInDirectory(inputPath, [&](std::string_view filePath)
+				{
+					if (PeepoHappy::Path::HasFileExtension(filePath, fileExtension))
+						filePaths.emplace_back(filePath);
+				});
+			}
+			else
+			{
+				filePaths.emplace_back(inputPath);
+			}
+		}
+		return filePaths;
+	}
 
-		if (compressedSize <= 0)
+	// NOTE: Decodes every .bin input file (or every one found inside an input directory) and takes every .json input file as is,
+	//		 adding all of them as the tables of a single version to the chunk store. Adding a version a second time replaces it
+	int AddInputFilesToChunkStore(const CommandLineOptions& options, const std::vector<NamedEncryptionKey>& namedKeys)
+	{
+		if (options.StoreDirectoryPath.empty() || options.VersionName.empty() || options.InputPaths.empty())
 		{
-			fprintf(stderr, "Failed to compress JSON file\n");
+			fprintf(stderr, "Expected a '--store' directory, a version '--name' and input files or directories\n");
 			return EXIT_WIDEPEEPOSAD;
 		}
 
-		const auto[binOutputFilePath, keyUsedForInitialDecrpytion] = ParseJsonInputFilePathUsingNamedKeysAndFormatBinOutputFilePath(jsonInputFilePath, namedKeys);
-		if (keyUsedForInitialDecrpytion == nullptr)
+		const std::vector<std::string> inputFilePaths = GatherInputFilePaths(options.InputPaths, ".bin");
+		std::vector<ChunkStoreTable> tables(inputFilePaths.size());
+		std::vector<bool> tablesAdded(inputFilePaths.size(), false);
+
+		ChunkStore store(options.StoreDirectoryPath);
+		std::atomic<size_t> failedCount = 0;
+		const u32 threadCount = (options.ThreadCount > 0) ? options.ThreadCount : PeepoHappy::Threading::GetHardwareThreadCount();
+
+		PeepoHappy::Threading::ParallelForEachIndex(inputFilePaths.size(), threadCount, [&](size_t index)
 		{
-			printf("No known encrpytion key signature found in input file name. Output file will not be encrpyted\n");
-			if (!PeepoHappy::IO::WriteEntireFile(binOutputFilePath, compressedBuffer, compressedSize))
+			const std::string& inputFilePath = inputFilePaths[index];
+			Statistics::ScopedFileStatistics scopedFileStatistics(Statistics::BeginFile(inputFilePath));
+
+			auto[inputFileContent, inputFileSize] = Statistics::TimeStage(Statistics::Stage::Read, PeepoHappy::IO::ReadEntireFile, inputFilePath);
+			if (inputFileContent == nullptr)
 			{
-				fprintf(stderr, "Failed to write compressed output file\n");
-				return EXIT_WIDEPEEPOSAD;
+				fprintf(stderr, "Failed to read input file '%s'\n", inputFilePath.c_str());
+				failedCount++;
+				return;
+			}
+
+			std::string tableName;
+			DecodedJsonFile jsonFile = {};
+			if (PeepoHappy::Path::HasFileExtension(inputFilePath, ".json"))
+			{
+				tableName = PeepoHappy::Path::GetFileName(inputFilePath);
+				jsonFile.Json = std::string_view(reinterpret_cast<const char*>(inputFileContent.get()), inputFileSize);
+				jsonFile.OwningBuffer = std::move(inputFileContent);
+			}
+			else
+			{
+				jsonFile = DecryptAndDecompressBinFileContent(inputFileContent.get(), inputFileSize, namedKeys);
+				tableName = PeepoHappy::Path::GetFileName(FormatJsonOutputFilePathUsingNamedKey(inputFilePath, jsonFile.Key));
+			}
+
+			if (jsonFile.Json.empty())
+			{
+				fprintf(stderr, "Failed to decode '%s'\n", inputFilePath.c_str());
+				failedCount++;
+				return;
+			}
+
+			if (!Statistics::TimeStage(Statistics::Stage::Write, [&]() { return store.AddTable(tableName, reinterpret_cast<const u8*>(jsonFile.Json.data()), jsonFile.Json.size(), tables[index]); }))
+			{
+				fprintf(stderr, "Failed to add '%s' to the chunk store\n", inputFilePath.c_str());
+				failedCount++;
+				return;
+			}
+			tablesAdded[index] = true;
+		});
+
+		// NOTE: Tables are identified by their name alone, so input files from different directories sharing the same name can't be stored together
+		std::vector<ChunkStoreTable> addedTables;
+		std::map<std::string_view, size_t> tableIndicesByName;
+		for (size_t i = 0; i < tables.size(); i++)
+		{
+			if (!tablesAdded[i])
+				continue;
+
+			if (const auto[existing, inserted] = tableIndicesByName.emplace(tables[i].Name, i); !inserted)
+			{
+				fprintf(stderr, "Duplicate table name '%s'\n", tables[i].Name.c_str());
+				failedCount++;
+				continue;
 			}
+			addedTables.push_back(tables[i]);
 		}
-		else
+
+		// NOTE: A version missing some of its tables would look complete to anyone extracting it later on, so none is saved at all.
+		//		 The chunks already added are harmless and simply reused by the next attempt
+		if (failedCount > 0)
+		{
+			fprintf(stderr, "%zu table(s) failed, version '%.*s' has not been saved\n", failedCount.load(), static_cast<int>(options.VersionName.size()), options.VersionName.data());
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		if (!store.SaveVersion(options.VersionName, addedTables))
 		{
-			assert(compressedSize < MaxDecompressedGameDataTableFileSize && "The compressed data could technically be larger... but that seems highly unlikely for plain text JSON");
-			assert((alignedSize + PeepoHappy::Crypto::AesIVSize) <= MaxDecompressedGameDataTableFileSize);
+			fprintf(stderr, "Failed to save version '%.*s'\n", static_cast<int>(options.VersionName.size()), options.VersionName.data());
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		printf("Stored %zu table(s) as version '%.*s'\n", addedTables.size(), static_cast<int>(options.VersionName.size()), options.VersionName.data());
+		store.PrintSummary();
+		return EXIT_WIDEPEEPOHAPPY;
+	}
+
+	// NOTE: Reconstructs every table of a stored version from its chunks, without having to decrypt or decompress any of the original .bin files again
+	int ExtractVersionFromChunkStore(const CommandLineOptions& options)
+	{
+		if (options.StoreDirectoryPath.empty() || options.VersionName.empty())
+		{
+			fprintf(stderr, "Expected a '--store' directory and a version '--name'\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		ChunkStore store(options.StoreDirectoryPath);
+		std::vector<ChunkStoreTable> tables;
+		if (!store.LoadVersion(options.VersionName, tables))
+		{
+			fprintf(stderr, "Failed to load version '%.*s'\n", static_cast<int>(options.VersionName.size()), options.VersionName.data());
+			return EXIT_WIDEPEEPOSAD;
+		}
+
+		const std::string_view outputDirectoryPath = !options.OutputPath.empty() ? options.OutputPath : options.VersionName;
+		if (!PeepoHappy::IO::CreateDirectoryRecursive(outputDirectoryPath))
+		{
+			fprintf(stderr, "Failed to create output directory\n");
+			return EXIT_WIDEPEEPOSAD;
+		}
 
-			constexpr PeepoHappy::Crypto::AesIVBytes dummyIV = { 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC };
-			memcpy(encryptedBufferWithIV, dummyIV.data(), dummyIV.size());
+		std::atomic<size_t> failedCount = 0;
+		const u32 threadCount = (options.ThreadCount > 0) ? options.ThreadCount : PeepoHappy::Threading::GetHardwareThreadCount();
+
+		PeepoHappy::Threading::ParallelForEachIndex(tables.size(), threadCount, [&](size_t index)
+		{
+			const ChunkStoreTable& table = tables[index];
+			Statistics::ScopedFileStatistics scopedFileStatistics(Statistics::BeginFile(table.Name));
 
-#if 1 // HACK: Manually add PKCS7 padding (?)
-			if (keyUsedForInitialDecrpytion->KeyByteSize == keyUsedForInitialDecrpytion->Key256.size())
+			// NOTE: The version file might not have been written by this program, table names must never point outside of the output directory
+			if (PeepoHappy::Path::GetFileName(table.Name) != table.Name || !IsSafeRelativeOutputPath(table.Name))
 			{
-				for (size_t i = 0; i < numberOfAlignmentBytesAdded; i++)
-					compressedBuffer[compressedSize + i] = static_cast<u8>(numberOfAlignmentBytesAdded);
+				fprintf(stderr, "Skipping table with unsafe name '%s'\n", table.Name.c_str());
+				failedCount++;
+				return;
 			}
-#endif
 
-			if (!EncryptUsingNamedKey(*keyUsedForInitialDecrpytion, compressedBuffer, encryptedBuffer, alignedSize, dummyIV))
+			const auto[tableContent, tableSize] = Statistics::TimeStage(Statistics::Stage::Read, [&]() { return store.ReconstructTable(table); });
+			if (tableContent == nullptr)
 			{
-				fprintf(stderr, "Failed to encrypt JSON file\n");
-				return EXIT_WIDEPEEPOSAD;
+				fprintf(stderr, "Failed to reconstruct table '%s'\n", table.Name.c_str());
+				failedCount++;
+				return;
 			}
 
-			if (!PeepoHappy::IO::WriteEntireFile(binOutputFilePath, encryptedBufferWithIV, alignedSizeWithIV))
+			const std::string outputFilePath = std::string(outputDirectoryPath) + "/" + table.Name;
+			if (!Statistics::TimeStage(Statistics::Stage::Write, PeepoHappy::IO::WriteEntireFile, outputFilePath, tableContent.get(), tableSize))
 			{
-				fprintf(stderr, "Failed to write encrypted output file\n");
-				return EXIT_WIDEPEEPOSAD;
+				fprintf(stderr, "Failed to write '%s'\n", outputFilePath.c_str());
+				failedCount++;
 			}
+		});
+
+		printf("Extracted %zu table(s) of version '%.*s'\n", (tables.size() - failedCount), static_cast<int>(options.VersionName.size()), options.VersionName.data());
+		return (failedCount == 0) ? EXIT_WIDEPEEPOHAPPY : EXIT_WIDEPEEPOSAD;
+	}
+
+	// NOTE: Compares every .bin file of the old directory against the .bin file at the same relative path inside of the new directory (or the two input files directly).
+	//		 Each pair is decoded (detecting the key of both sides separately), parsed and diffed on the worker threads, with the report of each table
+	//		 written to stdout as soon as it and every table before it has finished, so that the output order is stable no matter the thread count
+	int DiffDataTableDirectories(const CommandLineOptions& options, const std::vector<NamedEncryptionKey>& namedKeys)
+	{
+		if (options.InputPaths.size() != 2)
+		{
+			fprintf(stderr, "Expected exactly two input directories (or files) to compare\n");
+			return EXIT_WIDEPEEPOSAD;
 		}
 
-		return EXIT_WIDEPEEPOHAPPY;
+		struct TablePair
+		{
+			std::string Name;
+			std::string OldFilePath;
+			std::string NewFilePath;
+		};
+
+		std::vector<TablePair> tablePairs;
+		if (!PeepoHappy::IO::DirectoryExists(options.InputPaths[0]) && !PeepoHappy::IO::DirectoryExists(options.InputPaths[1]))
+		{
+			tablePairs.push_back(TablePair { std::string(PeepoHappy::Path::GetFileName(options.InputPaths[1])), std::string(options.InputPaths[0]), std::string(options.InputPaths[1]) });
+		}
+		else
+		{
+			// NOTE: Input directories are searched recursively, so tables are paired up by their path relative to each input directory
+			//		 instead of their file name alone (which would silently pair up unrelated tables from different subdirectories)
+			std::map<std::string, TablePair, std::less<>> tablePairsByLookupKey;
+			auto addTableFiles = [&](std::string_view directoryPath, bool isNewDirectory)
+			{
+				for (const std::string& filePath : GatherInputFilePaths({ directoryPath }, ".bin"))
+				{
+					const std::string_view relativePath = GetRelativeFilePath(filePath, directoryPath);
+					TablePair& pair = tablePairsByLookupKey[MakeRelativeFilePathLookupKey(relativePath)];
+					std::string& pairFilePath = isNewDirectory ? pair.NewFilePath : pair.OldFilePath;
+
+					if (!pairFilePath.empty())
+					{
+						fprintf(stderr, "Warning: '%s' and '%s' refer to the same table, ignoring the latter\n", pairFilePath.c_str(), filePath.c_str());
+						continue;
+					}
+
+					if (pair.Name.empty())
+					{
+						pair.Name = relativePath;
+						for (char& c : pair.Name)
+							c = (c == '\\') ? '/' : c;
+					}
+					pairFilePath = filePath;
+				}
+			};
+
+			addTableFiles(options.InputPaths[0], false);
+			addTableFiles(options.InputPaths[1], true);
+
+			tablePairs.reserve(tablePairsByLookupKey.size());
+			for (auto& lookupKeyAndPair : tablePairsByLookupKey)
+				tablePairs.push_back(std::move(lookupKeyAndPair.second));
+		}
+
+		enum class TableDiffOutcome : u8 { Unchanged, Changed, Added, Removed, Failed, Count };
+		std::vector<std::string> tableReports(tablePairs.size());
+		std::vector<bool> tableReportsFinished(tablePairs.size(), false);
+		std::array<std::atomic<size_t>, static_cast<size_t>(TableDiffOutcome::Count)> outcomeCounts = {};
+
+		std::mutex reportMutex;
+		size_t nextReportIndex = 0;
+		auto finishTableReport = [&](size_t index)
+		{
+			std::scoped_lock lock(reportMutex);
+			tableReportsFinished[index] = true;
+			for (; nextReportIndex < tablePairs.size() && tableReportsFinished[nextReportIndex]; nextReportIndex++)
+			{
+				fwrite(tableReports[nextReportIndex].data(), sizeof(char), tableReports[nextReportIndex].size(), stdout);
+				tableReports[nextReportIndex] = {};
+			}
+			fflush(stdout);
+		};
+
+		const u32 threadCount = (options.ThreadCount > 0) ? options.ThreadCount : PeepoHappy::Threading::GetHardwareThreadCount();
+		PeepoHappy::Threading::ParallelForEachIndex(tablePairs.size(), threadCount, [&](size_t index)
+		{
+			const TablePair& tablePair = tablePairs[index];
+			std::string& report = tableReports[index];
+
+			const TableDiffOutcome outcome = [&]()
+			{
+				if (tablePair.OldFilePath.empty() || tablePair.NewFilePath.empty())
+				{
+					report.append(tablePair.OldFilePath.empty() ? "+ " : "- ").append(tablePair.Name).append("\n");
+					return tablePair.OldFilePath.empty() ? TableDiffOutcome::Added : TableDiffOutcome::Removed;
+				}
+
+				Statistics::ScopedFileStatistics scopedFileStatistics(Statistics::BeginFile(tablePair.NewFilePath));
+
+				const auto[oldFileContent, oldFileSize] = Statistics::TimeStage(Statistics::Stage::Read, PeepoHappy::IO::ReadEntireFile, tablePair.OldFilePath);
+				const auto[newFileContent, newFileSize] = Statistics::TimeStage(Statistics::Stage::Read, PeepoHappy::IO::ReadEntireFile, tablePair.NewFilePath);
+				if (oldFileContent == nullptr || newFileContent == nullptr)
+				{
+					fprintf(stderr, "Failed to read '%s'\n", (oldFileContent == nullptr) ? tablePair.OldFilePath.c_str() : tablePair.NewFilePath.c_str());
+					return TableDiffOutcome::Failed;
+				}
+
+				// NOTE: Most tables don't change at all between updates, identical .bin files don't need to be decoded in the first place
+				if (oldFileSize == newFileSize && memcmp(oldFileContent.get(), newFileContent.get(), oldFileSize) == 0)
+					return TableDiffOutcome::Unchanged;
+
+				const DecodedJsonFile oldJsonFile = DecryptAndDecompressBinFileContent(oldFileContent.get(), oldFileSize, namedKeys);
+				const DecodedJsonFile newJsonFile = DecryptAndDecompressBinFileContent(newFileContent.get(), newFileSize, namedKeys);
+				if (oldJsonFile.Json.empty() || newJsonFile.Json.empty())
+				{
+					fprintf(stderr, "Failed to decode '%s'\n", oldJsonFile.Json.empty() ? tablePair.OldFilePath.c_str() : tablePair.NewFilePath.c_str());
+					return TableDiffOutcome::Failed;
+				}
+
+				// NOTE: Re-encrypting the same JSON using a different key or IV still changes the entire .bin file
+				if (oldJsonFile.Json == newJsonFile.Json)
+					return TableDiffOutcome::Unchanged;
+
+				JsonValue oldJson = {}, newJson = {};
+				if (!ParseJson(oldJsonFile.Json, oldJson) || !ParseJson(newJsonFile.Json, newJson))
+				{
+					fprintf(stderr, "Failed to parse the JSON of '%s'\n", tablePair.Name.c_str());
+					return TableDiffOutcome::Failed;
+				}
+
+				std::string differences;
+				const size_t differenceCount = DiffJsonValues(oldJson, newJson, differences);
+				if (differenceCount == 0)
+					return TableDiffOutcome::Unchanged;
+
+				char headerBuffer[64];
+				sprintf_s(headerBuffer, " (%zu difference%s)\n", differenceCount, (differenceCount == 1) ? "" : "s");
+				report.append("~ ").append(tablePair.Name).append(headerBuffer);
+
+				for (size_t lineStart = 0; lineStart < differences.size();)
+				{
+					const size_t lineEnd = differences.find('\n', lineStart);
+					report.append("    ").append(differences, lineStart, (lineEnd - lineStart) + 1);
+					lineStart = (lineEnd == std::string::npos) ? differences.size() : (lineEnd + 1);
+				}
+				return TableDiffOutcome::Changed;
+			}();
+
+			outcomeCounts[static_cast<size_t>(outcome)]++;
+			finishTableReport(index);
+		});
+
+		printf("Compared %zu table(s): %zu changed, %zu added, %zu removed, %zu unchanged\n", tablePairs.size(),
+			outcomeCounts[static_cast<size_t>(TableDiffOutcome::Changed)].load(),
+			outcomeCounts[static_cast<size_t>(TableDiffOutcome::Added)].load(),
+			outcomeCounts[static_cast<size_t>(TableDiffOutcome::Removed)].load(),
+			outcomeCounts[static_cast<size_t>(TableDiffOutcome::Unchanged)].load());
+
+		const size_t failedCount = outcomeCounts[static_cast<size_t>(TableDiffOutcome::Failed)];
+		if (failedCount > 0)
+			fprintf(stderr, "Failed to compare %zu table(s)\n", failedCount);
+		return (failedCount == 0) ? EXIT_WIDEPEEPOHAPPY : EXIT_WIDEPEEPOSAD;
 	}
 
 	int EntryPoint()
@@ -307,6 +2687,20 @@ namespace TaikoSwitchDataTableDecryptor
 			printf("Usage:\n");
 			printf("    TaikoSwitchDataTableDecryptor.exe \"{input_datatable_file}.bin\"\n");
 			printf("    TaikoSwitchDataTableDecryptor.exe \"{input_datatable_file} {key_name}.json\"\n");
+			printf("    TaikoSwitchDataTableDecryptor.exe [--verify] [--durable] [--dedup] [--io {blocking|overlapped|threaded}] [--queue-depth {count}] [--io-threads {count}] [--threads {count}] [--memory-budget {megabytes}] [--iv {constant|content|original}] [--manifest \"{manifest_file}.txt\"] [--journal \"{journal_file}.txt\"] [--shards \"{shared_directory}\"] [--shard-size {count}] [--claim-timeout {seconds}] [--cache \"{cache_directory}\"] [--cache-size {megabytes}] [--stats \"{report_file}.json\"] [--trace \"{trace_file}.json\"] \"{input_datatable_file_a}\" \"{input_datatable_file_b}\" ...\n");
+			printf("    TaikoSwitchDataTableDecryptor.exe watch [--debounce {milliseconds}] [--iv {constant|content|original}] [--cache \"{cache_directory}\"] \"{input_json_directory}\"\n");
+			printf("    TaikoSwitchDataTableDecryptor.exe serve [--threads {count}] [--pipe {pipe_name}] [--cache \"{cache_directory}\"]\n");
+			printf("    TaikoSwitchDataTableDecryptor.exe client [--pipe {pipe_name}] [--iv {constant|content|original}] [--shutdown] \"{input_datatable_file_a}\" ...\n");
+			printf("    TaikoSwitchDataTableDecryptor.exe decode [--key {key_name}] < \"{input_datatable_file}.bin\" > \"{output_datatable_file}.json\"\n");
+			printf("    TaikoSwitchDataTableDecryptor.exe encode [--key {key_name}] [--iv {constant|content}] < \"{input_datatable_file}.json\" > \"{output_datatable_file}.bin\"\n");
+			printf("    TaikoSwitchDataTableDecryptor.exe tar [--threads {count}] [--output \"{output_archive_or_directory}\"] [\"{input_archive}.tar\"]\n");
+			printf("    TaikoSwitchDataTableDecryptor.exe romfs [--threads {count}] [--output \"{output_directory}\"] \"{input_romfs_image}.bin\"\n");
+			printf("    TaikoSwitchDataTableDecryptor.exe layeredfs [--threads {count}] [--iv {constant|content|original}] --original \"{original_bin_directory}\" --output \"{layeredfs_datatable_directory}\" \"{input_json_directory}\"\n");
+			printf("    TaikoSwitchDataTableDecryptor.exe store [--threads {count}] --store \"{store_directory}\" --name {version_name} \"{input_datatable_directory}\" ...\n");
+			printf("    TaikoSwitchDataTableDecryptor.exe extract [--threads {count}] --store \"{store_directory}\" --name {version_name} [--output \"{output_directory}\"]\n");
+			printf("    TaikoSwitchDataTableDecryptor.exe diff [--threads {count}] \"{old_datatable_directory}\" \"{new_datatable_directory}\"\n");
+			printf("    TaikoSwitchDataTableDecryptor.exe benchmark [--threads {count}] [--iv {constant|content}] [--baseline \"{baseline_file}.json\"] \"{results_file}.json\"\n");
+			printf("    TaikoSwitchDataTableDecryptor.exe verify [--threads {count}] [--memory-budget {megabytes}] [--stats \"{report_file}.json\"] [--trace \"{trace_file}.json\"] \"{input_datatable_file_or_directory}\" ...\n");
 			printf("\n");
 			printf("Notes:\n");
 			printf("    The '%.*s' file defines a set of known encrpytion keys.\n", static_cast<int>(EncrpytionKeysIniFileName.size()), EncrpytionKeysIniFileName.data());
@@ -315,6 +2709,71 @@ namespace TaikoSwitchDataTableDecryptor
 			printf("    When a '.json' input file name ends with a known key name, the same key will be used to re-encrypt the output '.bin'.\n");
 			printf("    If no matching key is found then files will be neither decrypted no encrpyted (Providing compatibility with older Taiko versions)\n");
 			printf("\n");
+			printf("    Multiple input files are converted one after another. With '--verify' every written '.bin' file\n");
+			printf("    is decoded again in memory and compared against its '.json' source file.\n");
+			printf("    With '--threads' files are processed in parallel, largest first, only starting a new file once\n");
+			printf("    its estimated memory usage fits into the '--memory-budget' left over by all files currently in flight.\n");
+			printf("    With '--iv content' the IV of encrypted '.bin' files is derived from their content instead of being constant\n");
+			printf("    (identical inputs still produce identical outputs), with '--iv original' the IV of the overwritten '.bin' file is kept.\n");
+			printf("    With '--durable' '.bin' output files are written to temporary files first, which are then flushed to disk all at once\n");
+			printf("    and renamed into place at the end of the batch, so that an interrupted batch never leaves behind truncated output files.\n");
+			printf("    With '--io overlapped' a single thread keeps up to '--queue-depth' (default 16) input files being read ahead\n");
+			printf("    and writes every output file as soon as it is ready using overlapped I/O, leaving all other work to the worker threads.\n");
+			printf("    With '--io threaded' the same is done by '--io-threads' (default 2) dedicated threads using blocking I/O instead.\n");
+			printf("    Neither can be combined with '--manifest', '--cache', '--durable', '--verify' or '--iv original' and fall back to '--io blocking'.\n");
+			printf("    With '--dedup' every input file is hashed after being read and out of every set of identical input files only the first one\n");
+			printf("    is converted, with its output file then being copied to the output paths of all others.\n");
+			printf("    With '--manifest' '.json' input files (and their '.bin' output files) that haven't changed since\n");
+			printf("    the last run using the same manifest file are skipped.\n");
+			printf("    With '--journal' every converted file is appended to a journal file right away, so that running the same batch again\n");
+			printf("    after it was interrupted skips all input files it had already finished. The journal is removed once the batch succeeds.\n");
+			printf("    With '--shards' any number of processes (on any number of machines) started using the same input files and shared directory\n");
+			printf("    split the batch between each other, each claiming and converting '--shard-size' (default 64) files at a time. Claims not kept alive\n");
+			printf("    for longer than '--claim-timeout' (default 60 seconds) by a crashed process are taken over by the others.\n");
+			printf("    '--shards' can't be combined with '--manifest' or '--journal'.\n");
+			printf("    With '--cache' '.bin' output files are stored in (and reused from) a content addressed cache directory\n");
+			printf("    shared between builds, evicting the least recently used entries beyond '--cache-size' (default 1024MB).\n");
+			printf("\n");
+			printf("    The 'verify' command checks that every '.bin' input file (or every one found inside an input directory)\n");
+			printf("    can be decrypted and fully decompressed without writing any output files.\n");
+			printf("\n");
+			printf("    The 'watch' command keeps running and converts every '.json' file inside the input directory (or any of its subdirectories)\n");
+			printf("    to '.bin' as soon as it has been saved and hasn't been written to again for '--debounce' milliseconds (default %u).\n", DefaultWatchDebounceMilliseconds);
+			printf("\n");
+			printf("    The 'serve' command keeps running and converts files (or in-memory buffers) sent to it over a local named pipe,\n");
+			printf("    parsing the keys and allocating all AES and zlib state only once. The 'client' command sends its input files\n");
+			printf("    to a running server instead of converting them itself, with '--shutdown' stopping the server afterwards.\n");
+			printf("\n");
+			printf("    The 'decode' and 'encode' commands read from stdin and write to stdout one chunk at a time for use inside of shell pipelines.\n");
+			printf("    The key used for decoding is detected automatically unless specified using '--key', encoding without a '--key' leaves the output unencrypted.\n");
+			printf("\n");
+			printf("    The 'tar' command reads a tar archive (from stdin unless an input file is specified) and decodes every 'datatable/*.bin' member\n");
+			printf("    in parallel while the rest of the archive is still being read. The '.json' output is written in the same order as the input,\n");
+			printf("    either as another tar archive (to stdout unless '--output' ends with '.tar') or into the '--output' directory.\n");
+			printf("\n");
+			printf("    The 'romfs' command memory maps a RomFS image and decodes every '.bin' file inside its 'datatable' directory in place\n");
+			printf("    (without extracting anything first) into the '--output' directory (defaults to '{input_romfs_image}/datatable').\n");
+			printf("\n");
+			printf("    The 'layeredfs' command assembles a complete LayeredFS 'datatable' directory, only converting '.json' files that differ from\n");
+			printf("    their '--original' '.bin' file and copying all others. Every output file is staged first and renamed into place at the end,\n");
+			printf("    with all renames being undone again if any of them fails.\n");
+			printf("\n");
+			printf("    The 'store' command decodes every '.bin' input file and splits each table into content defined chunks, storing every chunk\n");
+			printf("    only once inside the '--store' directory so that storing many versions only adds the chunks that changed between them.\n");
+			printf("    The 'extract' command reassembles every '.json' table of the stored version '--name' into the '--output' directory.\n");
+			printf("\n");
+			printf("    The 'diff' command decodes every pair of '.bin' files at the same relative path inside of both directories in parallel and lists every\n");
+			printf("    added, removed and changed value of each table, matching array records by their 'id' (or 'uniqueId') instead of their position.\n");
+			printf("\n");
+			printf("    The 'benchmark' command measures all zlib, AES, key probing and full conversion steps on a generated\n");
+			printf("    synthetic DataTable corpus (1KB to 2MB) as well as batch scaling for up to '--threads' threads.\n");
+			printf("    Results are written to a JSON file which can later be used as a '--baseline' to detect regressions.\n");
+			printf("\n");
+			printf("    With '--stats' the time spent in each stage (read, key probing, AES, zlib, write) as well as the number\n");
+			printf("    of bytes processed is recorded per file and written to a JSON report once all files have been processed.\n");
+			printf("    With '--trace' begin/end events of every file and stage are written in the Chrome trace event format\n");
+			printf("    (viewable using chrome://tracing) to help spot scheduling stalls between worker threads.\n");
+			printf("\n");
 			printf("    Decompressed DataTable JSON input files mustn't be larger than ~2MB (0x200000 bytes)\n");
 			printf("    because of fixed size buffers used by the game during decompression.\n");
 			printf("\n");
@@ -325,18 +2784,89 @@ namespace TaikoSwitchDataTableDecryptor
 			return EXIT_WIDEPEEPOSAD;
 		}
 
-		std::unique_ptr<u8[]> stringViewOwningIniFileContent = nullptr;
-		std::vector<NamedEncryptionKey> namedKeys = ReadAndParseEncrpytionKeysIniFile(stringViewOwningIniFileContent);
+		const Command command =
+			PeepoHappy::ASCII::MatchesInsensitive(argv[1], "verify") ? Command::Verify :
+			PeepoHappy::ASCII::MatchesInsensitive(argv[1], "benchmark") ? Command::Benchmark :
+			PeepoHappy::ASCII::MatchesInsensitive(argv[1], "watch") ? Command::Watch :
+			PeepoHappy::ASCII::MatchesInsensitive(argv[1], "serve") ? Command::Serve :
+			PeepoHappy::ASCII::MatchesInsensitive(argv[1], "client") ? Command::Client :
+			PeepoHappy::ASCII::MatchesInsensitive(argv[1], "decode") ? Command::Decode :
+			PeepoHappy::ASCII::MatchesInsensitive(argv[1], "encode") ? Command::Encode :
+			PeepoHappy::ASCII::MatchesInsensitive(argv[1], "tar") ? Command::Tar :
+			PeepoHappy::ASCII::MatchesInsensitive(argv[1], "romfs") ? Command::RomFS :
+			PeepoHappy::ASCII::MatchesInsensitive(argv[1], "layeredfs") ? Command::LayeredFS :
+			PeepoHappy::ASCII::MatchesInsensitive(argv[1], "store") ? Command::Store :
+			PeepoHappy::ASCII::MatchesInsensitive(argv[1], "extract") ? Command::Extract :
+			PeepoHappy::ASCII::MatchesInsensitive(argv[1], "diff") ? Command::Diff :
+			Command::Convert;
 
-		const std::string_view inputFilePath = std::string_view(argv[1]);
-		if (PeepoHappy::Path::HasFileExtension(inputFilePath, ".bin"))
-			return ReadAndWriteEncryptedAndOrCompressedBinToJsonFile(inputFilePath, namedKeys);
+		// NOTE: The client never needs to know about any of the keys, only the server does
+		PeepoHappy::Memory::TrackedBuffer stringViewOwningIniFileContent = nullptr;
+		std::vector<NamedEncryptionKey> namedKeys = (command != Command::Client) ? ReadAndParseEncrpytionKeysIniFile(stringViewOwningIniFileContent) : std::vector<NamedEncryptionKey>();
 
-		if (PeepoHappy::Path::HasFileExtension(inputFilePath, ".json"))
-			return ReadAndWriteJsonToCompressedAndOrEncryptedBinFile(inputFilePath, namedKeys);
+		const CommandLineOptions options = (command != Command::Convert) ? ParseCommandLineOptions(argc - 2, argv + 2) : ParseCommandLineOptions(argc - 1, argv + 1);
 
-		fprintf(stderr, "Unexpected file extension\n");
-		return EXIT_WIDEPEEPOSAD;
+		if (!options.StatsOutputFilePath.empty())
+			Statistics::Enable();
+		if (!options.TraceOutputFilePath.empty())
+			Statistics::EnableTracing();
+
+		Statistics::BeginBatch();
+		int exitCode = EXIT_WIDEPEEPOSAD;
+		switch (command)
+		{
+		case Command::Convert:
+			exitCode = !options.ShardDirectoryPath.empty() ? ConvertAllInputFilesUsingSharedShards(options, namedKeys) : ConvertAllInputFiles(options, namedKeys);
+			break;
+		case Command::Verify:
+			exitCode = VerifyAllDataTableBinFiles(GatherInputFilePaths(options.InputPaths, ".bin"), namedKeys, options.ThreadCount, options.MemoryBudget);
+			break;
+		case Command::Watch:
+			exitCode = WatchDirectoryAndConvertChangedJsonFiles(options, namedKeys);
+			break;
+		case Command::Serve:
+			exitCode = ServeDaemonRequestsUntilShutdown(options, namedKeys);
+			break;
+		case Command::Client:
+			exitCode = SendAllInputFilesToDaemon(options);
+			break;
+		case Command::Decode:
+			exitCode = DecodeStandardInputToStandardOutput(options, namedKeys);
+			break;
+		case Command::Encode:
+			exitCode = EncodeStandardInputToStandardOutput(options, namedKeys);
+			break;
+		case Command::Tar:
+			exitCode = ConvertTarStreamBinMembersToJson(options, namedKeys);
+			break;
+		case Command::RomFS:
+			exitCode = ConvertRomFSImageDataTableFilesToJson(options, namedKeys);
+			break;
+		case Command::LayeredFS:
+			exitCode = BuildLayeredFSDataTableDirectory(options, namedKeys);
+			break;
+		case Command::Store:
+			exitCode = AddInputFilesToChunkStore(options, namedKeys);
+			break;
+		case Command::Extract:
+			exitCode = ExtractVersionFromChunkStore(options);
+			break;
+		case Command::Diff:
+			exitCode = DiffDataTableDirectories(options, namedKeys);
+			break;
+		case Command::Benchmark:
+			exitCode = Benchmark::RunAllBenchmarks(namedKeys, options.EncryptionIVMode, options.InputPaths.empty() ? "" : options.InputPaths.front(), options.BaselineFilePath, options.ThreadCount);
+			break;
+		}
+		Statistics::EndBatch();
+
+		if (!options.StatsOutputFilePath.empty() && !Statistics::WriteJsonReport(options.StatsOutputFilePath))
+			fprintf(stderr, "Failed to write statistics report\n");
+
+		if (!options.TraceOutputFilePath.empty() && !Statistics::WriteChromeTraceReport(options.TraceOutputFilePath))
+			fprintf(stderr, "Failed to write trace report\n");
+
+		return exitCode;
 	}
 }
 
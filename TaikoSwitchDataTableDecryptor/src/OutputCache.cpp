@@ -0,0 +1,148 @@
+#include "OutputCache.h"
+#include <algorithm>
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	OutputCache::OutputCache(std::string_view directoryPath, u64 maxByteSize) : directoryPath(directoryPath), maxByteSize(maxByteSize)
+	{
+	}
+
+	PeepoHappy::Crypto::Sha256Digest OutputCache::ComputeKey(const PeepoHappy::Crypto::Sha256Digest& jsonFileDigest, std::string_view keyName, std::string_view encodingSettings)
+	{
+		// NOTE: Null separated so that different splits between the key name and encoding settings can never produce the same key
+		constexpr u8 separator = '\0';
+
+		PeepoHappy::Crypto::Sha256Hasher hasher;
+		hasher.Update(jsonFileDigest.data(), jsonFileDigest.size());
+		hasher.Update(&separator, sizeof(separator));
+		hasher.Update(reinterpret_cast<const u8*>(keyName.data()), keyName.size());
+		hasher.Update(&separator, sizeof(separator));
+		hasher.Update(reinterpret_cast<const u8*>(encodingSettings.data()), encodingSettings.size());
+		return hasher.Finish();
+	}
+
+	bool OutputCache::TryCopyTo(const PeepoHappy::Crypto::Sha256Digest& key, std::string_view outputFilePath, u64& outFileSize)
+	{
+		const std::string entryFilePath = FormatEntryFilePath(key);
+		const u64 entryFileSize = PeepoHappy::IO::GetFileSize(entryFilePath);
+		if (entryFileSize == 0)
+		{
+			missCount++;
+			return false;
+		}
+
+		// NOTE: Not a miss, the caller simply falls back to converting the input file itself
+		if (!PeepoHappy::IO::DuplicateFile(entryFilePath, outputFilePath))
+		{
+			fprintf(stderr, "Failed to copy output cache entry '%s'\n", entryFilePath.c_str());
+			return false;
+		}
+
+		// NOTE: The copy keeps the last write time of the cache entry, which would make the output file look older than its input file
+		PeepoHappy::IO::SetLastWriteTimeToNow(outputFilePath);
+
+		RecordHit(entryFilePath);
+		outFileSize = entryFileSize;
+		return true;
+	}
+
+	std::pair<PeepoHappy::Memory::TrackedBuffer, size_t> OutputCache::TryRead(const PeepoHappy::Crypto::Sha256Digest& key)
+	{
+		const std::string entryFilePath = FormatEntryFilePath(key);
+		auto[fileContent, fileSize] = PeepoHappy::IO::ReadEntireFile(entryFilePath);
+		if (fileContent == nullptr)
+		{
+			missCount++;
+			return { nullptr, 0 };
+		}
+
+		RecordHit(entryFilePath);
+		return { std::move(fileContent), fileSize };
+	}
+
+	void OutputCache::Store(const PeepoHappy::Crypto::Sha256Digest& key, const u8* fileContent, size_t fileSize)
+	{
+		const std::string entryFilePath = FormatEntryFilePath(key);
+		if (!PeepoHappy::IO::CreateDirectoryRecursive(PeepoHappy::Path::GetDirectoryName(entryFilePath)) || !PeepoHappy::IO::WriteEntireFileAtomically(entryFilePath, fileContent, fileSize))
+		{
+			fprintf(stderr, "Failed to store output cache entry '%s'\n", entryFilePath.c_str());
+			return;
+		}
+
+		storeCount++;
+	}
+
+	void OutputCache::EvictLeastRecentlyUsed()
+	{
+		struct CacheEntry
+		{
+			std::string FilePath;
+			PeepoHappy::IO::FileMetadata Metadata;
+		};
+
+		std::vector<CacheEntry> entries;
+		u64 totalByteSize = 0;
+
+		PeepoHappy::IO::ForEachFileInDirectory(directoryPath, [&](std::string_view filePath)
+		{
+			if (!PeepoHappy::Path::HasFileExtension(filePath, ".bin"))
+				return;
+
+			CacheEntry& entry = entries.emplace_back();
+			entry.FilePath = std::string(filePath);
+			entry.Metadata = PeepoHappy::IO::GetFileMetadata(filePath);
+			totalByteSize += entry.Metadata.Size;
+		});
+
+		if (totalByteSize <= maxByteSize)
+			return;
+
+		std::sort(entries.begin(), entries.end(), [](const CacheEntry& a, const CacheEntry& b) { return a.Metadata.LastWriteTime < b.Metadata.LastWriteTime; });
+
+		for (const CacheEntry& entry : entries)
+		{
+			if (totalByteSize <= maxByteSize)
+				break;
+
+			// NOTE: Another process might be using (or already have evicted) the same entry, in which case it is simply left alone
+			if (PeepoHappy::IO::RemoveFile(entry.FilePath))
+			{
+				evictedCount++;
+				evictedByteSize += entry.Metadata.Size;
+			}
+			totalByteSize -= entry.Metadata.Size;
+		}
+	}
+
+	void OutputCache::PrintSummary() const
+	{
+		const size_t lookupCount = (hitCount + missCount);
+		const f64 hitRate = (lookupCount > 0) ? (static_cast<f64>(hitCount) / static_cast<f64>(lookupCount) * 100.0) : 0.0;
+
+		printf("Output cache: %zu hit(s), %zu miss(es) (%.1f%% hit rate, %llu bytes reused), %zu stored, %zu evicted (%llu bytes)\n",
+			static_cast<size_t>(hitCount), static_cast<size_t>(missCount), hitRate, static_cast<unsigned long long>(hitByteSize),
+			static_cast<size_t>(storeCount), evictedCount, static_cast<unsigned long long>(evictedByteSize));
+	}
+
+	std::string OutputCache::FormatEntryFilePath(const PeepoHappy::Crypto::Sha256Digest& key) const
+	{
+		const std::string keyHexString = PeepoHappy::Crypto::FormatSha256DigestHexString(key);
+
+		std::string entryFilePath;
+		entryFilePath.reserve(directoryPath.size() + keyHexString.size() + 8);
+		entryFilePath += directoryPath;
+		entryFilePath += '/';
+		entryFilePath += std::string_view(keyHexString).substr(0, 2);
+		entryFilePath += '/';
+		entryFilePath += keyHexString;
+		entryFilePath += ".bin";
+		return entryFilePath;
+	}
+
+	void OutputCache::RecordHit(std::string_view entryFilePath)
+	{
+		hitCount++;
+		hitByteSize += PeepoHappy::IO::GetFileSize(entryFilePath);
+		PeepoHappy::IO::SetLastWriteTimeToNow(entryFilePath);
+	}
+}
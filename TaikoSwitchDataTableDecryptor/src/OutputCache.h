@@ -0,0 +1,49 @@
+#pragma once
+#include "Types.h"
+#include "Utilities.h"
+#include <atomic>
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	// NOTE: Content addressed store of previously written .bin output files, shareable between builds, checkouts and processes.
+	//		 Entries are stored as "{directory}/{first two hex digits}/{key hex digits}.bin" and written atomically
+	//		 so that concurrent builds using the same directory never observe partially written entries
+	class OutputCache : NonCopyable
+	{
+	public:
+		OutputCache(std::string_view directoryPath, u64 maxByteSize);
+
+		// NOTE: Everything which affects the content of an output file. Callers must not use the cache for outputs
+		//		 that depend on anything else (such as the IV of a previously written output file)
+		static PeepoHappy::Crypto::Sha256Digest ComputeKey(const PeepoHappy::Crypto::Sha256Digest& jsonFileDigest, std::string_view keyName, std::string_view encodingSettings);
+
+		// NOTE: On a hit the cached entry is copied by the OS directly without it ever being read into memory,
+		//		 with the output file then being touched so that it looks just as new as if it had been written
+		bool TryCopyTo(const PeepoHappy::Crypto::Sha256Digest& key, std::string_view outputFilePath, u64& outFileSize);
+		// NOTE: For when the output content is needed in memory anyway, returns null on a miss
+		std::pair<PeepoHappy::Memory::TrackedBuffer, size_t> TryRead(const PeepoHappy::Crypto::Sha256Digest& key);
+
+		void Store(const PeepoHappy::Crypto::Sha256Digest& key, const u8* fileContent, size_t fileSize);
+
+		// NOTE: Deletes the least recently used entries (based on their last write time, which is updated on every hit)
+		//		 until the total size of all entries fits within the max byte size again
+		void EvictLeastRecentlyUsed();
+
+		void PrintSummary() const;
+
+	private:
+		std::string FormatEntryFilePath(const PeepoHappy::Crypto::Sha256Digest& key) const;
+		void RecordHit(std::string_view entryFilePath);
+
+	private:
+		std::string directoryPath;
+		u64 maxByteSize;
+
+		std::atomic<size_t> hitCount = 0;
+		std::atomic<size_t> missCount = 0;
+		std::atomic<size_t> storeCount = 0;
+		std::atomic<u64> hitByteSize = 0;
+		size_t evictedCount = 0;
+		u64 evictedByteSize = 0;
+	};
+}
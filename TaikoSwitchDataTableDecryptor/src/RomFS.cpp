@@ -0,0 +1,188 @@
+#include "RomFS.h"
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	namespace
+	{
+#pragma pack(push, 1)
+		struct RomFSHeader
+		{
+			u64 HeaderSize;
+			u64 DirectoryHashTableOffset;
+			u64 DirectoryHashTableSize;
+			u64 DirectoryMetaTableOffset;
+			u64 DirectoryMetaTableSize;
+			u64 FileHashTableOffset;
+			u64 FileHashTableSize;
+			u64 FileMetaTableOffset;
+			u64 FileMetaTableSize;
+			u64 FileDataOffset;
+		};
+
+		// NOTE: All offsets are relative to the start of their respective meta table, each entry is followed by its (not null terminated) name padded to 4 bytes
+		struct RomFSDirectoryEntry
+		{
+			u32 ParentOffset;
+			u32 SiblingOffset;
+			u32 FirstChildDirectoryOffset;
+			u32 FirstFileOffset;
+			u32 NextInHashBucketOffset;
+			u32 NameSize;
+		};
+
+		struct RomFSFileEntry
+		{
+			u32 ParentOffset;
+			u32 SiblingOffset;
+			// NOTE: Relative to the file data offset of the header
+			u64 DataOffset;
+			u64 DataSize;
+			u32 NextInHashBucketOffset;
+			u32 NameSize;
+		};
+#pragma pack(pop)
+
+		static_assert(sizeof(RomFSHeader) == 0x50);
+		static_assert(sizeof(RomFSDirectoryEntry) == 0x18);
+		static_assert(sizeof(RomFSFileEntry) == 0x20);
+
+		// NOTE: The same hash used by the official tools to place an entry into its hash table bucket
+		u32 CalculateEntryNameHash(u32 parentOffset, std::string_view name)
+		{
+			u32 hash = parentOffset ^ 123456789;
+			for (const char c : name)
+			{
+				hash = (hash >> 5) | (hash << 27);
+				hash ^= static_cast<u8>(c);
+			}
+			return hash;
+		}
+
+		bool IsWithinBounds(u64 offset, u64 size, u64 totalSize)
+		{
+			return (offset <= totalSize && size <= (totalSize - offset));
+		}
+
+		// NOTE: Entries aren't necessarily aligned to their natural alignment so they are always copied out
+		template <typename EntryType>
+		bool ReadTableEntry(const u8* tableData, size_t tableSize, u32 entryOffset, EntryType& outEntry, std::string_view& outName)
+		{
+			if (!IsWithinBounds(entryOffset, sizeof(EntryType), tableSize))
+				return false;
+
+			memcpy(&outEntry, tableData + entryOffset, sizeof(EntryType));
+			if (!IsWithinBounds(static_cast<u64>(entryOffset) + sizeof(EntryType), outEntry.NameSize, tableSize))
+				return false;
+
+			outName = std::string_view(reinterpret_cast<const char*>(tableData + entryOffset + sizeof(EntryType)), outEntry.NameSize);
+			return true;
+		}
+	}
+
+	bool RomFSImage::Parse(const u8* imageData, size_t imageSize)
+	{
+		RomFSHeader header = {};
+		if (imageData == nullptr || imageSize < sizeof(header))
+			return false;
+
+		memcpy(&header, imageData, sizeof(header));
+		if (header.HeaderSize != sizeof(header))
+			return false;
+
+		if (!IsWithinBounds(header.DirectoryHashTableOffset, header.DirectoryHashTableSize, imageSize) ||
+			!IsWithinBounds(header.DirectoryMetaTableOffset, header.DirectoryMetaTableSize, imageSize) ||
+			!IsWithinBounds(header.FileHashTableOffset, header.FileHashTableSize, imageSize) ||
+			!IsWithinBounds(header.FileMetaTableOffset, header.FileMetaTableSize, imageSize) ||
+			header.FileDataOffset > imageSize)
+			return false;
+
+		// NOTE: Every image has at least a root directory and a hash table with at least one bucket
+		if (header.DirectoryHashTableSize < sizeof(u32) || header.DirectoryMetaTableSize < sizeof(RomFSDirectoryEntry))
+			return false;
+
+		this->imageData = imageData;
+		this->imageSize = imageSize;
+		fileDataOffset = header.FileDataOffset;
+		directoryHashTable = { imageData + header.DirectoryHashTableOffset, static_cast<size_t>(header.DirectoryHashTableSize) };
+		directoryMetaTable = { imageData + header.DirectoryMetaTableOffset, static_cast<size_t>(header.DirectoryMetaTableSize) };
+		fileMetaTable = { imageData + header.FileMetaTableOffset, static_cast<size_t>(header.FileMetaTableSize) };
+		return true;
+	}
+
+	u32 RomFSImage::FindDirectory(std::string_view directoryPath) const
+	{
+		const size_t bucketCount = (directoryHashTable.Size / sizeof(u32));
+		if (bucketCount == 0)
+			return InvalidEntryOffset;
+
+		// NOTE: Malformed images could link hash bucket chains into a loop, no valid chain can be longer than there are entries in total
+		const size_t maxChainLength = (directoryMetaTable.Size / sizeof(RomFSDirectoryEntry));
+
+		u32 currentDirectoryOffset = RootDirectoryOffset;
+		while (!directoryPath.empty())
+		{
+			const size_t separator = directoryPath.find('/');
+			const std::string_view name = directoryPath.substr(0, separator);
+			directoryPath = (separator == std::string_view::npos) ? std::string_view() : directoryPath.substr(separator + 1);
+
+			if (name.empty())
+				continue;
+
+			u32 entryOffset = InvalidEntryOffset;
+			memcpy(&entryOffset, directoryHashTable.Data + ((CalculateEntryNameHash(currentDirectoryOffset, name) % bucketCount) * sizeof(u32)), sizeof(u32));
+
+			u32 foundDirectoryOffset = InvalidEntryOffset;
+			for (size_t chainLength = 0; entryOffset != InvalidEntryOffset && chainLength < maxChainLength; chainLength++)
+			{
+				RomFSDirectoryEntry entry = {};
+				std::string_view entryName = {};
+				if (!ReadTableEntry(directoryMetaTable.Data, directoryMetaTable.Size, entryOffset, entry, entryName))
+					return InvalidEntryOffset;
+
+				if (entry.ParentOffset == currentDirectoryOffset && entryName == name)
+				{
+					foundDirectoryOffset = entryOffset;
+					break;
+				}
+				entryOffset = entry.NextInHashBucketOffset;
+			}
+
+			if (foundDirectoryOffset == InvalidEntryOffset)
+				return InvalidEntryOffset;
+			currentDirectoryOffset = foundDirectoryOffset;
+		}
+
+		return currentDirectoryOffset;
+	}
+
+	bool RomFSImage::GetFilesInDirectory(u32 directoryOffset, std::vector<RomFSFile>& outFiles) const
+	{
+		RomFSDirectoryEntry directoryEntry = {};
+		std::string_view directoryName = {};
+		if (imageData == nullptr || !ReadTableEntry(directoryMetaTable.Data, directoryMetaTable.Size, directoryOffset, directoryEntry, directoryName))
+			return false;
+
+		// NOTE: Same as with the hash bucket chains, no valid sibling chain can be longer than there are file entries in total
+		const size_t maxFileCount = (fileMetaTable.Size / sizeof(RomFSFileEntry));
+
+		size_t fileCount = 0;
+		for (u32 fileOffset = directoryEntry.FirstFileOffset; fileOffset != InvalidEntryOffset; fileCount++)
+		{
+			if (fileCount >= maxFileCount)
+				return false;
+
+			RomFSFileEntry fileEntry = {};
+			std::string_view fileName = {};
+			if (!ReadTableEntry(fileMetaTable.Data, fileMetaTable.Size, fileOffset, fileEntry, fileName))
+				return false;
+
+			if (fileEntry.DataOffset > (imageSize - fileDataOffset) || !IsWithinBounds(fileDataOffset + fileEntry.DataOffset, fileEntry.DataSize, imageSize))
+				return false;
+
+			outFiles.push_back(RomFSFile { fileName, imageData + fileDataOffset + fileEntry.DataOffset, static_cast<size_t>(fileEntry.DataSize) });
+			fileOffset = fileEntry.SiblingOffset;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "Types.h"
+#include "Utilities.h"
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	struct RomFSFile
+	{
+		// NOTE: Both point straight into the image data
+		std::string_view Name;
+		const u8* Data;
+		size_t Size;
+	};
+
+	// NOTE: Read-only view of a (level 3) RomFS image as used by the Switch, such as an extracted "romfs.bin".
+	//		 Every table offset, entry and file data range is bounds checked against the image so that malformed images are rejected
+	//		 instead of being read out of bounds. Doesn't own the image data which must outlive this object
+	class RomFSImage : NonCopyable
+	{
+	public:
+		static constexpr u32 InvalidEntryOffset = 0xFFFFFFFF;
+		static constexpr u32 RootDirectoryOffset = 0;
+
+		bool Parse(const u8* imageData, size_t imageSize);
+
+		// NOTE: Slash separated path relative to the root directory (such as "datatable"), resolved using the directory hash table.
+		//		 Returns InvalidEntryOffset if no such directory exists
+		u32 FindDirectory(std::string_view directoryPath) const;
+		// NOTE: Only the files directly inside of the directory, in the order they are linked inside the file table.
+		//		 Returns false if the directory or any of its file entries (or their data) is out of bounds or if the sibling chain loops,
+		//		 in which case the files read up to that point are still returned
+		bool GetFilesInDirectory(u32 directoryOffset, std::vector<RomFSFile>& outFiles) const;
+
+	private:
+		struct TableView
+		{
+			const u8* Data;
+			size_t Size;
+		};
+
+		const u8* imageData = nullptr;
+		size_t imageSize = 0;
+		u64 fileDataOffset = 0;
+		TableView directoryHashTable = {}, directoryMetaTable = {}, fileMetaTable = {};
+	};
+}
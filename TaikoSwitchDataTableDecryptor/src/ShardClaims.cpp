@@ -0,0 +1,140 @@
+#include "ShardClaims.h"
+#include <process.h>
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	namespace
+	{
+		// NOTE: FILETIME units of 100 nanoseconds
+		constexpr u64 FileTimeUnitsPerSecond = 10'000'000;
+	}
+
+	ShardClaimDirectory::ShardClaimDirectory(std::string_view directoryPath, u32 claimTimeoutSeconds)
+		: directoryPath(directoryPath), claimTimeout(static_cast<u64>(claimTimeoutSeconds) * FileTimeUnitsPerSecond)
+	{
+		char processIDBuffer[32];
+		sprintf_s(processIDBuffer, "%lu", static_cast<unsigned long>(::_getpid()));
+
+		ownerText = PeepoHappy::UTF8::GetMachineName();
+		ownerText += '\t';
+		ownerText += processIDBuffer;
+
+		valid = PeepoHappy::IO::DirectoryExists(directoryPath) || PeepoHappy::IO::CreateDirectoryRecursive(directoryPath);
+		if (valid)
+			heartbeatThread = std::thread([this] { KeepClaimAlive(); });
+	}
+
+	ShardClaimDirectory::~ShardClaimDirectory()
+	{
+		{
+			std::scoped_lock lock(mutex);
+			shuttingDown = true;
+		}
+		condition.notify_all();
+
+		if (heartbeatThread.joinable())
+			heartbeatThread.join();
+	}
+
+	bool ShardClaimDirectory::IsValid() const
+	{
+		return valid;
+	}
+
+	ShardClaimResult ShardClaimDirectory::TryClaim(std::string_view shardName)
+	{
+		if (IsDone(shardName))
+			return ShardClaimResult::Done;
+
+		// NOTE: Every claim file can only ever be created once, a stale claim of generation n is taken over by creating the claim file of generation n + 1.
+		//		 Creating it is the only step that decides who wins, so out of all workers that judged the same generation to be stale exactly one succeeds
+		//		 and all others then find its fresh claim instead. Claims of older generations are left in place (so that no one can claim them again)
+		//		 until the shard has been finished
+		u32 generation = 0;
+		std::string claimFilePath;
+		for (;; generation++)
+		{
+			claimFilePath = FormatClaimFilePath(shardName, generation);
+			if (PeepoHappy::IO::CreateNewFile(claimFilePath, reinterpret_cast<const u8*>(ownerText.data()), ownerText.size()))
+				break;
+
+			if (PeepoHappy::IO::GetFileMetadata(FormatClaimFilePath(shardName, generation + 1)).LastWriteTime != 0)
+				continue;
+
+			// NOTE: Zero if the claim file was removed in the meantime, in which case the shard has most likely just been finished
+			const u64 lastWriteTime = PeepoHappy::IO::GetFileMetadata(claimFilePath).LastWriteTime;
+			const u64 currentTime = PeepoHappy::IO::GetCurrentFileTime();
+			if (lastWriteTime == 0 || currentTime < lastWriteTime || (currentTime - lastWriteTime) <= claimTimeout)
+				return ShardClaimResult::ClaimedByOther;
+		}
+
+		// NOTE: The previous owner might have finished the shard in between checking for its done file and creating the claim file
+		if (IsDone(shardName))
+		{
+			PeepoHappy::IO::RemoveFile(claimFilePath);
+			return ShardClaimResult::Done;
+		}
+
+		std::scoped_lock lock(mutex);
+		claimedFilePath = claimFilePath;
+		claimedGeneration = generation;
+		return (generation > 0) ? ShardClaimResult::TakenOver : ShardClaimResult::Claimed;
+	}
+
+	bool ShardClaimDirectory::Finish(std::string_view shardName, std::string_view summary)
+	{
+		std::string doneText = ownerText;
+		doneText += '\t';
+		doneText += summary;
+		doneText += '\n';
+
+		// NOTE: Another worker that took over a claim of this worker it wrongly thought was stale might have finished first
+		const bool finished = PeepoHappy::IO::CreateNewFile(FormatFilePath(shardName, ".done"), reinterpret_cast<const u8*>(doneText.data()), doneText.size()) || IsDone(shardName);
+
+		std::scoped_lock lock(mutex);
+
+		// NOTE: Only the stale claims this one took over are removed along with it, a newer generation still belongs to whoever took over this claim
+		const u32 oldestGeneration = finished ? 0 : claimedGeneration;
+		for (u32 generation = oldestGeneration; generation <= claimedGeneration; generation++)
+			PeepoHappy::IO::RemoveFile(FormatClaimFilePath(shardName, generation));
+
+		claimedFilePath.clear();
+		claimedGeneration = 0;
+		return finished;
+	}
+
+	std::string ShardClaimDirectory::FormatFilePath(std::string_view shardName, std::string_view extension) const
+	{
+		std::string filePath = directoryPath;
+		filePath += '/';
+		filePath += shardName;
+		filePath += extension;
+		return filePath;
+	}
+
+	std::string ShardClaimDirectory::FormatClaimFilePath(std::string_view shardName, u32 generation) const
+	{
+		char extensionBuffer[32];
+		sprintf_s(extensionBuffer, ".claim.%u", generation);
+		return FormatFilePath(shardName, extensionBuffer);
+	}
+
+	bool ShardClaimDirectory::IsDone(std::string_view shardName) const
+	{
+		return (PeepoHappy::IO::GetFileSize(FormatFilePath(shardName, ".done")) > 0);
+	}
+
+	void ShardClaimDirectory::KeepClaimAlive()
+	{
+		// NOTE: Touching the claim file a few times per timeout so that a single slow write to the shared directory doesn't make it look stale
+		const auto heartbeatInterval = std::chrono::milliseconds(std::max<u64>(claimTimeout / FileTimeUnitsPerSecond * 1000 / 4, 250));
+
+		auto lock = std::unique_lock(mutex);
+		while (!shuttingDown)
+		{
+			condition.wait_for(lock, heartbeatInterval, [this] { return shuttingDown; });
+			if (!claimedFilePath.empty())
+				PeepoHappy::IO::SetLastWriteTimeToNow(claimedFilePath);
+		}
+	}
+}
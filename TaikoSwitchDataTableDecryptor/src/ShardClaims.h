@@ -0,0 +1,58 @@
+#pragma once
+#include "Types.h"
+#include "Utilities.h"
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	enum class ShardClaimResult : u8
+	{
+		// NOTE: Already converted by some worker (possibly this one during an earlier run)
+		Done,
+		// NOTE: Currently being converted by another worker which is still keeping its claim alive
+		ClaimedByOther,
+		Claimed,
+		// NOTE: Claimed after the claim of another worker had not been kept alive for longer than the claim timeout (likely because it crashed)
+		TakenOver,
+	};
+
+	// NOTE: Lets any number of worker processes, on any number of machines, split a batch between each other through nothing but a shared directory.
+	//		 A shard is claimed by creating "{shard}.claim.{generation}", which the file system only ever lets one of them succeed at, and is marked
+	//		 as finished by creating "{shard}.done". While a shard is claimed its claim file is touched by a background thread in regular intervals.
+	//		 Since the staleness of a claim is judged using the clock of the taking over worker, the claim timeout has to be comfortably
+	//		 longer than the clock difference between any two machines. In the worst case a shard is converted twice, producing identical output
+	class ShardClaimDirectory : NonCopyable
+	{
+	public:
+		ShardClaimDirectory(std::string_view directoryPath, u32 claimTimeoutSeconds);
+		~ShardClaimDirectory();
+
+		bool IsValid() const;
+
+		// NOTE: Only a single shard can be claimed at a time, which has to be finished before claiming the next one
+		ShardClaimResult TryClaim(std::string_view shardName);
+		// NOTE: The summary is stored inside the done file for anyone wondering who converted what
+		bool Finish(std::string_view shardName, std::string_view summary);
+
+	private:
+		std::string FormatFilePath(std::string_view shardName, std::string_view extension) const;
+		std::string FormatClaimFilePath(std::string_view shardName, u32 generation) const;
+		bool IsDone(std::string_view shardName) const;
+		void KeepClaimAlive();
+
+	private:
+		std::string directoryPath;
+		u64 claimTimeout;
+		std::string ownerText;
+		bool valid;
+
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::string claimedFilePath;
+		u32 claimedGeneration = 0;
+		bool shuttingDown = false;
+		std::thread heartbeatThread;
+	};
+}
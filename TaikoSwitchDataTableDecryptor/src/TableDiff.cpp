@@ -0,0 +1,382 @@
+#include "TableDiff.h"
+#include <unordered_map>
+#include <unordered_set>
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	namespace
+	{
+		// NOTE: Tables are only ever a few levels deep, the limit only exists so that malformed input can't overflow the stack
+		constexpr u32 MaxJsonNestingDepth = 64;
+		// NOTE: Tried in order, the first member name that is present (with a scalar value) and unique in every record of both arrays is used
+		constexpr std::array<std::string_view, 2> RecordIDMemberNames = { "id", "uniqueId" };
+		constexpr size_t MaxReportValueLength = 96;
+
+		class JsonParser
+		{
+		public:
+			explicit JsonParser(std::string_view source) : source(source) {}
+
+			bool ParseDocument(JsonValue& outValue)
+			{
+				if (source.substr(0, 3) == "\xEF\xBB\xBF")
+					position = 3;
+
+				if (!ParseValue(outValue, 0))
+					return false;
+
+				// NOTE: Some tables are padded with trailing null bytes
+				while (position < source.size() && (IsWhitespace(source[position]) || source[position] == '\0'))
+					position++;
+				return (position == source.size());
+			}
+
+		private:
+			static bool IsWhitespace(char c) { return (c == ' ' || c == '\t' || c == '\r' || c == '\n'); }
+			static bool IsNumberCharacter(char c) { return ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E'); }
+
+			void SkipWhitespace()
+			{
+				while (position < source.size() && IsWhitespace(source[position]))
+					position++;
+			}
+
+			bool SkipCharacter(char expected)
+			{
+				SkipWhitespace();
+				if (position >= source.size() || source[position] != expected)
+					return false;
+				position++;
+				return true;
+			}
+
+			// NOTE: Expects to be positioned at the opening quote and stops right after the closing one, escape sequences are skipped but not validated
+			bool SkipString()
+			{
+				for (position++; position < source.size(); position++)
+				{
+					if (source[position] == '\\')
+						position++;
+					else if (source[position] == '"')
+						break;
+				}
+
+				if (position >= source.size())
+					return false;
+
+				position++;
+				return true;
+			}
+
+			bool SkipLiteral(std::string_view literal)
+			{
+				if (source.substr(position, literal.size()) != literal)
+					return false;
+				position += literal.size();
+				return true;
+			}
+
+			bool ParseValue(JsonValue& outValue, u32 depth)
+			{
+				SkipWhitespace();
+				if (position >= source.size() || depth > MaxJsonNestingDepth)
+					return false;
+
+				const size_t startPosition = position;
+				const char firstCharacter = source[position];
+
+				if (firstCharacter == '{')
+				{
+					outValue.Type = JsonValueType::Object;
+					position++;
+					if (!SkipCharacter('}'))
+					{
+						do
+						{
+							SkipWhitespace();
+							const size_t nameStartPosition = position;
+							if (position >= source.size() || source[position] != '"' || !SkipString())
+								return false;
+
+							outValue.MemberNames.push_back(source.substr(nameStartPosition + 1, position - nameStartPosition - 2));
+							if (!SkipCharacter(':') || !ParseValue(outValue.Elements.emplace_back(), depth + 1))
+								return false;
+						}
+						while (SkipCharacter(','));
+
+						if (!SkipCharacter('}'))
+							return false;
+					}
+				}
+				else if (firstCharacter == '[')
+				{
+					outValue.Type = JsonValueType::Array;
+					position++;
+					if (!SkipCharacter(']'))
+					{
+						do
+						{
+							if (!ParseValue(outValue.Elements.emplace_back(), depth + 1))
+								return false;
+						}
+						while (SkipCharacter(','));
+
+						if (!SkipCharacter(']'))
+							return false;
+					}
+				}
+				else if (firstCharacter == '"')
+				{
+					outValue.Type = JsonValueType::String;
+					if (!SkipString())
+						return false;
+				}
+				else if (firstCharacter == 't' || firstCharacter == 'f')
+				{
+					outValue.Type = JsonValueType::Bool;
+					if (!SkipLiteral((firstCharacter == 't') ? "true" : "false"))
+						return false;
+				}
+				else if (firstCharacter == 'n')
+				{
+					outValue.Type = JsonValueType::Null;
+					if (!SkipLiteral("null"))
+						return false;
+				}
+				else if (firstCharacter == '-' || (firstCharacter >= '0' && firstCharacter <= '9'))
+				{
+					outValue.Type = JsonValueType::Number;
+					while (position < source.size() && IsNumberCharacter(source[position]))
+						position++;
+				}
+				else
+				{
+					return false;
+				}
+
+				outValue.Text = source.substr(startPosition, position - startPosition);
+				return true;
+			}
+
+		private:
+			std::string_view source;
+			size_t position = 0;
+		};
+
+		bool IsContainer(const JsonValue& value)
+		{
+			return (value.Type == JsonValueType::Array || value.Type == JsonValueType::Object);
+		}
+
+		// NOTE: Members usually appear in the same order in every record so the search starts at the index the member had in the other object
+		size_t FindMemberIndex(const JsonValue& object, std::string_view memberName, size_t hintIndex)
+		{
+			const size_t memberCount = object.MemberNames.size();
+			for (size_t i = 0; i < memberCount; i++)
+			{
+				const size_t memberIndex = (hintIndex + i) % memberCount;
+				if (object.MemberNames[memberIndex] == memberName)
+					return memberIndex;
+			}
+			return memberCount;
+		}
+
+		const JsonValue* FindRecordID(const JsonValue& record, std::string_view idMemberName)
+		{
+			if (record.Type != JsonValueType::Object)
+				return nullptr;
+
+			const size_t memberIndex = FindMemberIndex(record, idMemberName, 0);
+			if (memberIndex >= record.Elements.size() || IsContainer(record.Elements[memberIndex]))
+				return nullptr;
+
+			return &record.Elements[memberIndex];
+		}
+
+		bool GatherUniqueRecordIDs(const JsonValue& array, std::string_view idMemberName, std::vector<std::string_view>& outIDs)
+		{
+			std::unordered_set<std::string_view> uniqueIDs;
+			uniqueIDs.reserve(array.Elements.size());
+
+			outIDs.clear();
+			outIDs.reserve(array.Elements.size());
+			for (const JsonValue& record : array.Elements)
+			{
+				const JsonValue* id = FindRecordID(record, idMemberName);
+				if (id == nullptr || !uniqueIDs.insert(id->Text).second)
+					return false;
+				outIDs.push_back(id->Text);
+			}
+			return true;
+		}
+
+		struct JsonDiffContext
+		{
+			std::string& Report;
+			std::string Path;
+			size_t DifferenceCount;
+		};
+
+		void AppendReportValue(std::string& report, const JsonValue& value)
+		{
+			if (value.Type == JsonValueType::Object)
+				report += "{...}";
+			else if (value.Type == JsonValueType::Array)
+				report += "[...]";
+			else if (value.Text.size() > MaxReportValueLength)
+				report.append(value.Text.substr(0, MaxReportValueLength)).append("...");
+			else
+				report += value.Text;
+		}
+
+		void AppendDifference(JsonDiffContext& context, const JsonValue* oldValue, const JsonValue* newValue)
+		{
+			const char marker = (oldValue == nullptr) ? '+' : (newValue == nullptr) ? '-' : '~';
+			context.Report.append(1, marker).append(" ").append(context.Path.empty() ? std::string_view("(root)") : std::string_view(context.Path));
+
+			// NOTE: Whole added or removed records are only listed by their path, their content is already visible inside the table itself
+			if (oldValue != nullptr && newValue != nullptr)
+			{
+				context.Report += ": ";
+				AppendReportValue(context.Report, *oldValue);
+				context.Report += " -> ";
+				AppendReportValue(context.Report, *newValue);
+			}
+			else if (const JsonValue* value = (oldValue != nullptr) ? oldValue : newValue; !IsContainer(*value))
+			{
+				context.Report += ": ";
+				AppendReportValue(context.Report, *value);
+			}
+
+			context.Report += '\n';
+			context.DifferenceCount++;
+		}
+
+		void DiffValues(JsonDiffContext& context, const JsonValue& oldValue, const JsonValue& newValue);
+
+		void DiffObjects(JsonDiffContext& context, const JsonValue& oldObject, const JsonValue& newObject)
+		{
+			const size_t parentPathSize = context.Path.size();
+			auto pushMemberPath = [&](std::string_view memberName)
+			{
+				if (parentPathSize > 0)
+					context.Path += '.';
+				context.Path += memberName;
+			};
+
+			for (size_t oldIndex = 0; oldIndex < oldObject.MemberNames.size(); oldIndex++)
+			{
+				const std::string_view memberName = oldObject.MemberNames[oldIndex];
+				const size_t newIndex = FindMemberIndex(newObject, memberName, oldIndex);
+
+				pushMemberPath(memberName);
+				if (newIndex >= newObject.Elements.size())
+					AppendDifference(context, &oldObject.Elements[oldIndex], nullptr);
+				else
+					DiffValues(context, oldObject.Elements[oldIndex], newObject.Elements[newIndex]);
+				context.Path.resize(parentPathSize);
+			}
+
+			for (size_t newIndex = 0; newIndex < newObject.MemberNames.size(); newIndex++)
+			{
+				const std::string_view memberName = newObject.MemberNames[newIndex];
+				if (FindMemberIndex(oldObject, memberName, newIndex) < oldObject.Elements.size())
+					continue;
+
+				pushMemberPath(memberName);
+				AppendDifference(context, nullptr, &newObject.Elements[newIndex]);
+				context.Path.resize(parentPathSize);
+			}
+		}
+
+		void DiffArrays(JsonDiffContext& context, const JsonValue& oldArray, const JsonValue& newArray)
+		{
+			const size_t parentPathSize = context.Path.size();
+
+			std::vector<std::string_view> oldIDs, newIDs;
+			for (const std::string_view idMemberName : RecordIDMemberNames)
+			{
+				if (!GatherUniqueRecordIDs(oldArray, idMemberName, oldIDs) || !GatherUniqueRecordIDs(newArray, idMemberName, newIDs))
+					continue;
+
+				std::unordered_map<std::string_view, size_t> newIndicesByID;
+				newIndicesByID.reserve(newIDs.size());
+				for (size_t newIndex = 0; newIndex < newIDs.size(); newIndex++)
+					newIndicesByID.emplace(newIDs[newIndex], newIndex);
+
+				auto pushRecordPath = [&](std::string_view id) { context.Path.append("[").append(idMemberName).append("=").append(id).append("]"); };
+
+				std::vector<bool> newRecordsMatched(newIDs.size(), false);
+				for (size_t oldIndex = 0; oldIndex < oldIDs.size(); oldIndex++)
+				{
+					pushRecordPath(oldIDs[oldIndex]);
+					if (const auto foundIndex = newIndicesByID.find(oldIDs[oldIndex]); foundIndex != newIndicesByID.end())
+					{
+						newRecordsMatched[foundIndex->second] = true;
+						DiffValues(context, oldArray.Elements[oldIndex], newArray.Elements[foundIndex->second]);
+					}
+					else
+					{
+						AppendDifference(context, &oldArray.Elements[oldIndex], nullptr);
+					}
+					context.Path.resize(parentPathSize);
+				}
+
+				for (size_t newIndex = 0; newIndex < newIDs.size(); newIndex++)
+				{
+					if (newRecordsMatched[newIndex])
+						continue;
+
+					pushRecordPath(newIDs[newIndex]);
+					AppendDifference(context, nullptr, &newArray.Elements[newIndex]);
+					context.Path.resize(parentPathSize);
+				}
+				return;
+			}
+
+			// NOTE: Without any usable record IDs elements can only be compared by their position
+			char indexBuffer[32];
+			const size_t elementCount = std::max(oldArray.Elements.size(), newArray.Elements.size());
+			for (size_t i = 0; i < elementCount; i++)
+			{
+				sprintf_s(indexBuffer, "[%zu]", i);
+				context.Path += indexBuffer;
+
+				const JsonValue* oldElement = (i < oldArray.Elements.size()) ? &oldArray.Elements[i] : nullptr;
+				const JsonValue* newElement = (i < newArray.Elements.size()) ? &newArray.Elements[i] : nullptr;
+				if (oldElement != nullptr && newElement != nullptr)
+					DiffValues(context, *oldElement, *newElement);
+				else
+					AppendDifference(context, oldElement, newElement);
+				context.Path.resize(parentPathSize);
+			}
+		}
+
+		void DiffValues(JsonDiffContext& context, const JsonValue& oldValue, const JsonValue& newValue)
+		{
+			// NOTE: Comparing the source text first lets every unchanged record be skipped using a single memcmp
+			if (oldValue.Text == newValue.Text)
+				return;
+
+			if (oldValue.Type != newValue.Type || !IsContainer(oldValue))
+				AppendDifference(context, &oldValue, &newValue);
+			else if (oldValue.Type == JsonValueType::Object)
+				DiffObjects(context, oldValue, newValue);
+			else
+				DiffArrays(context, oldValue, newValue);
+		}
+	}
+
+	bool ParseJson(std::string_view json, JsonValue& outValue)
+	{
+		outValue = {};
+		return JsonParser(json).ParseDocument(outValue);
+	}
+
+	size_t DiffJsonValues(const JsonValue& oldValue, const JsonValue& newValue, std::string& outReport)
+	{
+		JsonDiffContext context = { outReport, std::string(), 0 };
+		DiffValues(context, oldValue, newValue);
+		return context.DifferenceCount;
+	}
+}
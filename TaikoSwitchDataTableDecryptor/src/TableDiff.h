@@ -0,0 +1,37 @@
+#pragma once
+#include "Types.h"
+#include "Utilities.h"
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	enum class JsonValueType : u8
+	{
+		Null,
+		Bool,
+		Number,
+		String,
+		Array,
+		Object,
+	};
+
+	// NOTE: Minimal read-only JSON document tree that never copies or unescapes anything and instead only points into the source text,
+	//		 which must outlive it. Only meant for comparing decoded tables, not for editing them
+	struct JsonValue
+	{
+		JsonValueType Type;
+		// NOTE: The complete source text of the value, including the quotes of strings and all nested values of arrays and objects
+		std::string_view Text;
+		// NOTE: Array elements or object member values, with the (still escaped) object member names stored separately in the same order
+		std::vector<JsonValue> Elements;
+		std::vector<std::string_view> MemberNames;
+	};
+
+	// NOTE: Returns false for malformed or truncated JSON as well as for values nested deeper than any real table would ever be
+	bool ParseJson(std::string_view json, JsonValue& outValue);
+
+	// NOTE: Appends one line for every added ("+"), removed ("-") and changed ("~") value to the report, each prefixed by its path
+	//		 (such as "items[id=\"abcdef\"].starEasy"). Array records that all have a unique "id" (or "uniqueId") member are matched by it,
+	//		 so that inserting or reordering records doesn't show up as every following record having changed.
+	//		 Returns the number of differences found
+	size_t DiffJsonValues(const JsonValue& oldValue, const JsonValue& newValue, std::string& outReport);
+}
@@ -0,0 +1,305 @@
+#include "TarArchive.h"
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	namespace
+	{
+		// NOTE: Byte offsets of the ustar header fields, every numeric field is stored as null (or space) terminated octal text
+		constexpr size_t NameOffset = 0, NameSize = 100;
+		constexpr size_t ModeOffset = 100, ModeSize = 8;
+		constexpr size_t UserIDOffset = 108, UserIDSize = 8;
+		constexpr size_t GroupIDOffset = 116, GroupIDSize = 8;
+		constexpr size_t SizeOffset = 124, SizeSize = 12;
+		constexpr size_t ModificationTimeOffset = 136, ModificationTimeSize = 12;
+		constexpr size_t ChecksumOffset = 148, ChecksumSize = 8;
+		constexpr size_t TypeFlagOffset = 156;
+		constexpr size_t MagicOffset = 257, MagicSize = 6;
+		constexpr size_t VersionOffset = 263, VersionSize = 2;
+		constexpr size_t PrefixOffset = 345, PrefixSize = 155;
+
+		constexpr char RegularFileTypeFlag = '0';
+		constexpr char ContiguousFileTypeFlag = '7';
+		constexpr char GnuLongNameTypeFlag = 'L';
+		constexpr char PaxExtendedHeaderTypeFlag = 'x';
+
+		// NOTE: Sanity limit for GNU long name and pax extended header members which are read into memory as a whole
+		constexpr u64 MaxExtendedHeaderSize = 0x10000;
+
+		using HeaderBlock = std::array<u8, TarBlockSize>;
+
+		std::string_view ReadStringField(const HeaderBlock& header, size_t offset, size_t size)
+		{
+			const char* field = reinterpret_cast<const char*>(header.data() + offset);
+			return std::string_view(field, strnlen(field, size));
+		}
+
+		// NOTE: GNU tar switches to big endian base-256 (marked by the highest bit of the first byte) for values that don't fit as octal
+		u64 ReadNumericField(const HeaderBlock& header, size_t offset, size_t size)
+		{
+			const u8* field = header.data() + offset;
+			u64 value = 0;
+
+			if (field[0] & 0x80)
+			{
+				value = (field[0] & 0x7F);
+				for (size_t i = 1; i < size; i++)
+					value = (value << 8) | field[i];
+				return value;
+			}
+
+			size_t i = 0;
+			while (i < size && (field[i] == ' ' || field[i] == '\0'))
+				i++;
+			while (i < size && field[i] >= '0' && field[i] <= '7')
+				value = (value << 3) | static_cast<u64>(field[i++] - '0');
+			return value;
+		}
+
+		// NOTE: Simple sum of all header bytes with the checksum field itself counted as spaces
+		u64 CalculateHeaderChecksum(const HeaderBlock& header)
+		{
+			u64 checksum = 0;
+			for (size_t i = 0; i < header.size(); i++)
+				checksum += (i >= ChecksumOffset && i < (ChecksumOffset + ChecksumSize)) ? static_cast<u8>(' ') : header[i];
+			return checksum;
+		}
+
+		bool IsZeroBlock(const HeaderBlock& header)
+		{
+			return std::all_of(header.begin(), header.end(), [](u8 byte) { return byte == 0; });
+		}
+
+		// NOTE: Records are formatted as "{length} {key}={value}\n" with the length including itself
+		std::string_view FindPaxRecordValue(std::string_view records, std::string_view key)
+		{
+			while (!records.empty())
+			{
+				const size_t lengthEnd = records.find(' ');
+				if (lengthEnd == std::string_view::npos)
+					break;
+
+				size_t recordLength = 0;
+				for (const char c : records.substr(0, lengthEnd))
+					recordLength = (c >= '0' && c <= '9') ? (recordLength * 10) + static_cast<size_t>(c - '0') : 0;
+
+				if (recordLength <= (lengthEnd + 1) || recordLength > records.size())
+					break;
+
+				const std::string_view keyValue = PeepoHappy::ASCII::StripSuffix(records.substr(lengthEnd + 1, recordLength - lengthEnd - 1), "\n");
+				const size_t separator = keyValue.find('=');
+				if (separator != std::string_view::npos && keyValue.substr(0, separator) == key)
+					return keyValue.substr(separator + 1);
+
+				records = records.substr(recordLength);
+			}
+			return {};
+		}
+
+		std::string FormatPaxRecord(std::string_view key, std::string_view value)
+		{
+			// NOTE: The length prefix counts its own digits so keep adjusting until it stops changing
+			const size_t lengthWithoutPrefix = key.size() + value.size() + 3;
+			size_t recordLength = lengthWithoutPrefix + 1;
+			while (recordLength != lengthWithoutPrefix + std::to_string(recordLength).size())
+				recordLength = lengthWithoutPrefix + std::to_string(recordLength).size();
+
+			std::string record = std::to_string(recordLength);
+			record += ' ';
+			record += key;
+			record += '=';
+			record += value;
+			record += '\n';
+			return record;
+		}
+
+		bool WriteOctalField(HeaderBlock& header, size_t offset, size_t size, u64 value)
+		{
+			char buffer[32];
+			const int formattedLength = sprintf_s(buffer, "%0*llo", static_cast<int>(size - 1), static_cast<unsigned long long>(value));
+			if (formattedLength < 0 || static_cast<size_t>(formattedLength) > (size - 1))
+				return false;
+
+			memcpy(header.data() + offset, buffer, size - 1);
+			return true;
+		}
+
+		void WriteStringField(HeaderBlock& header, size_t offset, size_t size, std::string_view value)
+		{
+			memcpy(header.data() + offset, value.data(), std::min(value.size(), size));
+		}
+	}
+
+	TarReader::TarReader(FILE* inputStream) : inputStream(inputStream)
+	{
+	}
+
+	bool TarReader::ReadNextMember(TarMember& outMember)
+	{
+		std::string extendedPath;
+		while (!failed)
+		{
+			if (!SkipRemainingMemberContent())
+				return false;
+
+			HeaderBlock header;
+			const size_t headerReadSize = fread(header.data(), 1, header.size(), inputStream);
+
+			// NOTE: Plenty of tools write truncated archives without the two trailing zero blocks, so a clean end of stream counts as the end too
+			if (headerReadSize == 0)
+				return false;
+			if (headerReadSize != header.size())
+				return Fail("Unexpected end of tar archive");
+			if (IsZeroBlock(header))
+				return false;
+
+			if (CalculateHeaderChecksum(header) != ReadNumericField(header, ChecksumOffset, ChecksumSize))
+				return Fail("Invalid tar header checksum");
+
+			const char typeFlag = static_cast<char>(header[TypeFlagOffset]);
+			memberContentSize = ReadNumericField(header, SizeOffset, SizeSize);
+			remainingSkipSize = PeepoHappy::Crypto::Align(memberContentSize, TarBlockSize);
+			memberContentAvailable = true;
+
+			if (typeFlag == GnuLongNameTypeFlag || typeFlag == PaxExtendedHeaderTypeFlag)
+			{
+				if (memberContentSize > MaxExtendedHeaderSize)
+					return Fail("Tar extended header too large");
+
+				std::string extendedHeader(static_cast<size_t>(memberContentSize), '\0');
+				if (!ReadMemberContent(reinterpret_cast<u8*>(extendedHeader.data()), extendedHeader.size()))
+					return false;
+
+				if (typeFlag == GnuLongNameTypeFlag)
+					extendedPath = std::string(extendedHeader.c_str());
+				else if (const std::string_view paxPath = FindPaxRecordValue(extendedHeader, "path"); !paxPath.empty())
+					extendedPath = std::string(paxPath);
+				continue;
+			}
+
+			if (!extendedPath.empty())
+			{
+				outMember.Path = std::move(extendedPath);
+			}
+			else
+			{
+				const std::string_view prefix = ReadStringField(header, PrefixOffset, PrefixSize);
+				const std::string_view name = ReadStringField(header, NameOffset, NameSize);
+				outMember.Path = prefix.empty() ? std::string(name) : (std::string(prefix) + "/" + std::string(name));
+			}
+
+			outMember.Size = memberContentSize;
+			outMember.ModificationTime = ReadNumericField(header, ModificationTimeOffset, ModificationTimeSize);
+			outMember.IsRegularFile = (typeFlag == RegularFileTypeFlag || typeFlag == '\0' || typeFlag == ContiguousFileTypeFlag);
+			return true;
+		}
+		return false;
+	}
+
+	bool TarReader::ReadMemberContent(u8* outContent, size_t contentSize)
+	{
+		if (failed || !memberContentAvailable || contentSize != memberContentSize)
+			return Fail("Unexpected tar member content read");
+
+		memberContentAvailable = false;
+		if (fread(outContent, 1, contentSize, inputStream) != contentSize)
+			return Fail("Unexpected end of tar archive");
+
+		remainingSkipSize -= contentSize;
+		return SkipRemainingMemberContent();
+	}
+
+	bool TarReader::HasFailed() const
+	{
+		return failed;
+	}
+
+	bool TarReader::SkipRemainingMemberContent()
+	{
+		// NOTE: Reading instead of seeking because the input might just as well be a pipe
+		std::array<u8, TarBlockSize * 16> discardBuffer;
+		while (remainingSkipSize > 0)
+		{
+			const size_t readSize = static_cast<size_t>(std::min<u64>(remainingSkipSize, discardBuffer.size()));
+			if (fread(discardBuffer.data(), 1, readSize, inputStream) != readSize)
+				return Fail("Unexpected end of tar archive");
+			remainingSkipSize -= readSize;
+		}
+
+		memberContentAvailable = false;
+		return true;
+	}
+
+	bool TarReader::Fail(const char* errorMessage)
+	{
+		if (!failed)
+			fprintf(stderr, "%s\n", errorMessage);
+
+		failed = true;
+		return false;
+	}
+
+	TarWriter::TarWriter(FILE* outputStream) : outputStream(outputStream)
+	{
+	}
+
+	bool TarWriter::WriteMember(std::string_view path, const u8* content, size_t contentSize, u64 modificationTime)
+	{
+		if (path.size() <= NameSize)
+			return WriteHeader(path, "", contentSize, modificationTime, RegularFileTypeFlag) && WriteContent(content, contentSize);
+
+		// NOTE: Split at the first separator that leaves a short enough name
+		for (size_t separator = path.find('/'); separator != std::string_view::npos && separator <= PrefixSize; separator = path.find('/', separator + 1))
+		{
+			const std::string_view name = path.substr(separator + 1);
+			if (!name.empty() && name.size() <= NameSize)
+				return WriteHeader(name, path.substr(0, separator), contentSize, modificationTime, RegularFileTypeFlag) && WriteContent(content, contentSize);
+		}
+
+		const std::string paxRecord = FormatPaxRecord("path", path);
+		return
+			WriteHeader("././@PaxHeader", "", paxRecord.size(), modificationTime, PaxExtendedHeaderTypeFlag) &&
+			WriteContent(reinterpret_cast<const u8*>(paxRecord.data()), paxRecord.size()) &&
+			WriteHeader(path.substr(0, NameSize), "", contentSize, modificationTime, RegularFileTypeFlag) &&
+			WriteContent(content, contentSize);
+	}
+
+	bool TarWriter::Finish()
+	{
+		const std::array<u8, TarBlockSize * 2> endOfArchiveBlocks = {};
+		if (fwrite(endOfArchiveBlocks.data(), 1, endOfArchiveBlocks.size(), outputStream) != endOfArchiveBlocks.size())
+			return false;
+
+		return (fflush(outputStream) == 0);
+	}
+
+	bool TarWriter::WriteHeader(std::string_view name, std::string_view prefix, u64 contentSize, u64 modificationTime, char typeFlag)
+	{
+		HeaderBlock header = {};
+		WriteStringField(header, NameOffset, NameSize, name);
+		WriteOctalField(header, ModeOffset, ModeSize, 0644);
+		WriteOctalField(header, UserIDOffset, UserIDSize, 0);
+		WriteOctalField(header, GroupIDOffset, GroupIDSize, 0);
+		if (!WriteOctalField(header, SizeOffset, SizeSize, contentSize) || !WriteOctalField(header, ModificationTimeOffset, ModificationTimeSize, modificationTime))
+			return false;
+		header[TypeFlagOffset] = static_cast<u8>(typeFlag);
+		WriteStringField(header, MagicOffset, MagicSize, std::string_view("ustar\0", MagicSize));
+		WriteStringField(header, VersionOffset, VersionSize, "00");
+		WriteStringField(header, PrefixOffset, PrefixSize, prefix);
+
+		// NOTE: Six octal digits followed by a null and a space, as written by GNU tar
+		WriteOctalField(header, ChecksumOffset, ChecksumSize - 1, CalculateHeaderChecksum(header));
+		header[ChecksumOffset + ChecksumSize - 1] = ' ';
+
+		return (fwrite(header.data(), 1, header.size(), outputStream) == header.size());
+	}
+
+	bool TarWriter::WriteContent(const u8* content, size_t contentSize)
+	{
+		const std::array<u8, TarBlockSize> zeroPadding = {};
+		const size_t paddingSize = PeepoHappy::Crypto::Align(contentSize, TarBlockSize) - contentSize;
+
+		return
+			(fwrite(content, 1, contentSize, outputStream) == contentSize) &&
+			(fwrite(zeroPadding.data(), 1, paddingSize, outputStream) == paddingSize);
+	}
+}
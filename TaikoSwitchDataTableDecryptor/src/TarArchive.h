@@ -0,0 +1,63 @@
+#pragma once
+#include "Types.h"
+#include "Utilities.h"
+#include <stdio.h>
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	constexpr size_t TarBlockSize = 512;
+
+	struct TarMember
+	{
+		// NOTE: Always using forward slashes, with the ustar prefix / GNU long name / pax path already applied
+		std::string Path;
+		u64 Size;
+		u64 ModificationTime;
+		bool IsRegularFile;
+	};
+
+	// NOTE: Reads a ustar (or GNU / pax) archive strictly front to back so that it can be consumed from a pipe without ever seeking.
+	//		 Member content that isn't read before moving on to the next member is skipped over automatically
+	class TarReader : NonCopyable
+	{
+	public:
+		explicit TarReader(FILE* inputStream);
+
+		// NOTE: Returns false at the end of the archive or once an error occurred, see HasFailed()
+		bool ReadNextMember(TarMember& outMember);
+		// NOTE: Reads exactly outMember.Size bytes of the current member and can only be called once per member
+		bool ReadMemberContent(u8* outContent, size_t contentSize);
+
+		bool HasFailed() const;
+
+	private:
+		bool SkipRemainingMemberContent();
+		bool Fail(const char* errorMessage);
+
+	private:
+		FILE* inputStream;
+		u64 memberContentSize = 0;
+		// NOTE: Content not read yet plus the zero padding up to the next block boundary
+		u64 remainingSkipSize = 0;
+		bool memberContentAvailable = false;
+		bool failed = false;
+	};
+
+	// NOTE: Writes a ustar archive front to back, only falling back to a pax extended header for paths too long to be split into a ustar prefix and name
+	class TarWriter : NonCopyable
+	{
+	public:
+		explicit TarWriter(FILE* outputStream);
+
+		bool WriteMember(std::string_view path, const u8* content, size_t contentSize, u64 modificationTime);
+		// NOTE: Writes the two zero blocks marking the end of the archive
+		bool Finish();
+
+	private:
+		bool WriteHeader(std::string_view name, std::string_view prefix, u64 contentSize, u64 modificationTime, char typeFlag);
+		bool WriteContent(const u8* content, size_t contentSize);
+
+	private:
+		FILE* outputStream;
+	};
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// NOTE: Buffer to buffer DataTable .bin <-> .json conversion as a plain C interface, for linking into other tools instead of spawning the executable per file.
+//		 Implemented on top of the same DataTable code the executable is built on (which is part of this library too), so both always produce identical output.
+//		 No files are touched and nothing is printed, other than BCrypt failures being reported to stderr. Contexts, codecs and output buffers are allocated
+//		 using the allocator of the context while the internal zlib streams and scratch memory use the process heap and expanded AES keys are cached per thread.
+//		 A context is immutable once created and can be shared by any number of threads. A codec holds the zlib stream reused between calls
+//		 and mustn't be used by multiple threads at the same time, so every thread should create its own
+
+// NOTE: Incremented whenever any of the declarations below change in an incompatible way
+#define TSDT_API_VERSION 1
+
+#define TSDT_AES_IV_SIZE 16
+#define TSDT_MAX_DATATABLE_SIZE 0x200000
+#define TSDT_NO_KEY (-1)
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	typedef enum TSDT_Result
+	{
+		TSDT_RESULT_SUCCESS = 0,
+		TSDT_RESULT_INVALID_ARGUMENT = 1,
+		TSDT_RESULT_OUT_OF_MEMORY = 2,
+		TSDT_RESULT_INPUT_TOO_SMALL = 3,
+		TSDT_RESULT_INPUT_TOO_LARGE = 4,
+		TSDT_RESULT_NO_MATCHING_KEY = 5,
+		TSDT_RESULT_CRYPTO_FAILURE = 6,
+		TSDT_RESULT_COMPRESSION_FAILURE = 7,
+	} TSDT_Result;
+
+	typedef enum TSDT_IVMode
+	{
+		// NOTE: The same 0xCC filled IV for every file
+		TSDT_IV_MODE_CONSTANT = 0,
+		// NOTE: HMAC-SHA256 of the compressed data (truncated to the IV size) keyed using an IV key derived from the encryption key
+		TSDT_IV_MODE_CONTENT = 1,
+		// NOTE: The IV specified by the caller, for example taken from the first bytes of the original .bin file
+		TSDT_IV_MODE_EXPLICIT = 2,
+	} TSDT_IVMode;
+
+	typedef struct TSDT_Allocator
+	{
+		// NOTE: Both may be called from any thread using a context created with this allocator
+		void* (*Allocate)(void* userData, size_t byteSize);
+		void (*Free)(void* userData, void* address, size_t byteSize);
+		void* UserData;
+	} TSDT_Allocator;
+
+	typedef struct TSDT_KeyDefinition
+	{
+		// NOTE: Null terminated, for example "jp_ver169"
+		const char* Name;
+		// NOTE: Either 16 (AES-128) or 32 (AES-256) bytes
+		const uint8_t* KeyBytes;
+		size_t KeyByteSize;
+	} TSDT_KeyDefinition;
+
+	typedef struct TSDT_EncodeOptions
+	{
+		// NOTE: TSDT_NO_KEY for unencrypted (gzip only) output
+		int32_t KeyIndex;
+		TSDT_IVMode IVMode;
+		// NOTE: Only used by TSDT_IV_MODE_EXPLICIT
+		uint8_t IV[TSDT_AES_IV_SIZE];
+	} TSDT_EncodeOptions;
+
+	// NOTE: Allocated using the allocator of the context and always followed by a null terminator that isn't included in the size
+	typedef struct TSDT_Buffer
+	{
+		uint8_t* Data;
+		size_t Size;
+	} TSDT_Buffer;
+
+	typedef struct TSDT_Context TSDT_Context;
+	typedef struct TSDT_Codec TSDT_Codec;
+
+	uint32_t TSDT_GetApiVersion(void);
+	const char* TSDT_GetResultName(TSDT_Result result);
+
+	// NOTE: A null allocator uses malloc / free. The key definitions are copied and don't have to outlive the context
+	TSDT_Result TSDT_CreateContext(const TSDT_Allocator* allocator, const TSDT_KeyDefinition* keyDefinitions, size_t keyCount, TSDT_Context** outContext);
+	void TSDT_DestroyContext(TSDT_Context* context);
+
+	size_t TSDT_GetKeyCount(const TSDT_Context* context);
+	// NOTE: Returns null for out of range indices
+	const char* TSDT_GetKeyName(const TSDT_Context* context, int32_t keyIndex);
+	// NOTE: Returns TSDT_NO_KEY if no key with the given name exists
+	int32_t TSDT_FindKey(const TSDT_Context* context, const char* keyName);
+
+	// NOTE: Must be destroyed before the context it was created from
+	TSDT_Result TSDT_CreateCodec(const TSDT_Context* context, TSDT_Codec** outCodec);
+	void TSDT_DestroyCodec(TSDT_Codec* codec);
+
+	// NOTE: Only decrypts the first block using every key in order until a GZip header is found.
+	//		 Sets the key index to TSDT_NO_KEY for unencrypted input
+	TSDT_Result TSDT_DetectKey(TSDT_Codec* codec, const uint8_t* binData, size_t binSize, int32_t* outKeyIndex);
+
+	// NOTE: The key index output is optional. The JSON buffer must be freed using TSDT_FreeBuffer()
+	TSDT_Result TSDT_Decode(TSDT_Codec* codec, const uint8_t* binData, size_t binSize, TSDT_Buffer* outJson, int32_t* outKeyIndex);
+	TSDT_Result TSDT_Encode(TSDT_Codec* codec, const uint8_t* jsonData, size_t jsonSize, const TSDT_EncodeOptions* options, TSDT_Buffer* outBin);
+
+	void TSDT_FreeBuffer(const TSDT_Context* context, TSDT_Buffer* buffer);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,365 @@
+#include "DataTable.h"
+#include "Statistics.h"
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	namespace
+	{
+		// NOTE: Opening the algorithm provider and expanding the key schedule costs more than decrypting the few bytes needed for key probing,
+		//		 so every thread keeps its own expanded keys around (BCrypt key handles mustn't be used by multiple threads at the same time).
+		//		 Returns null if the key couldn't be set up, which isn't cached so that the next call tries again
+		const PeepoHappy::Crypto::AesCbcKey* GetThisThreadExpandedKey(const NamedEncryptionKey& namedKey)
+		{
+			struct ExpandedKey
+			{
+				size_t KeyByteSize;
+				PeepoHappy::Crypto::Aes256KeyBytes KeyBytes;
+				std::unique_ptr<PeepoHappy::Crypto::AesCbcKey> Key;
+			};
+
+			thread_local std::vector<ExpandedKey> thisThreadExpandedKeys;
+
+			const u8* keyBytes = (namedKey.KeyByteSize == namedKey.Key256.size()) ? namedKey.Key256.data() : namedKey.Key128.data();
+			for (const ExpandedKey& expandedKey : thisThreadExpandedKeys)
+			{
+				if (expandedKey.KeyByteSize == namedKey.KeyByteSize && memcmp(expandedKey.KeyBytes.data(), keyBytes, namedKey.KeyByteSize) == 0)
+					return expandedKey.Key.get();
+			}
+
+			auto key = std::make_unique<PeepoHappy::Crypto::AesCbcKey>(keyBytes, namedKey.KeyByteSize);
+			if (!key->IsValid())
+				return nullptr;
+
+			ExpandedKey& newExpandedKey = thisThreadExpandedKeys.emplace_back();
+			newExpandedKey.KeyByteSize = namedKey.KeyByteSize;
+			memcpy(newExpandedKey.KeyBytes.data(), keyBytes, namedKey.KeyByteSize);
+			newExpandedKey.Key = std::move(key);
+			return newExpandedKey.Key.get();
+		}
+	}
+
+	bool DecryptUsingNamedKey(const NamedEncryptionKey& namedKey, const u8* inEncryptedData, u8* outDecryptedData, size_t inOutDataSize, PeepoHappy::Crypto::AesIVBytes iv)
+	{
+		assert(namedKey.KeyByteSize == namedKey.Key128.size() || namedKey.KeyByteSize == namedKey.Key256.size());
+		const PeepoHappy::Crypto::AesCbcKey* key = GetThisThreadExpandedKey(namedKey);
+		return (key != nullptr) && key->Decrypt(inEncryptedData, outDecryptedData, inOutDataSize, iv);
+	}
+
+	bool EncryptUsingNamedKey(const NamedEncryptionKey& namedKey, const u8* inDecryptedData, u8* outEncryptedData, size_t inOutDataSize, PeepoHappy::Crypto::AesIVBytes iv)
+	{
+		assert(namedKey.KeyByteSize == namedKey.Key128.size() || namedKey.KeyByteSize == namedKey.Key256.size());
+		const PeepoHappy::Crypto::AesCbcKey* key = GetThisThreadExpandedKey(namedKey);
+		return (key != nullptr) && key->Encrypt(inDecryptedData, outEncryptedData, inOutDataSize, iv);
+	}
+
+	IVMode ParseIVMode(std::string_view ivModeName)
+	{
+		for (size_t i = 0; i < IVModeNames.size(); i++)
+		{
+			if (PeepoHappy::ASCII::MatchesInsensitive(ivModeName, IVModeNames[i]))
+				return static_cast<IVMode>(i);
+		}
+		return IVMode::Count;
+	}
+
+	std::string FormatEncodingSettings(IVMode ivMode)
+	{
+		std::string settings { DataTableCompressionSettings };
+		settings += ";iv=";
+		settings += IVModeNames[static_cast<size_t>(ivMode)];
+
+		// NOTE: Content derived IVs used to be keyed using the encryption key itself, outputs written using the old derivation have to be rewritten
+		if (ivMode == IVMode::Content || ivMode == IVMode::Original)
+			settings += ";ivkey=derived";
+		return settings;
+	}
+
+	const NamedEncryptionKey* FindNamedEncryptionKey(const std::vector<NamedEncryptionKey>& namedKeys, std::string_view keyName)
+	{
+		auto foundKey = std::find_if(namedKeys.begin(), namedKeys.end(), [&](const NamedEncryptionKey& key) { return PeepoHappy::ASCII::Matches(key.Name, keyName); });
+		return (foundKey != namedKeys.end()) ? &(*foundKey) : nullptr;
+	}
+
+	u8 GetEncryptionPaddingByte(const NamedEncryptionKey& namedKey, size_t paddingSize)
+	{
+		return (namedKey.KeyByteSize == namedKey.Key256.size()) ? static_cast<u8>(paddingSize) : 0x00;
+	}
+
+	PeepoHappy::Crypto::AesIVBytes DeriveContentIV(const NamedEncryptionKey& namedKey, const u8* compressedData, size_t compressedDataSize)
+	{
+		// NOTE: The encryption key is never used as an HMAC key directly, a separate IV key is derived from it first
+		constexpr std::string_view ivKeyLabel = "TSDT content IV";
+
+		const u8* keyBytes = (namedKey.KeyByteSize == namedKey.Key256.size()) ? namedKey.Key256.data() : namedKey.Key128.data();
+		const PeepoHappy::Crypto::Sha256Digest ivKey = PeepoHappy::Crypto::HmacSha256(keyBytes, namedKey.KeyByteSize, reinterpret_cast<const u8*>(ivKeyLabel.data()), ivKeyLabel.size());
+		const PeepoHappy::Crypto::Sha256Digest digest = PeepoHappy::Crypto::HmacSha256(ivKey.data(), ivKey.size(), compressedData, compressedDataSize);
+
+		PeepoHappy::Crypto::AesIVBytes iv = {};
+		memcpy(iv.data(), digest.data(), iv.size());
+		return iv;
+	}
+
+	PeepoHappy::Crypto::AesIVBytes ChooseEncryptionIV(IVMode ivMode, const NamedEncryptionKey& namedKey, const u8* compressedData, size_t compressedDataSize, const PeepoHappy::Crypto::AesIVBytes* originalIV)
+	{
+		if (ivMode == IVMode::Original && originalIV != nullptr)
+			return *originalIV;
+
+		if (ivMode == IVMode::Content || ivMode == IVMode::Original)
+			return DeriveContentIV(namedKey, compressedData, compressedDataSize);
+
+		return ConstantEncryptionIV;
+	}
+
+	bool ReadEncryptionIVFromBinFile(std::string_view binFilePath, PeepoHappy::Crypto::AesIVBytes& outIV)
+	{
+		// NOTE: Read one byte past the IV to make sure the file also contains some encrypted data, unencrypted .bin files start with a GZip header instead
+		std::array<u8, PeepoHappy::Crypto::AesIVSize + 1> fileHead = {};
+		const size_t bytesRead = PeepoHappy::IO::ReadFileHead(binFilePath, fileHead.data(), fileHead.size());
+
+		if (bytesRead != fileHead.size() || PeepoHappy::Compression::HasValidGZipHeader(fileHead.data(), fileHead.size()))
+			return false;
+
+		memcpy(outIV.data(), fileHead.data(), outIV.size());
+		return true;
+	}
+
+	std::vector<NamedEncryptionKey> ReadAndParseEncrpytionKeysIniFile(PeepoHappy::Memory::TrackedBuffer& outIniFileContent)
+	{
+		std::vector<NamedEncryptionKey> namedKeys;
+
+#if 1 // NOTE: I think this makes more sense here, don't wanna fail to load the file just because of a different working directory
+		auto[iniFileContent, iniFileSize] = PeepoHappy::IO::ReadEntireFile(PeepoHappy::UTF8::GetExecutableDirectory() + "/" + std::string(EncrpytionKeysIniFileName));
+#else
+		auto[iniFileContent, iniFileSize] = PeepoHappy::IO::ReadEntireFile(EncrpytionKeysIniFileName);
+#endif
+
+		if (iniFileContent != nullptr)
+		{
+			const auto iniFileStringView = std::string_view(reinterpret_cast<const char*>(iniFileContent.get()), iniFileSize);
+
+			if (!PeepoHappy::UTF8::AppearsToUse8BitCodeUnits(iniFileStringView.substr(0, std::min<size_t>(32, iniFileStringView.size()))))
+				fprintf(stderr, "INI file does not appear to be UTF-8 encoded\n");
+
+			PeepoHappy::IO::ParseIniFileContent(iniFileStringView, [&namedKeys](std::string_view iniSection, std::string_view iniKey, std::string_view iniValue)
+			{
+				if (iniSection == "datatable_keys")
+				{
+					NamedEncryptionKey newKey;
+					newKey.Name = iniKey;
+					newKey.Key128 = PeepoHappy::Crypto::ParseAes128KeyHexByteString(iniValue);
+					newKey.Key256 = PeepoHappy::Crypto::ParseAes256KeyHexByteString(iniValue);
+
+					const bool upperHalfOf256KeyAllZeros = std::all_of(newKey.Key256.begin() + (PeepoHappy::Crypto::Aes256KeySize / 2), newKey.Key256.end(), [](u8 byte) { return byte == 0x00; });
+					newKey.KeyByteSize = upperHalfOf256KeyAllZeros ? PeepoHappy::Crypto::Aes128KeySize : PeepoHappy::Crypto::Aes256KeySize;
+
+					namedKeys.push_back(std::move(newKey));
+				}
+			});
+
+			if (namedKeys.empty())
+				fprintf(stderr, "No encrpytion key definition(s) found\n");
+		}
+		else
+		{
+			fprintf(stderr, "Failed to read '%.*s'\n", static_cast<int>(EncrpytionKeysIniFileName.size()), EncrpytionKeysIniFileName.data());
+		}
+
+		outIniFileContent = std::move(iniFileContent);
+		return namedKeys;
+	}
+
+	std::string FormatJsonOutputFilePathUsingNamedKey(std::string_view binFilePath, const NamedEncryptionKey* key)
+	{
+		std::string formattedFilePath { PeepoHappy::Path::TrimFileExtension(binFilePath) };
+		if (key != nullptr && !key->Name.empty())
+		{
+			formattedFilePath += " ";
+			formattedFilePath += key->Name;
+		}
+		formattedFilePath += ".json";
+		return formattedFilePath;
+	}
+
+	std::pair<std::string, const NamedEncryptionKey*> ParseJsonInputFilePathUsingNamedKeysAndFormatBinOutputFilePath(std::string_view jsonFilePath, const std::vector<NamedEncryptionKey>& namedKeys)
+	{
+		const auto fileNameWithoutExtension = PeepoHappy::Path::GetFileName(jsonFilePath, false);
+		const auto filePathWithoutExtension = PeepoHappy::Path::TrimFileExtension(jsonFilePath);
+
+		for (const auto& namedKey : namedKeys)
+		{
+			if (PeepoHappy::ASCII::EndsWithInsensitive(fileNameWithoutExtension, namedKey.Name))
+			{
+				const auto filePathWithoutKeySuffix = PeepoHappy::ASCII::TrimRight(filePathWithoutExtension.substr(0, filePathWithoutExtension.size() - namedKey.Name.size()));
+				return { std::string(filePathWithoutKeySuffix) + ".bin", &namedKey };
+			}
+		}
+		return { std::string(PeepoHappy::Path::TrimFileExtension(jsonFilePath)) + ".bin", nullptr };
+	}
+
+	const NamedEncryptionKey* TryOutAllAvailableEncrpytionKeysUntilGZipHeaderIsFound(const u8* encryptedFileContent, size_t fileSize, PeepoHappy::Crypto::AesIVBytes iv, const std::vector<NamedEncryptionKey>& namedKeys)
+	{
+		std::array<u8, 16> decryptedHeaderBuffer = {};
+		if (fileSize <= decryptedHeaderBuffer.size())
+			return nullptr;
+
+		// NOTE: ~~Backwards because newer version keys which are more likely to be used are most likely defined last~~
+		//		 turns out everyone already got into the habbit of placing new ones at the top
+		Statistics::ScopedStageTimer probeTimer(Statistics::Stage::Probe);
+		for (const NamedEncryptionKey& namedKey : namedKeys)
+		{
+			if (auto* stats = Statistics::ThisThreadFileStatistics; stats != nullptr)
+				stats->KeyProbeCount++;
+
+			decryptedHeaderBuffer = {};
+			if (!DecryptUsingNamedKey(namedKey, encryptedFileContent, decryptedHeaderBuffer.data(), decryptedHeaderBuffer.size(), iv))
+				return nullptr;
+
+			if (PeepoHappy::Compression::HasValidGZipHeader(decryptedHeaderBuffer.data(), decryptedHeaderBuffer.size()))
+				return &namedKey;
+		}
+
+		return nullptr;
+	}
+
+	DataTableStatus DetectEncryptionKey(const u8* binFileContent, size_t binFileSize, const std::vector<NamedEncryptionKey>& namedKeys, const NamedEncryptionKey*& outKey)
+	{
+		outKey = nullptr;
+		if (binFileSize <= 10)
+			return DataTableStatus::InputTooSmall;
+
+		if (PeepoHappy::Compression::HasValidGZipHeader(binFileContent, binFileSize))
+			return DataTableStatus::Success;
+
+		if (binFileSize <= (PeepoHappy::Crypto::AesIVSize + PeepoHappy::Crypto::AesBlockAlignment))
+			return DataTableStatus::InputTooSmall;
+
+		PeepoHappy::Crypto::AesIVBytes iv = {};
+		memcpy(iv.data(), binFileContent, iv.size());
+
+		outKey = TryOutAllAvailableEncrpytionKeysUntilGZipHeaderIsFound(binFileContent + iv.size(), binFileSize - iv.size(), iv, namedKeys);
+		return (outKey != nullptr) ? DataTableStatus::Success : DataTableStatus::NoMatchingKey;
+	}
+
+	DecodedJsonFile DecodeBinFileContent(const u8* binFileContent, size_t binFileSize, const std::vector<NamedEncryptionKey>& namedKeys)
+	{
+		DecodedJsonFile result = {};
+
+		if (binFileSize >= MaxDecompressedGameDataTableFileSize)
+		{
+			result.Status = DataTableStatus::InputTooLarge;
+			return result;
+		}
+
+		if (result.Status = DetectEncryptionKey(binFileContent, binFileSize, namedKeys, result.Key); result.Status != DataTableStatus::Success)
+			return result;
+
+		const u8* compressedData = binFileContent;
+		size_t compressedDataSize = binFileSize;
+		PeepoHappy::Memory::TrackedBuffer decryptedBuffer = nullptr;
+
+		if (result.Key != nullptr)
+		{
+			PeepoHappy::Crypto::AesIVBytes iv = {};
+			memcpy(iv.data(), binFileContent, iv.size());
+
+			compressedDataSize = (binFileSize - iv.size());
+			decryptedBuffer = PeepoHappy::Memory::MakeTrackedBuffer(compressedDataSize);
+			if (!Statistics::TimeStage(Statistics::Stage::Decrypt, DecryptUsingNamedKey, *result.Key, binFileContent + iv.size(), decryptedBuffer.get(), compressedDataSize, iv))
+			{
+				result.Status = DataTableStatus::DecryptionFailed;
+				return result;
+			}
+			compressedData = decryptedBuffer.get();
+		}
+
+		auto decompressedBuffer = PeepoHappy::Memory::MakeTrackedBuffer(MaxDecompressedGameDataTableFileSize);
+		if (!Statistics::TimeStage(Statistics::Stage::Inflate, PeepoHappy::Compression::Inflate, compressedData, compressedDataSize, decompressedBuffer.get(), MaxDecompressedGameDataTableFileSize))
+		{
+			result.Status = DataTableStatus::DecompressionFailed;
+			return result;
+		}
+
+		const size_t jsonLength = strnlen(reinterpret_cast<const char*>(decompressedBuffer.get()), MaxDecompressedGameDataTableFileSize);
+		if (jsonLength <= 0)
+		{
+			result.Status = DataTableStatus::EmptyJson;
+			return result;
+		}
+
+		if (auto* stats = Statistics::ThisThreadFileStatistics; stats != nullptr)
+		{
+			stats->CompressedBytes = compressedDataSize;
+			stats->DecompressedBytes = stats->BytesOut = jsonLength;
+		}
+
+		result.Json = std::string_view(reinterpret_cast<const char*>(decompressedBuffer.get()), jsonLength);
+		result.OwningBuffer = std::move(decompressedBuffer);
+		return result;
+	}
+
+	EncodedBinFile EncodeJsonFileContent(const u8* jsonFileContent, size_t jsonFileSize, const NamedEncryptionKey* key, IVMode ivMode, const PeepoHappy::Crypto::AesIVBytes* originalIV, PeepoHappy::Compression::Deflater* reusableDeflater)
+	{
+		EncodedBinFile result = {};
+
+		if (jsonFileSize <= 0)
+		{
+			result.Status = DataTableStatus::InputTooSmall;
+			return result;
+		}
+
+		if ((jsonFileSize + PeepoHappy::Crypto::AesIVSize) >= MaxDecompressedGameDataTableFileSize)
+		{
+			result.Status = DataTableStatus::InputTooLarge;
+			return result;
+		}
+
+		auto singleAllocationCombinedBuffers = PeepoHappy::Memory::MakeTrackedBuffer(MaxDecompressedGameDataTableFileSize * 2);
+		u8* compressedBuffer = (singleAllocationCombinedBuffers.get() + 0);
+		u8* encryptedBufferWithIV = (singleAllocationCombinedBuffers.get() + MaxDecompressedGameDataTableFileSize);
+		u8* encryptedBuffer = (encryptedBufferWithIV + PeepoHappy::Crypto::AesIVSize);
+
+		const size_t compressedSize = Statistics::TimeStage(Statistics::Stage::Deflate, [&]()
+		{
+			if (reusableDeflater != nullptr)
+				return reusableDeflater->Deflate(jsonFileContent, jsonFileSize, compressedBuffer, MaxDecompressedGameDataTableFileSize);
+			return PeepoHappy::Compression::Deflate(jsonFileContent, jsonFileSize, compressedBuffer, MaxDecompressedGameDataTableFileSize);
+		});
+		const size_t alignedSize = PeepoHappy::Crypto::Align(compressedSize, PeepoHappy::Crypto::AesBlockAlignment);
+		const size_t alignedSizeWithIV = (alignedSize + PeepoHappy::Crypto::AesIVSize);
+
+		if (compressedSize <= 0)
+		{
+			result.Status = DataTableStatus::CompressionFailed;
+			return result;
+		}
+
+		if (auto* stats = Statistics::ThisThreadFileStatistics; stats != nullptr)
+			stats->CompressedBytes = compressedSize;
+
+		if (key != nullptr)
+		{
+			// NOTE: The compressed data could technically be larger... but that seems highly unlikely for plain text JSON
+			if (alignedSizeWithIV > MaxDecompressedGameDataTableFileSize)
+			{
+				result.Status = DataTableStatus::InputTooLarge;
+				return result;
+			}
+
+			memset(compressedBuffer + compressedSize, GetEncryptionPaddingByte(*key, alignedSize - compressedSize), alignedSize - compressedSize);
+
+			const PeepoHappy::Crypto::AesIVBytes iv = ChooseEncryptionIV(ivMode, *key, compressedBuffer, alignedSize, originalIV);
+			memcpy(encryptedBufferWithIV, iv.data(), iv.size());
+
+			if (!Statistics::TimeStage(Statistics::Stage::Encrypt, EncryptUsingNamedKey, *key, compressedBuffer, encryptedBuffer, alignedSize, iv))
+			{
+				result.Status = DataTableStatus::EncryptionFailed;
+				return result;
+			}
+		}
+
+		result.Content = (key != nullptr) ? encryptedBufferWithIV : compressedBuffer;
+		result.Size = (key != nullptr) ? alignedSizeWithIV : compressedSize;
+		result.OwningBuffer = std::move(singleAllocationCombinedBuffers);
+		return result;
+	}
+}
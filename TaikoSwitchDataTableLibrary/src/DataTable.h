@@ -0,0 +1,136 @@
+#pragma once
+#include "Types.h"
+#include "Utilities.h"
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	// NOTE: Sucks for modders, makes sense for them to do it though...
+	constexpr size_t MaxDecompressedGameDataTableFileSize = 0x200000;
+
+	// NOTE: Identifies the settings used by PeepoHappy::Compression::Deflate() for the .json -> .bin conversion.
+	//		 Must be changed alongside them so that incremental builds know to rewrite all previously written output files
+	constexpr std::string_view DataTableCompressionSettings = "gzip;level=default;window=15;memlevel=8";
+
+	// NOTE: How the AES IV prepended to encrypted .bin files is chosen during the .json -> .bin conversion
+	enum class IVMode : u8
+	{
+		// NOTE: The same 0xCC filled IV for every file, which is what this program has always been using
+		Constant,
+		// NOTE: HMAC-SHA256 of the compressed data (truncated to the IV size) keyed using an IV key derived from the encryption key
+		//		 so that identical inputs produce byte identical outputs on every machine without all files sharing the same IV
+		Content,
+		// NOTE: Keeps the IV of the existing .bin file about to be overwritten (typically the original game file), falling back to Content
+		Original,
+		Count
+	};
+
+	constexpr std::array<const char*, static_cast<size_t>(IVMode::Count)> IVModeNames =
+	{
+		"constant",
+		"content",
+		"original",
+	};
+
+	// NOTE: Returns IVMode::Count for unknown names
+	IVMode ParseIVMode(std::string_view ivModeName);
+
+	// NOTE: Everything besides the input itself and the key which affects the content of the written .bin output files, for example:
+	//		 "gzip;level=default;window=15;memlevel=8;iv=content;ivkey=derived"
+	std::string FormatEncodingSettings(IVMode ivMode);
+
+	constexpr std::string_view EncrpytionKeysIniFileName = "TaikoSwitchDataTableEncrpytionKeys.ini";
+
+	struct NamedEncryptionKey
+	{
+		std::string_view Name;
+		size_t KeyByteSize;
+		PeepoHappy::Crypto::Aes128KeyBytes Key128;
+		PeepoHappy::Crypto::Aes256KeyBytes Key256;
+	};
+
+	bool DecryptUsingNamedKey(const NamedEncryptionKey& namedKey, const u8* inEncryptedData, u8* outDecryptedData, size_t inOutDataSize, PeepoHappy::Crypto::AesIVBytes iv);
+	bool EncryptUsingNamedKey(const NamedEncryptionKey& namedKey, const u8* inDecryptedData, u8* outEncryptedData, size_t inOutDataSize, PeepoHappy::Crypto::AesIVBytes iv);
+
+	const NamedEncryptionKey* FindNamedEncryptionKey(const std::vector<NamedEncryptionKey>& namedKeys, std::string_view keyName);
+
+	constexpr PeepoHappy::Crypto::AesIVBytes ConstantEncryptionIV = { 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC };
+
+	// NOTE: The compressed data is padded to the AES block size before being encrypted, using PKCS7 padding for 256-bit keys and zeros otherwise
+	u8 GetEncryptionPaddingByte(const NamedEncryptionKey& namedKey, size_t paddingSize);
+
+	// NOTE: Expects the compressed data to already include its alignment padding, exactly as it is about to be encrypted
+	PeepoHappy::Crypto::AesIVBytes DeriveContentIV(const NamedEncryptionKey& namedKey, const u8* compressedData, size_t compressedDataSize);
+	// NOTE: IVMode::Original uses the original IV if one is provided and falls back to IVMode::Content otherwise
+	PeepoHappy::Crypto::AesIVBytes ChooseEncryptionIV(IVMode ivMode, const NamedEncryptionKey& namedKey, const u8* compressedData, size_t compressedDataSize, const PeepoHappy::Crypto::AesIVBytes* originalIV);
+	// NOTE: Reads the IV of the existing .bin file (typically the original game file about to be overwritten), returns false if it doesn't exist or isn't encrypted
+	bool ReadEncryptionIVFromBinFile(std::string_view binFilePath, PeepoHappy::Crypto::AesIVBytes& outIV);
+
+	// NOTE: The returned key names point into the ini file content, which therefore has to outlive them
+	std::vector<NamedEncryptionKey> ReadAndParseEncrpytionKeysIniFile(PeepoHappy::Memory::TrackedBuffer& outIniFileContent);
+
+	// NOTE: { "datatable/musicinfo.bin", NamedKey{"jp_ver169", ...} } -> "datatable/musicinfo jp_ver169.json"
+	std::string FormatJsonOutputFilePathUsingNamedKey(std::string_view binFilePath, const NamedEncryptionKey* key);
+
+	// NOTE: ("datatable/musicinfo jp_ver169.json") -> { "datatable/musicinfo.bin", NamedKey{"jp_ver169", ...} } 
+	std::pair<std::string, const NamedEncryptionKey*> ParseJsonInputFilePathUsingNamedKeysAndFormatBinOutputFilePath(std::string_view jsonFilePath, const std::vector<NamedEncryptionKey>& namedKeys);
+
+	// NOTE: Only decrypts the first block using every key in order, returns null if none of them results in a GZip header
+	const NamedEncryptionKey* TryOutAllAvailableEncrpytionKeysUntilGZipHeaderIsFound(const u8* encryptedFileContent, size_t fileSize, PeepoHappy::Crypto::AesIVBytes iv, const std::vector<NamedEncryptionKey>& namedKeys);
+
+	// NOTE: Why a .bin <-> .json conversion failed. None of the functions below print anything so that they can be shared with the library,
+	//		 which leaves reporting the failure to the caller
+	enum class DataTableStatus : u8
+	{
+		Success,
+		InputTooSmall,
+		InputTooLarge,
+		NoMatchingKey,
+		DecryptionFailed,
+		DecompressionFailed,
+		EmptyJson,
+		CompressionFailed,
+		EncryptionFailed,
+		Count
+	};
+
+	constexpr std::array<const char*, static_cast<size_t>(DataTableStatus::Count)> DataTableStatusMessages =
+	{
+		"Success",
+		"Unexpected end of file",
+		"Input file too large. DataTable files are limited to 2MB",
+		"No matching encrpytion key definition found",
+		"Failed to decrypt",
+		"Failed to decompress",
+		"Empty json... did decompression fail?",
+		"Failed to compress",
+		"Failed to encrypt",
+	};
+
+	constexpr const char* GetDataTableStatusMessage(DataTableStatus status) { return DataTableStatusMessages[static_cast<size_t>(status)]; }
+
+	// NOTE: Sets the key to null for unencrypted (GZip only) content
+	DataTableStatus DetectEncryptionKey(const u8* binFileContent, size_t binFileSize, const std::vector<NamedEncryptionKey>& namedKeys, const NamedEncryptionKey*& outKey);
+
+	struct DecodedJsonFile
+	{
+		PeepoHappy::Memory::TrackedBuffer OwningBuffer;
+		std::string_view Json;
+		const NamedEncryptionKey* Key;
+		DataTableStatus Status;
+	};
+
+	// NOTE: Decrypts (after finding a matching key) and decompresses the .bin file content entirely in memory, the JSON is empty on failure
+	DecodedJsonFile DecodeBinFileContent(const u8* binFileContent, size_t binFileSize, const std::vector<NamedEncryptionKey>& namedKeys);
+
+	struct EncodedBinFile
+	{
+		PeepoHappy::Memory::TrackedBuffer OwningBuffer;
+		const u8* Content;
+		size_t Size;
+		DataTableStatus Status;
+	};
+
+	// NOTE: Compresses and (if a key is provided) encrypts the JSON file content entirely in memory, the content is null on failure.
+	//		 A reusable deflater can optionally be provided to avoid reinitializing the zlib stream state for every file
+	EncodedBinFile EncodeJsonFileContent(const u8* jsonFileContent, size_t jsonFileSize, const NamedEncryptionKey* key, IVMode ivMode, const PeepoHappy::Crypto::AesIVBytes* originalIV, PeepoHappy::Compression::Deflater* reusableDeflater);
+}
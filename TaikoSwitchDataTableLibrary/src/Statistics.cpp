@@ -0,0 +1,297 @@
+#include "Statistics.h"
+#include "Utilities.h"
+#include <atomic>
+#include <mutex>
+#include <deque>
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	namespace Statistics
+	{
+		namespace
+		{
+			std::atomic<bool> GlobalEnabled = false;
+			std::atomic<bool> GlobalTracingEnabled = false;
+
+			std::mutex GlobalFilesMutex;
+			std::deque<FileStatistics> GlobalFiles;
+
+			std::atomic<i64> GlobalLiveAllocatedBytes = 0;
+			std::atomic<i64> GlobalPeakAllocatedBytes = 0;
+
+			void OnTrackedAllocation(i64 byteSizeDelta)
+			{
+				const i64 liveBytes = (GlobalLiveAllocatedBytes += byteSizeDelta);
+				for (i64 peakBytes = GlobalPeakAllocatedBytes; liveBytes > peakBytes;)
+				{
+					if (GlobalPeakAllocatedBytes.compare_exchange_weak(peakBytes, liveBytes))
+						break;
+				}
+
+				FileStatistics* stats = ThisThreadFileStatistics;
+				if (stats == nullptr)
+					return;
+
+				stats->LiveAllocatedBytes += byteSizeDelta;
+				if (byteSizeDelta > 0)
+				{
+					const size_t stageIndex = std::min(static_cast<size_t>(ThisThreadStage), OtherStageAllocationIndex);
+					stats->StageAllocationCounts[stageIndex]++;
+					stats->StageAllocatedBytes[stageIndex] += static_cast<u64>(byteSizeDelta);
+					stats->PeakAllocatedBytes = std::max(stats->PeakAllocatedBytes, stats->LiveAllocatedBytes);
+				}
+			}
+
+			std::chrono::steady_clock::time_point GlobalBatchStartTime;
+			u64 GlobalBatchNanoseconds = 0;
+
+			// NOTE: Once full the oldest events of a thread get overwritten, which should only ever happen for absurdly large batches
+			constexpr size_t TraceEventsPerThread = 0x10000;
+
+			struct TraceEvent
+			{
+				std::chrono::steady_clock::time_point Time;
+				const FileStatistics* File;
+				Stage EventStage;
+				TracePhase Phase;
+			};
+
+			struct ThreadTraceBuffer
+			{
+				u32 ThreadIndex;
+				u64 TotalEventsWritten;
+				std::unique_ptr<TraceEvent[]> Events;
+			};
+
+			std::chrono::steady_clock::time_point GlobalTraceStartTime;
+			std::mutex GlobalTraceBuffersMutex;
+			std::vector<std::unique_ptr<ThreadTraceBuffer>> GlobalTraceBuffers;
+
+			ThreadTraceBuffer& GetThisThreadTraceBuffer()
+			{
+				// NOTE: Owned by the global list so that events of already exited worker threads can still be exported
+				thread_local ThreadTraceBuffer* threadBuffer = nullptr;
+				if (threadBuffer == nullptr)
+				{
+					auto newBuffer = std::make_unique<ThreadTraceBuffer>();
+					newBuffer->Events = std::make_unique<TraceEvent[]>(TraceEventsPerThread);
+
+					const auto lock = std::scoped_lock(GlobalTraceBuffersMutex);
+					newBuffer->ThreadIndex = static_cast<u32>(GlobalTraceBuffers.size());
+					threadBuffer = GlobalTraceBuffers.emplace_back(std::move(newBuffer)).get();
+				}
+				return *threadBuffer;
+			}
+
+			void AppendJsonEscapedString(std::string& out, std::string_view value)
+			{
+				out += '"';
+				for (const char c : value)
+				{
+					if (c == '"' || c == '\\')
+					{
+						out += '\\';
+						out += c;
+					}
+					else if (static_cast<u8>(c) < 0x20)
+					{
+						char escapeBuffer[8];
+						sprintf_s(escapeBuffer, "\\u%04X", static_cast<u32>(c));
+						out += escapeBuffer;
+					}
+					else
+					{
+						out += c;
+					}
+				}
+				out += '"';
+			}
+
+			void AppendJsonStatisticsFields(std::string& out, const FileStatistics& stats, std::string_view indent)
+			{
+				char buffer[256];
+				const f64 compressionRatio = (stats.DecompressedBytes > 0) ? (static_cast<f64>(stats.CompressedBytes) / static_cast<f64>(stats.DecompressedBytes)) : 0.0;
+
+				sprintf_s(buffer, "%.*s\"bytes_in\": %llu,\n", static_cast<int>(indent.size()), indent.data(), static_cast<unsigned long long>(stats.BytesIn)); out += buffer;
+				sprintf_s(buffer, "%.*s\"bytes_out\": %llu,\n", static_cast<int>(indent.size()), indent.data(), static_cast<unsigned long long>(stats.BytesOut)); out += buffer;
+				sprintf_s(buffer, "%.*s\"compressed_bytes\": %llu,\n", static_cast<int>(indent.size()), indent.data(), static_cast<unsigned long long>(stats.CompressedBytes)); out += buffer;
+				sprintf_s(buffer, "%.*s\"decompressed_bytes\": %llu,\n", static_cast<int>(indent.size()), indent.data(), static_cast<unsigned long long>(stats.DecompressedBytes)); out += buffer;
+				sprintf_s(buffer, "%.*s\"compression_ratio\": %.6f,\n", static_cast<int>(indent.size()), indent.data(), compressionRatio); out += buffer;
+				sprintf_s(buffer, "%.*s\"key_probes\": %u,\n", static_cast<int>(indent.size()), indent.data(), stats.KeyProbeCount); out += buffer;
+				sprintf_s(buffer, "%.*s\"peak_alloc_bytes\": %lld,\n", static_cast<int>(indent.size()), indent.data(), static_cast<long long>(stats.PeakAllocatedBytes)); out += buffer;
+
+				auto appendStageArray = [&](const char* name, auto& perStageValues, bool includeOtherStage)
+				{
+					sprintf_s(buffer, "%.*s\"%s\": {", static_cast<int>(indent.size()), indent.data(), name); out += buffer;
+					for (size_t i = 0; i < StageNames.size(); i++)
+					{
+						sprintf_s(buffer, "%s\"%s\": %llu", (i > 0) ? ", " : " ", StageNames[i], static_cast<unsigned long long>(perStageValues[i]));
+						out += buffer;
+					}
+					if (includeOtherStage)
+					{
+						sprintf_s(buffer, ", \"%s\": %llu", OtherStageName, static_cast<unsigned long long>(perStageValues[OtherStageAllocationIndex]));
+						out += buffer;
+					}
+					out += " }";
+				};
+
+				appendStageArray("stage_alloc_count", stats.StageAllocationCounts, true);
+				out += ",\n";
+				appendStageArray("stage_alloc_bytes", stats.StageAllocatedBytes, true);
+				out += ",\n";
+				appendStageArray("stage_ns", stats.StageNanoseconds, false);
+				out += "\n";
+			}
+		}
+
+		void Enable()
+		{
+			GlobalEnabled = true;
+			PeepoHappy::Memory::SetAllocationHook(OnTrackedAllocation);
+		}
+
+		bool IsEnabled()
+		{
+			return GlobalEnabled;
+		}
+
+		void EnableTracing()
+		{
+			GlobalTraceStartTime = std::chrono::steady_clock::now();
+			GlobalTracingEnabled = true;
+		}
+
+		bool IsTracingEnabled()
+		{
+			return GlobalTracingEnabled;
+		}
+
+		void RecordTraceEvent(TracePhase phase, Stage stage, const FileStatistics* file, std::chrono::steady_clock::time_point time)
+		{
+			ThreadTraceBuffer& buffer = GetThisThreadTraceBuffer();
+			buffer.Events[buffer.TotalEventsWritten++ % TraceEventsPerThread] = TraceEvent { time, file, stage, phase };
+		}
+
+		FileStatistics* BeginFile(std::string_view filePath)
+		{
+			if (!GlobalEnabled && !GlobalTracingEnabled)
+				return nullptr;
+
+			const auto lock = std::scoped_lock(GlobalFilesMutex);
+			FileStatistics& newStats = GlobalFiles.emplace_back();
+			newStats.FilePath = filePath;
+			return &newStats;
+		}
+
+		void BeginBatch()
+		{
+			GlobalBatchStartTime = std::chrono::steady_clock::now();
+		}
+
+		void EndBatch()
+		{
+			GlobalBatchNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - GlobalBatchStartTime).count();
+		}
+
+		bool WriteJsonReport(std::string_view jsonOutputFilePath)
+		{
+			const auto lock = std::scoped_lock(GlobalFilesMutex);
+
+			FileStatistics batchStats = {};
+			i64 maxFilePeakAllocatedBytes = 0;
+			for (const FileStatistics& fileStats : GlobalFiles)
+			{
+				batchStats.BytesIn += fileStats.BytesIn;
+				batchStats.BytesOut += fileStats.BytesOut;
+				batchStats.CompressedBytes += fileStats.CompressedBytes;
+				batchStats.DecompressedBytes += fileStats.DecompressedBytes;
+				batchStats.KeyProbeCount += fileStats.KeyProbeCount;
+				for (size_t i = 0; i < batchStats.StageNanoseconds.size(); i++)
+					batchStats.StageNanoseconds[i] += fileStats.StageNanoseconds[i];
+				for (size_t i = 0; i < batchStats.StageAllocationCounts.size(); i++)
+					batchStats.StageAllocationCounts[i] += fileStats.StageAllocationCounts[i];
+				for (size_t i = 0; i < batchStats.StageAllocatedBytes.size(); i++)
+					batchStats.StageAllocatedBytes[i] += fileStats.StageAllocatedBytes[i];
+				maxFilePeakAllocatedBytes = std::max(maxFilePeakAllocatedBytes, fileStats.PeakAllocatedBytes);
+			}
+
+			// NOTE: Unlike for individual files this is the peak across all concurrently processed files (and anything in between)
+			batchStats.PeakAllocatedBytes = GlobalPeakAllocatedBytes;
+
+			char buffer[128];
+			std::string json;
+			json.reserve(512 + (GlobalFiles.size() * 512));
+
+			json += "{\n";
+			json += "\t\"batch\": {\n";
+			sprintf_s(buffer, "\t\t\"file_count\": %zu,\n", GlobalFiles.size()); json += buffer;
+			sprintf_s(buffer, "\t\t\"wall_ns\": %llu,\n", static_cast<unsigned long long>(GlobalBatchNanoseconds)); json += buffer;
+			sprintf_s(buffer, "\t\t\"max_file_peak_alloc_bytes\": %lld,\n", static_cast<long long>(maxFilePeakAllocatedBytes)); json += buffer;
+			AppendJsonStatisticsFields(json, batchStats, "\t\t");
+			json += "\t},\n";
+			json += "\t\"files\": [\n";
+
+			for (size_t fileIndex = 0; fileIndex < GlobalFiles.size(); fileIndex++)
+			{
+				json += "\t\t{\n";
+				json += "\t\t\t\"path\": ";
+				AppendJsonEscapedString(json, GlobalFiles[fileIndex].FilePath);
+				json += ",\n";
+				AppendJsonStatisticsFields(json, GlobalFiles[fileIndex], "\t\t\t");
+				json += ((fileIndex + 1) < GlobalFiles.size()) ? "\t\t},\n" : "\t\t}\n";
+			}
+
+			json += "\t]\n";
+			json += "}\n";
+
+			return PeepoHappy::IO::WriteEntireFile(jsonOutputFilePath, reinterpret_cast<const u8*>(json.data()), json.size());
+		}
+
+		bool WriteChromeTraceReport(std::string_view jsonOutputFilePath)
+		{
+			const auto lock = std::scoped_lock(GlobalTraceBuffersMutex);
+
+			char buffer[128];
+			std::string json;
+			json.reserve(64 + (GlobalTraceBuffers.size() * 128));
+			json += "{\"traceEvents\":[\n";
+
+			bool firstEvent = true;
+			for (const auto& threadBuffer : GlobalTraceBuffers)
+			{
+				const u64 eventCount = std::min<u64>(threadBuffer->TotalEventsWritten, TraceEventsPerThread);
+				const u64 firstEventIndex = (threadBuffer->TotalEventsWritten - eventCount);
+
+				for (u64 i = firstEventIndex; i < threadBuffer->TotalEventsWritten; i++)
+				{
+					const TraceEvent& event = threadBuffer->Events[i % TraceEventsPerThread];
+					const f64 timestampMicroseconds = std::chrono::duration<f64, std::micro>(event.Time - GlobalTraceStartTime).count();
+
+					json += firstEvent ? "" : ",\n";
+					json += "{\"name\":";
+					if (event.EventStage != Stage::Count)
+						AppendJsonEscapedString(json, StageNames[static_cast<size_t>(event.EventStage)]);
+					else
+						AppendJsonEscapedString(json, PeepoHappy::Path::GetFileName(event.File->FilePath));
+
+					sprintf_s(buffer, ",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u", (event.EventStage != Stage::Count) ? "stage" : "file", static_cast<char>(event.Phase), timestampMicroseconds, threadBuffer->ThreadIndex);
+					json += buffer;
+
+					if (event.EventStage == Stage::Count && event.Phase == TracePhase::Begin)
+					{
+						json += ",\"args\":{\"path\":";
+						AppendJsonEscapedString(json, event.File->FilePath);
+						json += "}";
+					}
+
+					json += "}";
+					firstEvent = false;
+				}
+			}
+
+			json += "\n]}\n";
+			return PeepoHappy::IO::WriteEntireFile(jsonOutputFilePath, reinterpret_cast<const u8*>(json.data()), json.size());
+		}
+	}
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include "Types.h"
+#include <chrono>
+
+namespace TaikoSwitchDataTableDecryptor
+{
+	namespace Statistics
+	{
+		enum class Stage : u8
+		{
+			Read,
+			Probe,
+			Decrypt,
+			Inflate,
+			Deflate,
+			Encrypt,
+			Write,
+			Verify,
+			Count
+		};
+
+		constexpr std::array<const char*, static_cast<size_t>(Stage::Count)> StageNames =
+		{
+			"read",
+			"probe",
+			"decrypt",
+			"inflate",
+			"deflate",
+			"encrypt",
+			"write",
+			"verify",
+		};
+
+		// NOTE: Allocations made outside of any stage are counted towards this additional entry
+		constexpr size_t OtherStageAllocationIndex = static_cast<size_t>(Stage::Count);
+		constexpr const char* OtherStageName = "other";
+
+		struct FileStatistics
+		{
+			std::string FilePath;
+			u64 BytesIn;
+			u64 BytesOut;
+			u64 CompressedBytes;
+			u64 DecompressedBytes;
+			u32 KeyProbeCount;
+			std::array<u64, static_cast<size_t>(Stage::Count)> StageNanoseconds;
+			std::array<u64, static_cast<size_t>(Stage::Count) + 1> StageAllocationCounts;
+			std::array<u64, static_cast<size_t>(Stage::Count) + 1> StageAllocatedBytes;
+			i64 LiveAllocatedBytes;
+			i64 PeakAllocatedBytes;
+		};
+
+		// NOTE: Collection is disabled by default in which case BeginFile() returns null and all of the scoped helpers below
+		//		 reduce to a single thread local pointer check. Enabling also installs a PeepoHappy::Memory allocation hook
+		//		 so that tracked buffer, zlib and crypto object allocations get attributed to the current file and stage
+		void Enable();
+		bool IsEnabled();
+
+		// NOTE: Additionally records begin/end events of every file and stage into per-thread ring buffers
+		//		 (so that worker threads never have to synchronize) to be exported in the Chrome trace event format
+		void EnableTracing();
+		bool IsTracingEnabled();
+
+		enum class TracePhase : char { Begin = 'B', End = 'E' };
+
+		// NOTE: Uses the stage name if stage != Stage::Count, otherwise the file path
+		void RecordTraceEvent(TracePhase phase, Stage stage, const FileStatistics* file, std::chrono::steady_clock::time_point time);
+
+		// NOTE: Returned pointers stay valid until the end of the program
+		FileStatistics* BeginFile(std::string_view filePath);
+
+		void BeginBatch();
+		void EndBatch();
+
+		bool WriteJsonReport(std::string_view jsonOutputFilePath);
+		bool WriteChromeTraceReport(std::string_view jsonOutputFilePath);
+
+		// NOTE: The file statistics the current thread is recording into (if any)
+		inline thread_local FileStatistics* ThisThreadFileStatistics = nullptr;
+		inline thread_local Stage ThisThreadStage = Stage::Count;
+
+		struct ScopedFileStatistics : NonCopyable
+		{
+			FileStatistics* const Previous;
+
+			ScopedFileStatistics(FileStatistics* fileStatistics) : Previous(ThisThreadFileStatistics)
+			{
+				ThisThreadFileStatistics = fileStatistics;
+				if (fileStatistics != nullptr && IsTracingEnabled())
+					RecordTraceEvent(TracePhase::Begin, Stage::Count, fileStatistics, std::chrono::steady_clock::now());
+			}
+
+			~ScopedFileStatistics()
+			{
+				if (ThisThreadFileStatistics != nullptr && IsTracingEnabled())
+					RecordTraceEvent(TracePhase::End, Stage::Count, ThisThreadFileStatistics, std::chrono::steady_clock::now());
+				ThisThreadFileStatistics = Previous;
+			}
+		};
+
+		struct ScopedStageTimer : NonCopyable
+		{
+			FileStatistics* const Target;
+			const Stage TimedStage;
+			const Stage PreviousStage;
+			std::chrono::steady_clock::time_point StartTime;
+
+			ScopedStageTimer(Stage stage) : Target(ThisThreadFileStatistics), TimedStage(stage), PreviousStage(ThisThreadStage)
+			{
+				if (Target == nullptr)
+					return;
+
+				ThisThreadStage = TimedStage;
+				StartTime = std::chrono::steady_clock::now();
+				if (IsTracingEnabled())
+					RecordTraceEvent(TracePhase::Begin, TimedStage, Target, StartTime);
+			}
+
+			~ScopedStageTimer()
+			{
+				if (Target == nullptr)
+					return;
+
+				const auto endTime = std::chrono::steady_clock::now();
+				Target->StageNanoseconds[static_cast<size_t>(TimedStage)] += std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - StartTime).count();
+				if (IsTracingEnabled())
+					RecordTraceEvent(TracePhase::End, TimedStage, Target, endTime);
+
+				ThisThreadStage = PreviousStage;
+			}
+		};
+
+		// NOTE: For timing function calls whose result can't easily be declared outside of a scope, such as structured bindings
+		template <typename Func, typename... Args>
+		auto TimeStage(Stage stage, Func func, Args&&... args)
+		{
+			ScopedStageTimer timer(stage);
+			return func(std::forward<Args>(args)...);
+		}
+	}
+}
@@ -0,0 +1,268 @@
+#include "TaikoSwitchDataTable.h"
+#include "DataTable.h"
+#include <new>
+
+using namespace TaikoSwitchDataTableDecryptor;
+
+// NOTE: Only a thin C interface on top of the same DataTable code the executable itself is built on,
+//		 so that there is exactly one implementation of the file format
+static_assert(TSDT_MAX_DATATABLE_SIZE == MaxDecompressedGameDataTableFileSize);
+static_assert(TSDT_AES_IV_SIZE == PeepoHappy::Crypto::AesIVSize);
+
+namespace
+{
+	void* DefaultAllocate(void* userData, size_t byteSize)
+	{
+		return malloc(byteSize);
+	}
+
+	void DefaultFree(void* userData, void* address, size_t byteSize)
+	{
+		free(address);
+	}
+
+	void* Allocate(const TSDT_Allocator& allocator, size_t byteSize)
+	{
+		void* address = allocator.Allocate(allocator.UserData, byteSize);
+		if (address != nullptr)
+			memset(address, 0, byteSize);
+		return address;
+	}
+
+	void Free(const TSDT_Allocator& allocator, void* address, size_t byteSize)
+	{
+		if (address != nullptr)
+			allocator.Free(allocator.UserData, address, byteSize);
+	}
+
+	TSDT_Result ToResult(DataTableStatus status)
+	{
+		switch (status)
+		{
+		case DataTableStatus::Success: return TSDT_RESULT_SUCCESS;
+		case DataTableStatus::InputTooSmall: return TSDT_RESULT_INPUT_TOO_SMALL;
+		case DataTableStatus::InputTooLarge: return TSDT_RESULT_INPUT_TOO_LARGE;
+		case DataTableStatus::NoMatchingKey: return TSDT_RESULT_NO_MATCHING_KEY;
+		case DataTableStatus::DecryptionFailed: return TSDT_RESULT_CRYPTO_FAILURE;
+		case DataTableStatus::EncryptionFailed: return TSDT_RESULT_CRYPTO_FAILURE;
+		default: return TSDT_RESULT_COMPRESSION_FAILURE;
+		}
+	}
+
+	TSDT_Result CopyIntoOutputBuffer(const TSDT_Allocator& allocator, const void* data, size_t size, TSDT_Buffer* outBuffer)
+	{
+		outBuffer->Data = static_cast<uint8_t*>(Allocate(allocator, size + 1));
+		if (outBuffer->Data == nullptr)
+			return TSDT_RESULT_OUT_OF_MEMORY;
+
+		memcpy(outBuffer->Data, data, size);
+		outBuffer->Size = size;
+		return TSDT_RESULT_SUCCESS;
+	}
+}
+
+struct TSDT_Context
+{
+	TSDT_Allocator Allocator;
+	// NOTE: Reserved upfront so that the key names (pointing into these) stay valid
+	std::vector<std::string> KeyNames;
+	std::vector<NamedEncryptionKey> Keys;
+};
+
+struct TSDT_Codec
+{
+	const TSDT_Context* Context;
+	PeepoHappy::Compression::Deflater ReusableDeflater;
+};
+
+extern "C"
+{
+	uint32_t TSDT_GetApiVersion(void)
+	{
+		return TSDT_API_VERSION;
+	}
+
+	const char* TSDT_GetResultName(TSDT_Result result)
+	{
+		switch (result)
+		{
+		case TSDT_RESULT_SUCCESS: return "Success";
+		case TSDT_RESULT_INVALID_ARGUMENT: return "Invalid argument";
+		case TSDT_RESULT_OUT_OF_MEMORY: return "Out of memory";
+		case TSDT_RESULT_INPUT_TOO_SMALL: return "Input too small";
+		case TSDT_RESULT_INPUT_TOO_LARGE: return "Input too large";
+		case TSDT_RESULT_NO_MATCHING_KEY: return "No matching key";
+		case TSDT_RESULT_CRYPTO_FAILURE: return "Crypto failure";
+		case TSDT_RESULT_COMPRESSION_FAILURE: return "Compression failure";
+		default: return "Unknown result";
+		}
+	}
+
+	TSDT_Result TSDT_CreateContext(const TSDT_Allocator* allocator, const TSDT_KeyDefinition* keyDefinitions, size_t keyCount, TSDT_Context** outContext)
+	{
+		if (outContext == nullptr || (keyDefinitions == nullptr && keyCount > 0))
+			return TSDT_RESULT_INVALID_ARGUMENT;
+
+		*outContext = nullptr;
+		if (allocator != nullptr && (allocator->Allocate == nullptr || allocator->Free == nullptr))
+			return TSDT_RESULT_INVALID_ARGUMENT;
+
+		for (size_t i = 0; i < keyCount; i++)
+		{
+			const TSDT_KeyDefinition& definition = keyDefinitions[i];
+			if (definition.Name == nullptr || definition.KeyBytes == nullptr || (definition.KeyByteSize != PeepoHappy::Crypto::Aes128KeySize && definition.KeyByteSize != PeepoHappy::Crypto::Aes256KeySize))
+				return TSDT_RESULT_INVALID_ARGUMENT;
+		}
+
+		const TSDT_Allocator resolvedAllocator = (allocator != nullptr) ? *allocator : TSDT_Allocator { DefaultAllocate, DefaultFree, nullptr };
+
+		void* contextAllocation = Allocate(resolvedAllocator, sizeof(TSDT_Context));
+		if (contextAllocation == nullptr)
+			return TSDT_RESULT_OUT_OF_MEMORY;
+
+		TSDT_Context* context = new (contextAllocation) TSDT_Context();
+		context->Allocator = resolvedAllocator;
+		context->KeyNames.reserve(keyCount);
+		context->Keys.reserve(keyCount);
+
+		for (size_t i = 0; i < keyCount; i++)
+		{
+			const TSDT_KeyDefinition& definition = keyDefinitions[i];
+
+			NamedEncryptionKey& key = context->Keys.emplace_back();
+			key.Name = context->KeyNames.emplace_back(definition.Name);
+			key.KeyByteSize = definition.KeyByteSize;
+			memcpy((definition.KeyByteSize == key.Key256.size()) ? key.Key256.data() : key.Key128.data(), definition.KeyBytes, definition.KeyByteSize);
+		}
+
+		*outContext = context;
+		return TSDT_RESULT_SUCCESS;
+	}
+
+	void TSDT_DestroyContext(TSDT_Context* context)
+	{
+		if (context == nullptr)
+			return;
+
+		const TSDT_Allocator allocator = context->Allocator;
+		context->~TSDT_Context();
+		Free(allocator, context, sizeof(TSDT_Context));
+	}
+
+	size_t TSDT_GetKeyCount(const TSDT_Context* context)
+	{
+		return (context != nullptr) ? context->Keys.size() : 0;
+	}
+
+	const char* TSDT_GetKeyName(const TSDT_Context* context, int32_t keyIndex)
+	{
+		if (context == nullptr || keyIndex < 0 || static_cast<size_t>(keyIndex) >= context->Keys.size())
+			return nullptr;
+
+		return context->KeyNames[keyIndex].c_str();
+	}
+
+	int32_t TSDT_FindKey(const TSDT_Context* context, const char* keyName)
+	{
+		if (context == nullptr || keyName == nullptr)
+			return TSDT_NO_KEY;
+
+		const NamedEncryptionKey* key = FindNamedEncryptionKey(context->Keys, keyName);
+		return (key != nullptr) ? static_cast<int32_t>(key - context->Keys.data()) : TSDT_NO_KEY;
+	}
+
+	TSDT_Result TSDT_CreateCodec(const TSDT_Context* context, TSDT_Codec** outCodec)
+	{
+		if (context == nullptr || outCodec == nullptr)
+			return TSDT_RESULT_INVALID_ARGUMENT;
+
+		*outCodec = nullptr;
+		void* codecAllocation = Allocate(context->Allocator, sizeof(TSDT_Codec));
+		if (codecAllocation == nullptr)
+			return TSDT_RESULT_OUT_OF_MEMORY;
+
+		TSDT_Codec* codec = new (codecAllocation) TSDT_Codec();
+		codec->Context = context;
+
+		*outCodec = codec;
+		return TSDT_RESULT_SUCCESS;
+	}
+
+	void TSDT_DestroyCodec(TSDT_Codec* codec)
+	{
+		if (codec == nullptr)
+			return;
+
+		const TSDT_Allocator allocator = codec->Context->Allocator;
+		codec->~TSDT_Codec();
+		Free(allocator, codec, sizeof(TSDT_Codec));
+	}
+
+	TSDT_Result TSDT_DetectKey(TSDT_Codec* codec, const uint8_t* binData, size_t binSize, int32_t* outKeyIndex)
+	{
+		if (codec == nullptr || binData == nullptr || outKeyIndex == nullptr)
+			return TSDT_RESULT_INVALID_ARGUMENT;
+
+		const NamedEncryptionKey* key = nullptr;
+		const DataTableStatus status = DetectEncryptionKey(binData, binSize, codec->Context->Keys, key);
+
+		*outKeyIndex = (key != nullptr) ? static_cast<int32_t>(key - codec->Context->Keys.data()) : TSDT_NO_KEY;
+		return ToResult(status);
+	}
+
+	TSDT_Result TSDT_Decode(TSDT_Codec* codec, const uint8_t* binData, size_t binSize, TSDT_Buffer* outJson, int32_t* outKeyIndex)
+	{
+		if (codec == nullptr || binData == nullptr || outJson == nullptr)
+			return TSDT_RESULT_INVALID_ARGUMENT;
+
+		*outJson = {};
+		if (outKeyIndex != nullptr)
+			*outKeyIndex = TSDT_NO_KEY;
+
+		const DecodedJsonFile jsonFile = DecodeBinFileContent(binData, binSize, codec->Context->Keys);
+		if (jsonFile.Status != DataTableStatus::Success)
+			return ToResult(jsonFile.Status);
+
+		if (const TSDT_Result result = CopyIntoOutputBuffer(codec->Context->Allocator, jsonFile.Json.data(), jsonFile.Json.size(), outJson); result != TSDT_RESULT_SUCCESS)
+			return result;
+
+		if (outKeyIndex != nullptr && jsonFile.Key != nullptr)
+			*outKeyIndex = static_cast<int32_t>(jsonFile.Key - codec->Context->Keys.data());
+
+		return TSDT_RESULT_SUCCESS;
+	}
+
+	TSDT_Result TSDT_Encode(TSDT_Codec* codec, const uint8_t* jsonData, size_t jsonSize, const TSDT_EncodeOptions* options, TSDT_Buffer* outBin)
+	{
+		if (codec == nullptr || jsonData == nullptr || options == nullptr || outBin == nullptr)
+			return TSDT_RESULT_INVALID_ARGUMENT;
+
+		*outBin = {};
+		if (options->KeyIndex != TSDT_NO_KEY && (options->KeyIndex < 0 || static_cast<size_t>(options->KeyIndex) >= codec->Context->Keys.size()))
+			return TSDT_RESULT_INVALID_ARGUMENT;
+		if (options->IVMode != TSDT_IV_MODE_CONSTANT && options->IVMode != TSDT_IV_MODE_CONTENT && options->IVMode != TSDT_IV_MODE_EXPLICIT)
+			return TSDT_RESULT_INVALID_ARGUMENT;
+
+		// NOTE: An explicit IV is exactly what IVMode::Original does with the IV read from the original file
+		PeepoHappy::Crypto::AesIVBytes explicitIV = {};
+		memcpy(explicitIV.data(), options->IV, explicitIV.size());
+
+		const IVMode ivMode = (options->IVMode == TSDT_IV_MODE_EXPLICIT) ? IVMode::Original : (options->IVMode == TSDT_IV_MODE_CONTENT) ? IVMode::Content : IVMode::Constant;
+		const NamedEncryptionKey* key = (options->KeyIndex != TSDT_NO_KEY) ? &codec->Context->Keys[options->KeyIndex] : nullptr;
+
+		const EncodedBinFile binFile = EncodeJsonFileContent(jsonData, jsonSize, key, ivMode, &explicitIV, &codec->ReusableDeflater);
+		if (binFile.Status != DataTableStatus::Success)
+			return ToResult(binFile.Status);
+
+		return CopyIntoOutputBuffer(codec->Context->Allocator, binFile.Content, binFile.Size, outBin);
+	}
+
+	void TSDT_FreeBuffer(const TSDT_Context* context, TSDT_Buffer* buffer)
+	{
+		if (context == nullptr || buffer == nullptr || buffer->Data == nullptr)
+			return;
+
+		Free(context->Allocator, buffer->Data, buffer->Size + 1);
+		*buffer = {};
+	}
+}
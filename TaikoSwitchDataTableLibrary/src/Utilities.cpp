@@ -0,0 +1,1843 @@
+#include "Utilities.h"
+#include <zlib.h>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <set>
+#include <deque>
+
+#define NOMINMAX
+#include <Windows.h>
+#include <bcrypt.h>
+#include <io.h>
+#include <fcntl.h>
+
+#ifndef  NT_SUCCESS
+#define NT_SUCCESS(Status) (((::NTSTATUS)(Status)) >= 0)
+#endif // ! NT_SUCCESS
+
+namespace PeepoHappy
+{
+	namespace UTF8
+	{
+		std::string Narrow(std::wstring_view inputString)
+		{
+			std::string utf8String;
+			const int utf8Length = ::WideCharToMultiByte(CP_UTF8, 0, inputString.data(), static_cast<int>(inputString.size() + 1), nullptr, 0, nullptr, nullptr) - 1;
+
+			if (utf8Length > 0)
+			{
+				utf8String.resize(utf8Length);
+				::WideCharToMultiByte(CP_UTF8, 0, inputString.data(), static_cast<int>(inputString.size()), utf8String.data(), utf8Length, nullptr, nullptr);
+			}
+
+			return utf8String;
+		}
+
+		std::wstring Widen(std::string_view inputString)
+		{
+			std::wstring utf16String;
+			const int utf16Length = ::MultiByteToWideChar(CP_UTF8, 0, inputString.data(), static_cast<int>(inputString.size() + 1), nullptr, 0) - 1;
+
+			if (utf16Length > 0)
+			{
+				utf16String.resize(utf16Length);
+				::MultiByteToWideChar(CP_UTF8, 0, inputString.data(), static_cast<int>(inputString.size()), utf16String.data(), utf16Length);
+			}
+
+			return utf16String;
+		}
+
+		bool AppearsToUse8BitCodeUnits(std::string_view uncertainUTF8Text)
+		{
+			size_t nullCount = 0;
+			for (const char c : uncertainUTF8Text)
+				nullCount += (c == '\0');
+
+			if (uncertainUTF8Text.empty() || nullCount == 0)
+				return true;
+
+			const bool unusualNullCount = nullCount >= (uncertainUTF8Text.size() / 4);
+			return !unusualNullCount;
+		}
+
+		std::pair<int, const char**> GetCommandLineArguments()
+		{
+			static std::vector<std::string> argvString;
+			static std::vector<const char*> argvCStr;
+
+			if (!argvString.empty() || !argvCStr.empty())
+				return { static_cast<int>(argvString.size()), argvCStr.data() };
+
+			int argc = 0;
+			auto argv = ::CommandLineToArgvW(::GetCommandLineW(), &argc);
+
+			argvString.reserve(argc);
+			argvCStr.reserve(argc);
+
+			for (auto i = 0; i < argc; i++)
+				argvCStr.emplace_back(argvString.emplace_back(UTF8::Narrow(argv[i])).c_str());
+
+			::LocalFree(argv);
+			return { argc, argvCStr.data() };
+		}
+
+		std::string GetExecutableFilePath()
+		{
+			wchar_t fileNameBuffer[MAX_PATH];
+			const auto moduleFileName = std::wstring_view(fileNameBuffer, ::GetModuleFileNameW(NULL, fileNameBuffer, MAX_PATH));
+
+			return (moduleFileName.size() < MAX_PATH) ? UTF8::Narrow(moduleFileName) : "";
+		}
+
+		std::string GetExecutableDirectory()
+		{
+			return std::string(Path::GetDirectoryName(GetExecutableFilePath()));
+		}
+
+		std::string GetMachineName()
+		{
+			std::array<wchar_t, MAX_COMPUTERNAME_LENGTH + 1> nameBuffer;
+			DWORD nameLength = static_cast<DWORD>(nameBuffer.size());
+
+			return ::GetComputerNameW(nameBuffer.data(), &nameLength) ? Narrow(std::wstring_view(nameBuffer.data(), nameLength)) : std::string("unknown");
+		}
+
+		WideArg::WideArg(std::string_view inputString)
+		{
+			// NOTE: Length **without** null terminator
+			convertedLength = ::MultiByteToWideChar(CP_UTF8, 0, inputString.data(), static_cast<int>(inputString.size() + 1), nullptr, 0) - 1;
+
+			if (convertedLength <= 0)
+			{
+				stackBuffer[0] = L'\0';
+				return;
+			}
+
+			if (convertedLength < stackBuffer.size())
+			{
+				::MultiByteToWideChar(CP_UTF8, 0, inputString.data(), static_cast<int>(inputString.size()), stackBuffer.data(), convertedLength);
+				stackBuffer[convertedLength] = L'\0';
+			}
+			else
+			{
+				heapBuffer = std::make_unique<wchar_t[]>(convertedLength + 1);
+				::MultiByteToWideChar(CP_UTF8, 0, inputString.data(), static_cast<int>(inputString.size()), heapBuffer.get(), convertedLength);
+				heapBuffer[convertedLength] = L'\0';
+			}
+		}
+
+		const wchar_t* WideArg::c_str() const
+		{
+			return (convertedLength < stackBuffer.size()) ? stackBuffer.data() : heapBuffer.get();
+		}
+	}
+
+	namespace Memory
+	{
+		namespace
+		{
+			std::atomic<AllocationHook> GlobalAllocationHook = nullptr;
+
+			void NotifyAllocationHook(i64 byteSizeDelta)
+			{
+				if (const AllocationHook hook = GlobalAllocationHook.load(std::memory_order_relaxed); hook != nullptr)
+					hook(byteSizeDelta);
+			}
+
+			// NOTE: Large enough to keep the returned addresses aligned for any fundamental type
+			constexpr size_t TrackedAllocHeaderSize = alignof(std::max_align_t);
+		}
+
+		void SetAllocationHook(AllocationHook hook)
+		{
+			GlobalAllocationHook = hook;
+		}
+
+		void TrackedBufferDeleter::operator()(u8* buffer) const
+		{
+			if (buffer != nullptr)
+				NotifyAllocationHook(-static_cast<i64>(ByteSize));
+			delete[] buffer;
+		}
+
+		TrackedBuffer MakeTrackedBuffer(size_t byteSize)
+		{
+			NotifyAllocationHook(static_cast<i64>(byteSize));
+			return TrackedBuffer(new u8[byteSize](), TrackedBufferDeleter { byteSize });
+		}
+
+		void* TrackedAlloc(size_t byteSize)
+		{
+			u8* allocation = static_cast<u8*>(malloc(TrackedAllocHeaderSize + byteSize));
+			if (allocation == nullptr)
+				return nullptr;
+
+			memcpy(allocation, &byteSize, sizeof(byteSize));
+			NotifyAllocationHook(static_cast<i64>(byteSize));
+			return (allocation + TrackedAllocHeaderSize);
+		}
+
+		void TrackedFree(void* address)
+		{
+			if (address == nullptr)
+				return;
+
+			u8* allocation = (static_cast<u8*>(address) - TrackedAllocHeaderSize);
+			size_t byteSize = 0;
+			memcpy(&byteSize, allocation, sizeof(byteSize));
+
+			NotifyAllocationHook(-static_cast<i64>(byteSize));
+			free(allocation);
+		}
+	}
+
+	namespace Path
+	{
+		std::string_view GetFileExtension(std::string_view filePath)
+		{
+			const size_t lastSeparator = filePath.find_last_of("./\\");
+			if (lastSeparator != std::string_view::npos)
+			{
+				if (filePath[lastSeparator] == '.')
+					return filePath.substr(lastSeparator);
+			}
+			return std::string_view(filePath.data(), 0);
+		}
+
+		std::string_view GetFileName(std::string_view filePath, bool includeExtension)
+		{
+			const size_t lastSeparator = filePath.find_last_of("/\\");
+			const auto fileName = (lastSeparator == std::string_view::npos) ? filePath : filePath.substr(lastSeparator + 1);
+			return (includeExtension) ? fileName : TrimFileExtension(fileName);
+		}
+
+		std::string_view GetDirectoryName(std::string_view filePath)
+		{
+			const auto fileName = GetFileName(filePath);
+			return fileName.empty() ? filePath : filePath.substr(0, filePath.size() - fileName.size() - 1);
+		}
+
+		std::string_view TrimFileExtension(std::string_view filePath)
+		{
+			return filePath.substr(0, filePath.size() - GetFileExtension(filePath).size());
+		}
+
+		bool HasFileExtension(std::string_view filePath, std::string_view extensionToCheckFor)
+		{
+			assert(!extensionToCheckFor.empty() && extensionToCheckFor[0] == '.');
+			return ASCII::MatchesInsensitive(GetFileExtension(filePath), extensionToCheckFor);
+		}
+	}
+
+	namespace IO
+	{
+		std::pair<Memory::TrackedBuffer, size_t> ReadEntireFile(std::string_view filePath)
+		{
+			Memory::TrackedBuffer fileContent = nullptr;
+			size_t fileSize = 0;
+
+			::HANDLE fileHandle = ::CreateFileW(UTF8::WideArg(filePath).c_str(), GENERIC_READ, (FILE_SHARE_READ | FILE_SHARE_WRITE), NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (fileHandle != INVALID_HANDLE_VALUE)
+			{
+				::LARGE_INTEGER largeIntegerFileSize = {};
+				::GetFileSizeEx(fileHandle, &largeIntegerFileSize);
+
+				if (fileSize = static_cast<size_t>(largeIntegerFileSize.QuadPart); fileSize > 0)
+				{
+					if (fileContent = Memory::MakeTrackedBuffer(fileSize); fileContent != nullptr)
+					{
+						assert(fileSize < std::numeric_limits<DWORD>::max() && "No way that's ever gonna happen, right?");
+
+						DWORD bytesRead = 0;
+						::ReadFile(fileHandle, fileContent.get(), static_cast<DWORD>(fileSize), &bytesRead, nullptr);
+					}
+				}
+
+				::CloseHandle(fileHandle);
+			}
+
+			return { std::move(fileContent), fileSize };
+		}
+
+		bool WriteEntireFile(std::string_view filePath, const u8* fileContent, size_t fileSize)
+		{
+			if (filePath.empty() || fileContent == nullptr || fileSize == 0)
+				return false;
+
+			::HANDLE fileHandle = ::CreateFileW(UTF8::WideArg(filePath).c_str(), GENERIC_WRITE, (FILE_SHARE_READ | FILE_SHARE_WRITE), NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (fileHandle == INVALID_HANDLE_VALUE)
+				return false;
+
+			assert(fileSize < std::numeric_limits<DWORD>::max() && "No way that's ever gonna happen, right?");
+
+			DWORD bytesWritten = 0;
+			::WriteFile(fileHandle, fileContent, static_cast<DWORD>(fileSize), &bytesWritten, nullptr);
+
+			::CloseHandle(fileHandle);
+			return true;
+		}
+
+		bool WriteEntireFileAtomically(std::string_view filePath, const u8* fileContent, size_t fileSize)
+		{
+			char temporarySuffix[64];
+			sprintf_s(temporarySuffix, ".%lu.%lu.tmp", static_cast<unsigned long>(::GetCurrentProcessId()), static_cast<unsigned long>(::GetCurrentThreadId()));
+
+			std::string temporaryFilePath { filePath };
+			temporaryFilePath += temporarySuffix;
+
+			if (!WriteEntireFile(temporaryFilePath, fileContent, fileSize))
+				return false;
+
+			if (!RenameFile(temporaryFilePath, filePath))
+			{
+				RemoveFile(temporaryFilePath);
+				return false;
+			}
+
+			return true;
+		}
+
+		bool DuplicateFile(std::string_view sourceFilePath, std::string_view destinationFilePath)
+		{
+			return ::CopyFileW(UTF8::WideArg(sourceFilePath).c_str(), UTF8::WideArg(destinationFilePath).c_str(), FALSE);
+		}
+
+		bool RenameFile(std::string_view sourceFilePath, std::string_view destinationFilePath)
+		{
+			return ::MoveFileExW(UTF8::WideArg(sourceFilePath).c_str(), UTF8::WideArg(destinationFilePath).c_str(), MOVEFILE_REPLACE_EXISTING);
+		}
+
+		bool RemoveFile(std::string_view filePath)
+		{
+			return ::DeleteFileW(UTF8::WideArg(filePath).c_str());
+		}
+
+		bool RemoveEmptyDirectory(std::string_view directoryPath)
+		{
+			return ::RemoveDirectoryW(UTF8::WideArg(directoryPath).c_str());
+		}
+
+		bool CreateDirectoryRecursive(std::string_view directoryPath)
+		{
+			while (directoryPath.size() > 1 && (directoryPath.back() == '/' || directoryPath.back() == '\\'))
+				directoryPath.remove_suffix(1);
+
+			if (directoryPath.empty() || DirectoryExists(directoryPath))
+				return true;
+
+			const std::string_view parentDirectoryPath = Path::GetDirectoryName(directoryPath);
+			if (parentDirectoryPath.size() < directoryPath.size() && !CreateDirectoryRecursive(parentDirectoryPath))
+				return false;
+
+			return ::CreateDirectoryW(UTF8::WideArg(directoryPath).c_str(), nullptr) || ::GetLastError() == ERROR_ALREADY_EXISTS;
+		}
+
+		bool SetLastWriteTimeToNow(std::string_view filePath)
+		{
+			::HANDLE fileHandle = ::CreateFileW(UTF8::WideArg(filePath).c_str(), FILE_WRITE_ATTRIBUTES, (FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE), NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (fileHandle == INVALID_HANDLE_VALUE)
+				return false;
+
+			::FILETIME currentTime = {};
+			::GetSystemTimeAsFileTime(&currentTime);
+			const bool success = ::SetFileTime(fileHandle, nullptr, nullptr, &currentTime);
+
+			::CloseHandle(fileHandle);
+			return success;
+		}
+
+		bool CreateNewFile(std::string_view filePath, const u8* fileContent, size_t fileSize)
+		{
+			::HANDLE fileHandle = ::CreateFileW(UTF8::WideArg(filePath).c_str(), GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (fileHandle == INVALID_HANDLE_VALUE)
+				return false;
+
+			assert(fileSize < std::numeric_limits<DWORD>::max() && "No way that's ever gonna happen, right?");
+
+			DWORD bytesWritten = 0;
+			const bool success = (fileSize == 0) || (::WriteFile(fileHandle, fileContent, static_cast<DWORD>(fileSize), &bytesWritten, nullptr) && bytesWritten == fileSize);
+
+			::CloseHandle(fileHandle);
+			return success;
+		}
+
+		bool DirectoryExists(std::string_view directoryPath)
+		{
+			const DWORD attributes = ::GetFileAttributesW(UTF8::WideArg(directoryPath).c_str());
+			return (attributes != INVALID_FILE_ATTRIBUTES) && (attributes & FILE_ATTRIBUTE_DIRECTORY);
+		}
+
+		u64 GetFileSize(std::string_view filePath)
+		{
+			::WIN32_FILE_ATTRIBUTE_DATA attributeData = {};
+			if (!::GetFileAttributesExW(UTF8::WideArg(filePath).c_str(), ::GetFileExInfoStandard, &attributeData))
+				return 0;
+
+			return (static_cast<u64>(attributeData.nFileSizeHigh) << 32) | static_cast<u64>(attributeData.nFileSizeLow);
+		}
+
+		size_t ReadFileHead(std::string_view filePath, u8* outBuffer, size_t bufferSize)
+		{
+			DWORD bytesRead = 0;
+
+			::HANDLE fileHandle = ::CreateFileW(UTF8::WideArg(filePath).c_str(), GENERIC_READ, (FILE_SHARE_READ | FILE_SHARE_WRITE), NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (fileHandle != INVALID_HANDLE_VALUE)
+			{
+				assert(bufferSize < std::numeric_limits<DWORD>::max());
+				if (!::ReadFile(fileHandle, outBuffer, static_cast<DWORD>(bufferSize), &bytesRead, nullptr))
+					bytesRead = 0;
+
+				::CloseHandle(fileHandle);
+			}
+
+			return static_cast<size_t>(bytesRead);
+		}
+
+		FileMetadata GetFileMetadata(std::string_view filePath)
+		{
+			::WIN32_FILE_ATTRIBUTE_DATA attributeData = {};
+			if (!::GetFileAttributesExW(UTF8::WideArg(filePath).c_str(), ::GetFileExInfoStandard, &attributeData))
+				return FileMetadata {};
+
+			FileMetadata metadata = {};
+			metadata.Size = (static_cast<u64>(attributeData.nFileSizeHigh) << 32) | static_cast<u64>(attributeData.nFileSizeLow);
+			metadata.LastWriteTime = (static_cast<u64>(attributeData.ftLastWriteTime.dwHighDateTime) << 32) | static_cast<u64>(attributeData.ftLastWriteTime.dwLowDateTime);
+			return metadata;
+		}
+
+		u64 GetCurrentFileTime()
+		{
+			::FILETIME currentTime = {};
+			::GetSystemTimeAsFileTime(&currentTime);
+			return (static_cast<u64>(currentTime.dwHighDateTime) << 32) | static_cast<u64>(currentTime.dwLowDateTime);
+		}
+
+		u32 GetFileLinkCount(std::string_view filePath)
+		{
+			::HANDLE fileHandle = ::CreateFileW(UTF8::WideArg(filePath).c_str(), FILE_READ_ATTRIBUTES, (FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE), NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (fileHandle == INVALID_HANDLE_VALUE)
+				return 0;
+
+			::BY_HANDLE_FILE_INFORMATION fileInformation = {};
+			const bool success = ::GetFileInformationByHandle(fileHandle, &fileInformation);
+
+			::CloseHandle(fileHandle);
+			return success ? static_cast<u32>(fileInformation.nNumberOfLinks) : 0;
+		}
+
+		void ForEachFileInDirectory(std::string_view directoryPath, std::function<void(std::string_view filePath)> perFileFunc)
+		{
+			std::string searchPattern { directoryPath };
+			searchPattern += "/*";
+
+			::WIN32_FIND_DATAW findData = {};
+			::HANDLE searchHandle = ::FindFirstFileW(UTF8::WideArg(searchPattern).c_str(), &findData);
+			if (searchHandle == INVALID_HANDLE_VALUE)
+				return;
+
+			do
+			{
+				const auto fileName = std::wstring_view(findData.cFileName);
+				if (fileName == L"." || fileName == L"..")
+					continue;
+
+				std::string filePath { directoryPath };
+				filePath += "/";
+				filePath += UTF8::Narrow(fileName);
+
+				if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+					ForEachFileInDirectory(filePath, perFileFunc);
+				else
+					perFileFunc(filePath);
+			}
+			while (::FindNextFileW(searchHandle, &findData));
+
+			::FindClose(searchHandle);
+		}
+
+		void SetStandardStreamsToBinaryMode()
+		{
+			fflush(stdout);
+			_setmode(_fileno(stdin), _O_BINARY);
+			_setmode(_fileno(stdout), _O_BINARY);
+		}
+
+		void FileStreamDeleter::operator()(FILE* stream) const
+		{
+			fclose(stream);
+		}
+
+		FileStream OpenFileStream(std::string_view filePath, const wchar_t* mode)
+		{
+			return FileStream(::_wfopen(UTF8::WideArg(filePath).c_str(), mode));
+		}
+
+		std::string GetFullPath(std::string_view filePath)
+		{
+			std::array<wchar_t, 0x1000> fullPathBuffer;
+			const DWORD fullPathLength = ::GetFullPathNameW(UTF8::WideArg(filePath).c_str(), static_cast<DWORD>(fullPathBuffer.size()), fullPathBuffer.data(), nullptr);
+
+			return (fullPathLength > 0 && fullPathLength < fullPathBuffer.size()) ? UTF8::Narrow(std::wstring_view(fullPathBuffer.data(), fullPathLength)) : std::string(filePath);
+		}
+
+		namespace
+		{
+			std::string FormatNamedPipePath(std::string_view pipeName)
+			{
+				std::string pipePath = "\\\\.\\pipe\\";
+				pipePath += pipeName;
+				return pipePath;
+			}
+		}
+
+		struct GroupCommitWriter::State
+		{
+			struct StagedFile
+			{
+				std::string FilePath;
+				std::string TemporaryFilePath;
+				::HANDLE FileHandle;
+			};
+
+			std::mutex Mutex;
+			std::vector<StagedFile> StagedFiles;
+			std::vector<std::string> CommittedFilePaths;
+			std::vector<std::string> DiscardedFilePaths;
+			std::atomic<u32> NextTemporaryFileIndex = 0;
+		};
+
+		GroupCommitWriter::GroupCommitWriter() : state(std::make_unique<State>())
+		{
+		}
+
+		GroupCommitWriter::~GroupCommitWriter()
+		{
+			for (const auto& stagedFile : state->StagedFiles)
+			{
+				if (stagedFile.FileHandle != INVALID_HANDLE_VALUE)
+					::CloseHandle(stagedFile.FileHandle);
+				RemoveFile(stagedFile.TemporaryFilePath);
+			}
+		}
+
+		bool GroupCommitWriter::Stage(std::string_view filePath, const u8* fileContent, size_t fileSize)
+		{
+			if (filePath.empty() || fileContent == nullptr || fileSize == 0)
+				return false;
+
+			char temporarySuffix[64];
+			sprintf_s(temporarySuffix, ".%lu.%u.staged", static_cast<unsigned long>(::GetCurrentProcessId()), state->NextTemporaryFileIndex++);
+
+			State::StagedFile stagedFile = { std::string(filePath), std::string(filePath) + temporarySuffix, INVALID_HANDLE_VALUE };
+			stagedFile.FileHandle = ::CreateFileW(UTF8::WideArg(stagedFile.TemporaryFilePath).c_str(), GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (stagedFile.FileHandle == INVALID_HANDLE_VALUE)
+				return false;
+
+			assert(fileSize < std::numeric_limits<DWORD>::max() && "No way that's ever gonna happen, right?");
+
+			DWORD bytesWritten = 0;
+			if (!::WriteFile(stagedFile.FileHandle, fileContent, static_cast<DWORD>(fileSize), &bytesWritten, nullptr) || bytesWritten != fileSize)
+			{
+				::CloseHandle(stagedFile.FileHandle);
+				RemoveFile(stagedFile.TemporaryFilePath);
+				return false;
+			}
+
+			// NOTE: Kept open until the commit so that flushing doesn't require opening every file a second time
+			const auto lock = std::scoped_lock(state->Mutex);
+			state->StagedFiles.push_back(std::move(stagedFile));
+			return true;
+		}
+
+		bool GroupCommitWriter::Commit()
+		{
+			auto& stagedFiles = state->StagedFiles;
+
+			// NOTE: Issuing all flushes at once from several threads lets the OS and the drive merge them into far fewer
+			//		 device cache flushes than flushing each file right after writing it
+			std::atomic<size_t> failedFlushCount = 0;
+			Threading::ParallelForEachIndex(stagedFiles.size(), std::min(8u, Threading::GetHardwareThreadCount()), [&](size_t index)
+			{
+				if (!::FlushFileBuffers(stagedFiles[index].FileHandle))
+					failedFlushCount++;
+
+				::CloseHandle(stagedFiles[index].FileHandle);
+				stagedFiles[index].FileHandle = INVALID_HANDLE_VALUE;
+			});
+
+			if (failedFlushCount > 0)
+			{
+				for (const auto& stagedFile : stagedFiles)
+				{
+					RemoveFile(stagedFile.TemporaryFilePath);
+					state->DiscardedFilePaths.push_back(stagedFile.FilePath);
+				}
+				stagedFiles.clear();
+				return false;
+			}
+
+			// NOTE: Write-through so that the renames themselves are durable by the time Commit() returns, not just the file contents
+			bool allRenamed = true;
+			for (const auto& stagedFile : stagedFiles)
+			{
+				if (::MoveFileExW(UTF8::WideArg(stagedFile.TemporaryFilePath).c_str(), UTF8::WideArg(stagedFile.FilePath).c_str(), (MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)))
+				{
+					state->CommittedFilePaths.push_back(stagedFile.FilePath);
+				}
+				else
+				{
+					RemoveFile(stagedFile.TemporaryFilePath);
+					state->DiscardedFilePaths.push_back(stagedFile.FilePath);
+					allRenamed = false;
+				}
+			}
+
+			stagedFiles.clear();
+			return allRenamed;
+		}
+
+		const std::vector<std::string>& GroupCommitWriter::GetCommittedFilePaths() const
+		{
+			return state->CommittedFilePaths;
+		}
+
+		const std::vector<std::string>& GroupCommitWriter::GetDiscardedFilePaths() const
+		{
+			return state->DiscardedFilePaths;
+		}
+
+		MemoryMappedFile::~MemoryMappedFile()
+		{
+			if (mappedView != nullptr)
+				::UnmapViewOfFile(mappedView);
+			if (mappingHandle != nullptr)
+				::CloseHandle(mappingHandle);
+			if (fileHandle != nullptr && fileHandle != INVALID_HANDLE_VALUE)
+				::CloseHandle(fileHandle);
+		}
+
+		bool MemoryMappedFile::Open(std::string_view filePath)
+		{
+			fileHandle = ::CreateFileW(UTF8::WideArg(filePath).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (fileHandle == INVALID_HANDLE_VALUE)
+				return false;
+
+			LARGE_INTEGER largeIntegerFileSize = {};
+			if (!::GetFileSizeEx(fileHandle, &largeIntegerFileSize) || largeIntegerFileSize.QuadPart <= 0)
+				return false;
+
+			// NOTE: Mapping a zero sized file fails so empty files are treated as invalid as well
+			mappingHandle = ::CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mappingHandle == nullptr)
+				return false;
+
+			mappedView = static_cast<const u8*>(::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+			if (mappedView == nullptr)
+				return false;
+
+			mappedSize = static_cast<size_t>(largeIntegerFileSize.QuadPart);
+			return true;
+		}
+
+		bool MemoryMappedFile::IsValid() const
+		{
+			return (mappedView != nullptr);
+		}
+
+		const u8* MemoryMappedFile::GetData() const
+		{
+			return mappedView;
+		}
+
+		size_t MemoryMappedFile::GetSize() const
+		{
+			return mappedSize;
+		}
+
+		struct AsyncFileQueue::State
+		{
+			// NOTE: The OVERLAPPED has to come first so that the pointer returned by the completion port can be cast back
+			struct Operation
+			{
+				::OVERLAPPED Overlapped;
+				::HANDLE FileHandle;
+				AsyncFileOperation Type;
+				u64 Tag;
+				u32 BufferIndex;
+				size_t RequestedSize;
+				// NOTE: Only used by the I/O threads
+				std::string FilePath;
+				const u8* WriteData;
+				bool Failed;
+			};
+
+			::HANDLE CompletionPort = nullptr;
+			size_t BufferSize = 0;
+			std::vector<Memory::TrackedBuffer> Buffers;
+			std::vector<u32> FreeBufferIndices;
+			size_t InFlightOperationCount = 0;
+
+			std::vector<std::thread> IOThreads;
+			std::mutex PendingMutex;
+			std::condition_variable PendingCondition;
+			std::deque<Operation*> PendingOperations;
+			bool ShuttingDown = false;
+
+			bool PerformBlockingOperation(Operation& operation, DWORD& outBytesTransferred) const
+			{
+				if (operation.Type == AsyncFileOperation::Write)
+				{
+					if (!WriteEntireFile(operation.FilePath, operation.WriteData, operation.RequestedSize))
+						return false;
+
+					outBytesTransferred = static_cast<DWORD>(operation.RequestedSize);
+					return true;
+				}
+
+				const ::HANDLE fileHandle = ::CreateFileW(UTF8::WideArg(operation.FilePath).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+				if (fileHandle == INVALID_HANDLE_VALUE)
+					return false;
+
+				LARGE_INTEGER largeIntegerFileSize = {};
+				const bool validSize = (::GetFileSizeEx(fileHandle, &largeIntegerFileSize) && largeIntegerFileSize.QuadPart > 0 && static_cast<u64>(largeIntegerFileSize.QuadPart) <= BufferSize);
+				if (validSize)
+					operation.RequestedSize = static_cast<size_t>(largeIntegerFileSize.QuadPart);
+
+				const bool success = validSize && ::ReadFile(fileHandle, Buffers[operation.BufferIndex].get(), static_cast<DWORD>(operation.RequestedSize), &outBytesTransferred, nullptr);
+				::CloseHandle(fileHandle);
+				return success;
+			}
+
+			void ProcessPendingOperations()
+			{
+				while (true)
+				{
+					Operation* operation = nullptr;
+					{
+						auto lock = std::unique_lock(PendingMutex);
+						PendingCondition.wait(lock, [this] { return ShuttingDown || !PendingOperations.empty(); });
+						if (PendingOperations.empty())
+							return;
+
+						operation = PendingOperations.front();
+						PendingOperations.pop_front();
+					}
+
+					DWORD bytesTransferred = 0;
+					operation->Failed = !PerformBlockingOperation(*operation, bytesTransferred);
+					::PostQueuedCompletionStatus(CompletionPort, bytesTransferred, 0, &operation->Overlapped);
+				}
+			}
+
+			bool SubmitOperation(std::unique_ptr<Operation> operation, std::string_view filePath, const u8* data)
+			{
+				if (!IOThreads.empty())
+				{
+					operation->FilePath = std::string(filePath);
+					operation->WriteData = data;
+					{
+						const auto lock = std::scoped_lock(PendingMutex);
+						PendingOperations.push_back(operation.release());
+					}
+					PendingCondition.notify_one();
+					InFlightOperationCount++;
+					return true;
+				}
+
+				const bool isWrite = (operation->Type == AsyncFileOperation::Write);
+				operation->FileHandle = isWrite ?
+					::CreateFileW(UTF8::WideArg(filePath).c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr) :
+					::CreateFileW(UTF8::WideArg(filePath).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+				if (operation->FileHandle == INVALID_HANDLE_VALUE)
+					return false;
+
+				if (!isWrite)
+				{
+					LARGE_INTEGER largeIntegerFileSize = {};
+					if (!::GetFileSizeEx(operation->FileHandle, &largeIntegerFileSize) || largeIntegerFileSize.QuadPart <= 0 || static_cast<u64>(largeIntegerFileSize.QuadPart) > BufferSize)
+					{
+						::CloseHandle(operation->FileHandle);
+						return false;
+					}
+					operation->RequestedSize = static_cast<size_t>(largeIntegerFileSize.QuadPart);
+				}
+
+				assert(operation->RequestedSize < std::numeric_limits<DWORD>::max() && "No way that's ever gonna happen, right?");
+
+				// NOTE: Every handle is associated with the port only for the lifetime of its single operation
+				if (::CreateIoCompletionPort(operation->FileHandle, CompletionPort, 0, 0) == nullptr)
+				{
+					::CloseHandle(operation->FileHandle);
+					return false;
+				}
+
+				// NOTE: Even operations that happen to complete synchronously still queue a completion packet
+				const BOOL result = isWrite ?
+					::WriteFile(operation->FileHandle, data, static_cast<DWORD>(operation->RequestedSize), nullptr, &operation->Overlapped) :
+					::ReadFile(operation->FileHandle, Buffers[operation->BufferIndex].get(), static_cast<DWORD>(operation->RequestedSize), nullptr, &operation->Overlapped);
+				if (!result && ::GetLastError() != ERROR_IO_PENDING)
+				{
+					::CloseHandle(operation->FileHandle);
+					return false;
+				}
+
+				InFlightOperationCount++;
+				operation.release();
+				return true;
+			}
+		};
+
+		AsyncFileQueue::AsyncFileQueue(u32 queueDepth, size_t bufferSize, u32 ioThreadCount) : state(std::make_unique<State>())
+		{
+			state->CompletionPort = ::CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+			if (state->CompletionPort == nullptr)
+				return;
+
+			state->BufferSize = bufferSize;
+			state->Buffers.reserve(queueDepth);
+			state->FreeBufferIndices.reserve(queueDepth);
+			for (u32 i = 0; i < queueDepth; i++)
+			{
+				state->Buffers.push_back(Memory::MakeTrackedBuffer(bufferSize));
+				state->FreeBufferIndices.push_back(queueDepth - i - 1);
+			}
+
+			state->IOThreads.reserve(ioThreadCount);
+			for (u32 i = 0; i < ioThreadCount; i++)
+				state->IOThreads.emplace_back([this] { state->ProcessPendingOperations(); });
+		}
+
+		AsyncFileQueue::~AsyncFileQueue()
+		{
+			if (state->CompletionPort == nullptr)
+				return;
+
+			// NOTE: The pooled buffers and the memory of pending writes must not go away while the OS might still be accessing them
+			while (state->InFlightOperationCount > 0)
+			{
+				DWORD bytesTransferred = 0; ULONG_PTR completionKey = 0; ::OVERLAPPED* overlapped = nullptr;
+				if (!::GetQueuedCompletionStatus(state->CompletionPort, &bytesTransferred, &completionKey, &overlapped, INFINITE) && overlapped == nullptr)
+					break;
+
+				if (overlapped != nullptr)
+				{
+					auto operation = std::unique_ptr<State::Operation>(reinterpret_cast<State::Operation*>(overlapped));
+					if (operation->FileHandle != INVALID_HANDLE_VALUE)
+						::CloseHandle(operation->FileHandle);
+					state->InFlightOperationCount--;
+				}
+			}
+
+			{
+				const auto lock = std::scoped_lock(state->PendingMutex);
+				state->ShuttingDown = true;
+			}
+			state->PendingCondition.notify_all();
+			for (auto& thread : state->IOThreads)
+				thread.join();
+
+			::CloseHandle(state->CompletionPort);
+		}
+
+		bool AsyncFileQueue::IsValid() const
+		{
+			return (state->CompletionPort != nullptr);
+		}
+
+		bool AsyncFileQueue::HasFreeBuffer() const
+		{
+			return !state->FreeBufferIndices.empty();
+		}
+
+		bool AsyncFileQueue::SubmitRead(std::string_view filePath, u64 tag)
+		{
+			if (state->FreeBufferIndices.empty())
+				return false;
+
+			auto operation = std::make_unique<State::Operation>();
+			operation->FileHandle = INVALID_HANDLE_VALUE;
+			operation->Type = AsyncFileOperation::Read;
+			operation->Tag = tag;
+			operation->BufferIndex = state->FreeBufferIndices.back();
+
+			if (!state->SubmitOperation(std::move(operation), filePath, nullptr))
+				return false;
+
+			state->FreeBufferIndices.pop_back();
+			return true;
+		}
+
+		bool AsyncFileQueue::SubmitWrite(std::string_view filePath, const u8* fileContent, size_t fileSize, u64 tag)
+		{
+			if (fileContent == nullptr || fileSize == 0)
+				return false;
+
+			auto operation = std::make_unique<State::Operation>();
+			operation->FileHandle = INVALID_HANDLE_VALUE;
+			operation->Type = AsyncFileOperation::Write;
+			operation->Tag = tag;
+			operation->BufferIndex = InvalidBufferIndex;
+			operation->RequestedSize = fileSize;
+
+			return state->SubmitOperation(std::move(operation), filePath, fileContent);
+		}
+
+		void AsyncFileQueue::Post(u64 tag)
+		{
+			::PostQueuedCompletionStatus(state->CompletionPort, 0, static_cast<ULONG_PTR>(tag), nullptr);
+		}
+
+		AsyncFileCompletion AsyncFileQueue::WaitForCompletion()
+		{
+			DWORD bytesTransferred = 0; ULONG_PTR completionKey = 0; ::OVERLAPPED* overlapped = nullptr;
+			const BOOL result = ::GetQueuedCompletionStatus(state->CompletionPort, &bytesTransferred, &completionKey, &overlapped, INFINITE);
+
+			if (overlapped == nullptr)
+				return AsyncFileCompletion { AsyncFileOperation::Posted, (result != FALSE), static_cast<u64>(completionKey), nullptr, 0, InvalidBufferIndex };
+
+			auto operation = std::unique_ptr<State::Operation>(reinterpret_cast<State::Operation*>(overlapped));
+			if (operation->FileHandle != INVALID_HANDLE_VALUE)
+				::CloseHandle(operation->FileHandle);
+			state->InFlightOperationCount--;
+
+			const bool success = (result != FALSE && !operation->Failed && bytesTransferred == operation->RequestedSize);
+			if (operation->Type == AsyncFileOperation::Read)
+			{
+				// NOTE: A failed read never hands out its buffer so it goes straight back into the pool
+				if (!success)
+					ReleaseBuffer(operation->BufferIndex);
+
+				return AsyncFileCompletion { AsyncFileOperation::Read, success, operation->Tag,
+					success ? state->Buffers[operation->BufferIndex].get() : nullptr,
+					success ? operation->RequestedSize : 0,
+					success ? operation->BufferIndex : InvalidBufferIndex };
+			}
+
+			return AsyncFileCompletion { AsyncFileOperation::Write, success, operation->Tag, nullptr, 0, InvalidBufferIndex };
+		}
+
+		void AsyncFileQueue::ReleaseBuffer(u32 bufferIndex)
+		{
+			if (bufferIndex < state->Buffers.size())
+				state->FreeBufferIndices.push_back(bufferIndex);
+		}
+
+		NamedPipe::~NamedPipe()
+		{
+			if (IsValid())
+				::CloseHandle(pipeHandle);
+		}
+
+		bool NamedPipe::IsValid() const
+		{
+			return (pipeHandle != nullptr && pipeHandle != INVALID_HANDLE_VALUE);
+		}
+
+		bool NamedPipe::Create(std::string_view pipeName)
+		{
+			constexpr DWORD bufferSize = 0x10000;
+			pipeHandle = ::CreateNamedPipeW(UTF8::WideArg(FormatNamedPipePath(pipeName)).c_str(), PIPE_ACCESS_DUPLEX, (PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS), PIPE_UNLIMITED_INSTANCES, bufferSize, bufferSize, 0, nullptr);
+			return IsValid();
+		}
+
+		bool NamedPipe::WaitForClient()
+		{
+			// NOTE: A client might have connected in between creating the pipe and calling ConnectNamedPipe(), which is still a success
+			return ::ConnectNamedPipe(pipeHandle, nullptr) || ::GetLastError() == ERROR_PIPE_CONNECTED;
+		}
+
+		void NamedPipe::DisconnectClient()
+		{
+			::FlushFileBuffers(pipeHandle);
+			::DisconnectNamedPipe(pipeHandle);
+		}
+
+		bool NamedPipe::Connect(std::string_view pipeName, u32 timeoutMilliseconds)
+		{
+			const std::string pipePath = FormatNamedPipePath(pipeName);
+			while (true)
+			{
+				pipeHandle = ::CreateFileW(UTF8::WideArg(pipePath).c_str(), (GENERIC_READ | GENERIC_WRITE), 0, NULL, OPEN_EXISTING, 0, NULL);
+				if (IsValid())
+					return true;
+
+				// NOTE: All server instances are currently busy serving other clients
+				if (::GetLastError() != ERROR_PIPE_BUSY || !::WaitNamedPipeW(UTF8::WideArg(pipePath).c_str(), timeoutMilliseconds))
+					return false;
+			}
+		}
+
+		bool NamedPipe::ReadExact(void* outData, size_t dataSize)
+		{
+			u8* writeHead = static_cast<u8*>(outData);
+			while (dataSize > 0)
+			{
+				DWORD bytesRead = 0;
+				if (!::ReadFile(pipeHandle, writeHead, static_cast<DWORD>(std::min<size_t>(dataSize, std::numeric_limits<DWORD>::max())), &bytesRead, nullptr) || bytesRead == 0)
+					return false;
+
+				writeHead += bytesRead;
+				dataSize -= bytesRead;
+			}
+			return true;
+		}
+
+		bool NamedPipe::WriteAll(const void* data, size_t dataSize)
+		{
+			const u8* readHead = static_cast<const u8*>(data);
+			while (dataSize > 0)
+			{
+				DWORD bytesWritten = 0;
+				if (!::WriteFile(pipeHandle, readHead, static_cast<DWORD>(std::min<size_t>(dataSize, std::numeric_limits<DWORD>::max())), &bytesWritten, nullptr) || bytesWritten == 0)
+					return false;
+
+				readHead += bytesWritten;
+				dataSize -= bytesWritten;
+			}
+			return true;
+		}
+
+		struct DirectoryWatcher::State
+		{
+			::HANDLE DirectoryHandle;
+			::HANDLE EventHandle;
+			::OVERLAPPED Overlapped;
+			bool ReadPending;
+			// NOTE: Must be DWORD aligned
+			std::array<DWORD, 0x4000> NotificationBuffer;
+		};
+
+		DirectoryWatcher::DirectoryWatcher(std::string_view directoryPath) : state(std::make_unique<State>())
+		{
+			state->DirectoryHandle = ::CreateFileW(UTF8::WideArg(directoryPath).c_str(), FILE_LIST_DIRECTORY, (FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE), NULL, OPEN_EXISTING, (FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED), NULL);
+			state->EventHandle = ::CreateEventW(nullptr, TRUE, FALSE, nullptr);
+			state->Overlapped = {};
+			state->ReadPending = false;
+		}
+
+		DirectoryWatcher::~DirectoryWatcher()
+		{
+			if (state->ReadPending)
+			{
+				DWORD bytesTransferred = 0;
+				::CancelIoEx(state->DirectoryHandle, &state->Overlapped);
+				::GetOverlappedResult(state->DirectoryHandle, &state->Overlapped, &bytesTransferred, TRUE);
+			}
+
+			if (state->DirectoryHandle != INVALID_HANDLE_VALUE)
+				::CloseHandle(state->DirectoryHandle);
+			if (state->EventHandle != NULL)
+				::CloseHandle(state->EventHandle);
+		}
+
+		bool DirectoryWatcher::IsValid() const
+		{
+			return (state->DirectoryHandle != INVALID_HANDLE_VALUE && state->EventHandle != NULL);
+		}
+
+		bool DirectoryWatcher::WaitForChanges(u32 timeoutMilliseconds, const std::function<void(std::string_view relativeFilePath)>& perChangedFileFunc)
+		{
+			if (!IsValid())
+				return false;
+
+			// NOTE: The read is kept pending in between calls so that no changes are missed while the caller is busy processing the previous ones
+			if (!state->ReadPending)
+			{
+				constexpr DWORD notifyFilter = (FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE);
+
+				::ResetEvent(state->EventHandle);
+				state->Overlapped = {};
+				state->Overlapped.hEvent = state->EventHandle;
+
+				const DWORD bufferByteSize = static_cast<DWORD>(state->NotificationBuffer.size() * sizeof(DWORD));
+				if (!::ReadDirectoryChangesW(state->DirectoryHandle, state->NotificationBuffer.data(), bufferByteSize, TRUE, notifyFilter, nullptr, &state->Overlapped, nullptr))
+					return false;
+
+				state->ReadPending = true;
+			}
+
+			if (::WaitForSingleObject(state->EventHandle, timeoutMilliseconds) != WAIT_OBJECT_0)
+				return true;
+
+			DWORD bytesTransferred = 0;
+			state->ReadPending = false;
+			if (!::GetOverlappedResult(state->DirectoryHandle, &state->Overlapped, &bytesTransferred, FALSE))
+				return false;
+
+			// NOTE: The buffer overflowed and the individual changes have been lost
+			if (bytesTransferred == 0)
+			{
+				perChangedFileFunc(std::string_view());
+				return true;
+			}
+
+			const u8* notificationReadHead = reinterpret_cast<const u8*>(state->NotificationBuffer.data());
+			while (true)
+			{
+				const auto* notification = reinterpret_cast<const ::FILE_NOTIFY_INFORMATION*>(notificationReadHead);
+				if (notification->Action == FILE_ACTION_ADDED || notification->Action == FILE_ACTION_MODIFIED || notification->Action == FILE_ACTION_RENAMED_NEW_NAME)
+				{
+					const std::string relativeFilePath = UTF8::Narrow(std::wstring_view(notification->FileName, notification->FileNameLength / sizeof(WCHAR)));
+					perChangedFileFunc(relativeFilePath);
+				}
+
+				if (notification->NextEntryOffset == 0)
+					break;
+				notificationReadHead += notification->NextEntryOffset;
+			}
+
+			return true;
+		}
+
+		void ParseIniFileContent(std::string_view iniFileContent, std::function<void(std::string_view section, std::string_view key, std::string_view value)> perEntryFunc)
+		{
+			auto forEachNonCommentLine = [](std::string_view lines, auto perLineReturnFalseToStopFunc) -> void
+			{
+				for (size_t absoulteIndex = 0; absoulteIndex < lines.size(); absoulteIndex++)
+				{
+					const std::string_view remainingLines = lines.substr(absoulteIndex);
+					for (size_t relativeIndex = 0; relativeIndex < remainingLines.size(); relativeIndex++)
+					{
+						if (remainingLines[relativeIndex] == '\n')
+						{
+							const std::string_view line = remainingLines.substr(0, (relativeIndex > 0 && remainingLines[relativeIndex - 1] == '\r') ? (relativeIndex - 1) : relativeIndex);
+							if (!line.empty() && (line[0] != ';' && line[0] != '#') && !perLineReturnFalseToStopFunc(line))
+								return;
+
+							absoulteIndex += relativeIndex;
+							break;
+						}
+					}
+				}
+			};
+
+			auto tryParseSectionHeaderLine = [](std::string_view line) -> std::string_view
+			{
+				return (line.size() >= 2 && line.front() == '[' && line.back() == ']') ? line.substr(1, line.size() - 2) : "";
+			};
+
+			auto splitAndTrimKeyValuePairLine = [](std::string_view keyValuePairLine) -> std::pair<std::string_view, std::string_view>
+			{
+				const size_t separatorIndex = keyValuePairLine.find_first_of("=");
+				if (separatorIndex == std::string_view::npos)
+					return {};
+
+				const auto key = keyValuePairLine.substr(0, separatorIndex);
+				const auto value = keyValuePairLine.substr(separatorIndex + 1);
+				return { ASCII::Trim(key), ASCII::Trim(value) };
+			};
+
+			std::string_view lastSection;
+			forEachNonCommentLine(iniFileContent, [&](std::string_view nonCommentLine)
+			{
+				if (auto newSection = tryParseSectionHeaderLine(ASCII::Trim(nonCommentLine)); !newSection.empty())
+					lastSection = newSection;
+				else if (const auto[key, value] = splitAndTrimKeyValuePairLine(nonCommentLine); !key.empty())
+					perEntryFunc(lastSection, key, value);
+				return true;
+			});
+		}
+	}
+
+	namespace Threading
+	{
+		u32 GetHardwareThreadCount()
+		{
+			return std::max(1u, std::thread::hardware_concurrency());
+		}
+
+		void CancelBlockingIO(std::thread& thread)
+		{
+			::CancelSynchronousIo(reinterpret_cast<HANDLE>(thread.native_handle()));
+		}
+
+		void ParallelForEachIndex(size_t indexCount, u32 threadCount, const std::function<void(size_t index)>& perIndexFunc)
+		{
+			const size_t workerCount = std::min<size_t>(std::max(1u, threadCount), indexCount);
+			if (workerCount <= 1)
+			{
+				for (size_t i = 0; i < indexCount; i++)
+					perIndexFunc(i);
+				return;
+			}
+
+			std::atomic<size_t> nextIndex = 0;
+			auto workerFunc = [&]()
+			{
+				for (size_t i = nextIndex++; i < indexCount; i = nextIndex++)
+					perIndexFunc(i);
+			};
+
+			std::vector<std::thread> workerThreads;
+			workerThreads.reserve(workerCount - 1);
+			for (size_t i = 0; i < (workerCount - 1); i++)
+				workerThreads.emplace_back(workerFunc);
+
+			// NOTE: Let the calling thread pick up work too instead of idly waiting around
+			workerFunc();
+
+			for (auto& thread : workerThreads)
+				thread.join();
+		}
+
+		void BudgetedParallelForEachIndex(const std::vector<u64>& indexCosts, u32 threadCount, u64 costBudget, const std::function<void(size_t index)>& perIndexFunc)
+		{
+			const u64 effectiveBudget = (costBudget > 0) ? costBudget : std::numeric_limits<u64>::max();
+
+			std::mutex mutex;
+			std::condition_variable budgetReleased;
+			std::multiset<std::pair<u64, size_t>> remainingCostsAndIndices;
+			u64 inFlightCost = 0;
+			size_t inFlightCount = 0;
+
+			for (size_t i = 0; i < indexCosts.size(); i++)
+				remainingCostsAndIndices.emplace(indexCosts[i], i);
+
+			// NOTE: Returns the most costly remaining entry that still fits into the available budget, if any
+			auto tryFindLargestAdmittable = [&]() -> std::multiset<std::pair<u64, size_t>>::iterator
+			{
+				if (remainingCostsAndIndices.empty())
+					return remainingCostsAndIndices.end();
+				if (inFlightCount == 0)
+					return std::prev(remainingCostsAndIndices.end());
+
+				const u64 availableBudget = (inFlightCost < effectiveBudget) ? (effectiveBudget - inFlightCost) : 0;
+				auto firstLargerThanAvailable = remainingCostsAndIndices.upper_bound({ availableBudget, std::numeric_limits<size_t>::max() });
+				return (firstLargerThanAvailable == remainingCostsAndIndices.begin()) ? remainingCostsAndIndices.end() : std::prev(firstLargerThanAvailable);
+			};
+
+			ParallelForEachIndex(indexCosts.size(), threadCount, [&](size_t)
+			{
+				// NOTE: The index passed in is only used as a ticket, the actual work is picked based on the current budget
+				size_t index = 0;
+				u64 cost = 0;
+				{
+					std::unique_lock lock(mutex);
+					auto admitted = remainingCostsAndIndices.end();
+					budgetReleased.wait(lock, [&] { return (admitted = tryFindLargestAdmittable()) != remainingCostsAndIndices.end(); });
+
+					cost = admitted->first;
+					index = admitted->second;
+					remainingCostsAndIndices.erase(admitted);
+					inFlightCost += cost;
+					inFlightCount++;
+				}
+
+				perIndexFunc(index);
+
+				{
+					const auto lock = std::scoped_lock(mutex);
+					inFlightCost -= cost;
+					inFlightCount--;
+				}
+				budgetReleased.notify_all();
+			});
+		}
+
+		struct ThreadPool::State
+		{
+			std::mutex Mutex;
+			std::condition_variable TaskSubmitted;
+			std::deque<std::function<void()>> PendingTasks;
+			std::vector<std::thread> WorkerThreads;
+			bool ShuttingDown = false;
+		};
+
+		ThreadPool::ThreadPool(u32 threadCount) : state(std::make_unique<State>())
+		{
+			State* sharedState = state.get();
+			auto workerFunc = [sharedState]()
+			{
+				while (true)
+				{
+					std::function<void()> task;
+					{
+						std::unique_lock lock(sharedState->Mutex);
+						sharedState->TaskSubmitted.wait(lock, [&] { return sharedState->ShuttingDown || !sharedState->PendingTasks.empty(); });
+
+						// NOTE: Only exit once everything submitted before shutting down has been picked up
+						if (sharedState->PendingTasks.empty())
+							return;
+
+						task = std::move(sharedState->PendingTasks.front());
+						sharedState->PendingTasks.pop_front();
+					}
+					task();
+				}
+			};
+
+			state->WorkerThreads.reserve(std::max(1u, threadCount));
+			for (u32 i = 0; i < std::max(1u, threadCount); i++)
+				state->WorkerThreads.emplace_back(workerFunc);
+		}
+
+		ThreadPool::~ThreadPool()
+		{
+			{
+				const auto lock = std::scoped_lock(state->Mutex);
+				state->ShuttingDown = true;
+			}
+			state->TaskSubmitted.notify_all();
+
+			for (auto& thread : state->WorkerThreads)
+				thread.join();
+		}
+
+		void ThreadPool::Submit(std::function<void()> task)
+		{
+			{
+				const auto lock = std::scoped_lock(state->Mutex);
+				state->PendingTasks.push_back(std::move(task));
+			}
+			state->TaskSubmitted.notify_one();
+		}
+	}
+
+	namespace Crypto
+	{
+		namespace Detail
+		{
+			bool ParseHexByteString(std::string_view hexByteString, u8* outBytes, size_t outByteSize)
+			{
+				constexpr size_t hexDigitsPerByte = 2;
+				constexpr size_t byteBufferSize = 64;
+				assert(outByteSize < byteBufferSize);
+
+				char upperCaseHexChars[(byteBufferSize * hexDigitsPerByte) + sizeof('\0')] = {};
+				size_t hexCharsWrittenSoFar = 0;
+
+				for (size_t charIndex = 0; charIndex < hexByteString.size(); charIndex++)
+				{
+					if (ASCII::IsWhiteSpace(hexByteString[charIndex]))
+						continue;
+
+					const char upperCaseChar = ASCII::ToUpperCase(hexByteString[charIndex]);
+					upperCaseHexChars[hexCharsWrittenSoFar++] = ((upperCaseChar >= '0' && upperCaseChar <= '9') || (upperCaseChar >= 'A' && upperCaseChar <= 'F')) ? upperCaseChar : '0';
+
+					if (hexCharsWrittenSoFar >= std::size(upperCaseHexChars))
+						break;
+				}
+
+				for (size_t byteIndex = 0; byteIndex < outByteSize; byteIndex++)
+				{
+					auto upperCaseHexCharToNibble = [](char c) -> u8 { return (c >= '0' && c <= '9') ? (c - '0') : (c >= 'A' && c <= 'F') ? (0xA + (c - 'A')) : 0x0; };
+
+					u8 combinedByte = 0x00;
+					combinedByte |= (upperCaseHexCharToNibble(upperCaseHexChars[(byteIndex * hexDigitsPerByte) + 0]) << 4);
+					combinedByte |= (upperCaseHexCharToNibble(upperCaseHexChars[(byteIndex * hexDigitsPerByte) + 1]) << 0);
+					outBytes[byteIndex] = combinedByte;
+				}
+
+				return true;
+			}
+		}
+
+		AesCbcKey::AesCbcKey(const u8* key, size_t keySize) : algorithmHandle(nullptr), keyHandle(nullptr)
+		{
+			::NTSTATUS status = ::BCryptOpenAlgorithmProvider(&algorithmHandle, BCRYPT_AES_ALGORITHM, nullptr, 0);
+			if (!NT_SUCCESS(status))
+			{
+				fprintf(stderr, "BCryptOpenAlgorithmProvider(BCRYPT_AES_ALGORITHM) failed with 0x%X\n", status);
+				algorithmHandle = nullptr;
+				return;
+			}
+
+			status = ::BCryptSetProperty(algorithmHandle, BCRYPT_CHAINING_MODE, reinterpret_cast<PBYTE>(const_cast<wchar_t*>(BCRYPT_CHAIN_MODE_CBC)), sizeof(BCRYPT_CHAIN_MODE_CBC), 0);
+			if (!NT_SUCCESS(status))
+			{
+				fprintf(stderr, "BCryptSetProperty(BCRYPT_CHAINING_MODE) failed with 0x%X\n", status);
+				return;
+			}
+
+			ULONG keyObjectSize = {};
+			ULONG copiedDataSize = {};
+
+			status = ::BCryptGetProperty(algorithmHandle, BCRYPT_OBJECT_LENGTH, reinterpret_cast<PBYTE>(&keyObjectSize), sizeof(ULONG), &copiedDataSize, 0);
+			if (!NT_SUCCESS(status))
+			{
+				fprintf(stderr, "BCryptGetProperty(BCRYPT_OBJECT_LENGTH) failed with 0x%X\n", status);
+				return;
+			}
+
+			keyObject = Memory::MakeTrackedBuffer(keyObjectSize);
+			status = ::BCryptGenerateSymmetricKey(algorithmHandle, &keyHandle, keyObject.get(), keyObjectSize, const_cast<u8*>(key), static_cast<ULONG>(keySize), 0);
+			if (!NT_SUCCESS(status))
+			{
+				fprintf(stderr, "BCryptGenerateSymmetricKey() failed with 0x%X\n", status);
+				keyHandle = nullptr;
+			}
+		}
+
+		AesCbcKey::~AesCbcKey()
+		{
+			if (keyHandle)
+				::BCryptDestroyKey(keyHandle);
+			if (algorithmHandle)
+				::BCryptCloseAlgorithmProvider(algorithmHandle, 0);
+		}
+
+		bool AesCbcKey::IsValid() const
+		{
+			return (keyHandle != nullptr);
+		}
+
+		bool AesCbcKey::Decrypt(const u8* inEncryptedData, u8* outDecryptedData, size_t inOutDataSize, AesIVBytes iv) const
+		{
+			if (!IsValid())
+				return false;
+
+			ULONG copiedDataSize = {};
+			::NTSTATUS status = ::BCryptDecrypt(keyHandle, const_cast<u8*>(inEncryptedData), static_cast<ULONG>(inOutDataSize), nullptr, iv.data(), static_cast<ULONG>(iv.size()), outDecryptedData, static_cast<ULONG>(inOutDataSize), &copiedDataSize, 0);
+			if (!NT_SUCCESS(status))
+			{
+				fprintf(stderr, "BCryptDecrypt() failed with 0x%X\n", status);
+				return false;
+			}
+
+			return true;
+		}
+
+		bool AesCbcKey::Encrypt(const u8* inDecryptedData, u8* outEncryptedData, size_t inOutDataSize, AesIVBytes iv) const
+		{
+			assert(Align(inOutDataSize, AesBlockAlignment) == inOutDataSize);
+			if (!IsValid())
+				return false;
+
+			ULONG copiedDataSize = {};
+			::NTSTATUS status = ::BCryptEncrypt(keyHandle, const_cast<u8*>(inDecryptedData), static_cast<ULONG>(inOutDataSize), nullptr, iv.data(), static_cast<ULONG>(iv.size()), outEncryptedData, static_cast<ULONG>(inOutDataSize), &copiedDataSize, 0);
+			if (!NT_SUCCESS(status))
+			{
+				fprintf(stderr, "BCryptEncrypt() failed with 0x%X\n", status);
+				return false;
+			}
+
+			return true;
+		}
+
+		bool DecryptAes128Cbc(const u8* inEncryptedData, u8* outDecryptedData, size_t inOutDataSize, Aes128KeyBytes key, AesIVBytes iv)
+		{
+			return AesCbcKey(key.data(), key.size()).Decrypt(inEncryptedData, outDecryptedData, inOutDataSize, iv);
+		}
+
+		bool EncryptAes128Cbc(const u8* inDecryptedData, u8* outEncryptedData, size_t inOutDataSize, Aes128KeyBytes key, AesIVBytes iv)
+		{
+			return AesCbcKey(key.data(), key.size()).Encrypt(inDecryptedData, outEncryptedData, inOutDataSize, iv);
+		}
+
+		bool DecryptAes256Cbc(const u8* inEncryptedData, u8* outDecryptedData, size_t inOutDataSize, Aes256KeyBytes key, AesIVBytes iv)
+		{
+			return AesCbcKey(key.data(), key.size()).Decrypt(inEncryptedData, outDecryptedData, inOutDataSize, iv);
+		}
+
+		bool EncryptAes256Cbc(const u8* inDecryptedData, u8* outEncryptedData, size_t inOutDataSize, Aes256KeyBytes key, AesIVBytes iv)
+		{
+			return AesCbcKey(key.data(), key.size()).Encrypt(inDecryptedData, outEncryptedData, inOutDataSize, iv);
+		}
+
+		Aes128KeyBytes ParseAes128KeyHexByteString(std::string_view hexByteString)
+		{
+			Aes128KeyBytes result = {};
+			Detail::ParseHexByteString(hexByteString, result.data(), result.size());
+			return result;
+		}
+
+		Aes256KeyBytes ParseAes256KeyHexByteString(std::string_view hexByteString)
+		{
+			Aes256KeyBytes result = {};
+			Detail::ParseHexByteString(hexByteString, result.data(), result.size());
+			return result;
+		}
+
+		Sha256Hasher::Sha256Hasher() : Sha256Hasher(nullptr, 0)
+		{
+		}
+
+		Sha256Hasher::Sha256Hasher(const u8* hmacKey, size_t hmacKeySize) : algorithmHandle(nullptr), hashHandle(nullptr)
+		{
+			::NTSTATUS status = ::BCryptOpenAlgorithmProvider(&algorithmHandle, BCRYPT_SHA256_ALGORITHM, nullptr, (hmacKey != nullptr) ? BCRYPT_ALG_HANDLE_HMAC_FLAG : 0);
+			if (!NT_SUCCESS(status))
+			{
+				fprintf(stderr, "BCryptOpenAlgorithmProvider(BCRYPT_SHA256_ALGORITHM) failed with 0x%X\n", status);
+				algorithmHandle = nullptr;
+				return;
+			}
+
+			ULONG hashObjectSize = {};
+			ULONG copiedDataSize = {};
+
+			status = ::BCryptGetProperty(algorithmHandle, BCRYPT_OBJECT_LENGTH, reinterpret_cast<PBYTE>(&hashObjectSize), sizeof(ULONG), &copiedDataSize, 0);
+			if (!NT_SUCCESS(status))
+			{
+				fprintf(stderr, "BCryptGetProperty(BCRYPT_OBJECT_LENGTH) failed with 0x%X\n", status);
+				return;
+			}
+
+			hashObject = Memory::MakeTrackedBuffer(hashObjectSize);
+			status = ::BCryptCreateHash(algorithmHandle, &hashHandle, hashObject.get(), hashObjectSize, const_cast<u8*>(hmacKey), static_cast<ULONG>(hmacKeySize), 0);
+			if (!NT_SUCCESS(status))
+			{
+				fprintf(stderr, "BCryptCreateHash() failed with 0x%X\n", status);
+				hashHandle = nullptr;
+			}
+		}
+
+		Sha256Hasher::~Sha256Hasher()
+		{
+			if (hashHandle)
+				::BCryptDestroyHash(hashHandle);
+			if (algorithmHandle)
+				::BCryptCloseAlgorithmProvider(algorithmHandle, 0);
+		}
+
+		void Sha256Hasher::Update(const u8* data, size_t dataSize)
+		{
+			if (hashHandle && dataSize > 0)
+				::BCryptHashData(hashHandle, const_cast<u8*>(data), static_cast<ULONG>(dataSize), 0);
+		}
+
+		Sha256Digest Sha256Hasher::Finish()
+		{
+			Sha256Digest digest = {};
+			if (hashHandle)
+				::BCryptFinishHash(hashHandle, digest.data(), static_cast<ULONG>(digest.size()), 0);
+			return digest;
+		}
+
+		Sha256Digest HashSha256(const u8* data, size_t dataSize)
+		{
+			Sha256Hasher hasher;
+			hasher.Update(data, dataSize);
+			return hasher.Finish();
+		}
+
+		Sha256Digest HmacSha256(const u8* key, size_t keySize, const u8* data, size_t dataSize)
+		{
+			Sha256Hasher hasher(key, keySize);
+			hasher.Update(data, dataSize);
+			return hasher.Finish();
+		}
+
+		std::string FormatSha256DigestHexString(const Sha256Digest& digest)
+		{
+			constexpr const char* hexDigits = "0123456789abcdef";
+
+			std::string hexString;
+			hexString.reserve(digest.size() * 2);
+			for (const u8 byte : digest)
+			{
+				hexString += hexDigits[byte >> 4];
+				hexString += hexDigits[byte & 0xF];
+			}
+			return hexString;
+		}
+
+		Sha256Digest ParseSha256DigestHexString(std::string_view hexByteString)
+		{
+			Sha256Digest result = {};
+			Detail::ParseHexByteString(hexByteString, result.data(), result.size());
+			return result;
+		}
+	}
+
+	namespace Compression
+	{
+		namespace
+		{
+#pragma pack(push, 1)
+			struct GZipHeader
+			{
+				u8 Magic[2];
+				u8 CompressionMethod;
+				u8 Flags;
+				u32 Timestamp;
+				u8 ExtraFlags;
+				u8 OperatingSystem;
+			};
+#pragma pack(pop)
+
+			static_assert(sizeof(GZipHeader) == 10);
+
+			voidpf ZLibTrackedAlloc(voidpf opaque, uInt items, uInt size)
+			{
+				return Memory::TrackedAlloc(static_cast<size_t>(items) * size);
+			}
+
+			void ZLibTrackedFree(voidpf opaque, voidpf address)
+			{
+				Memory::TrackedFree(address);
+			}
+		}
+
+		bool HasValidGZipHeader(const u8* fileContent, size_t fileSize)
+		{
+			if (fileSize <= sizeof(GZipHeader))
+				return false;
+
+			const GZipHeader* header = reinterpret_cast<const GZipHeader*>(fileContent);
+
+			// NOTE: This is by no means comprehensive but should be enough for datatable files and (not falsely) detecting encrypted data
+#if 0
+			return (header->Magic[0] == 0x1F && header->Magic[1] == 0x8B) &&
+				(header->CompressionMethod == Z_DEFLATED) &&
+				(header->Flags == 0) &&
+				(header->Timestamp == 0) &&
+				(header->ExtraFlags == 0);
+#else // NOTE: Less precise because becuase of some false negatives
+			return (header->Magic[0] == 0x1F && header->Magic[1] == 0x8B) &&
+				(header->CompressionMethod == Z_DEFLATED);
+#endif
+		}
+
+		bool Inflate(const u8* inCompressedData, size_t inDataSize, u8* outDecompressedData, size_t outDataSize)
+		{
+			z_stream zStream = {};
+			zStream.zalloc = ZLibTrackedAlloc;
+			zStream.zfree = ZLibTrackedFree;
+			zStream.opaque = Z_NULL;
+			zStream.avail_in = static_cast<uInt>(inDataSize);
+			zStream.next_in = static_cast<const Bytef*>(inCompressedData);
+			zStream.avail_out = static_cast<uInt>(outDataSize);
+			zStream.next_out = static_cast<Bytef*>(outDecompressedData);
+
+			const int initResult = inflateInit2(&zStream, 31);
+			if (initResult != Z_OK)
+				return false;
+
+			// NOTE: Anything short of reaching the end of the stream (including the GZip CRC32 + size trailer) means the input was truncated or corrupted,
+			//		 or that it didn't fit into the output buffer. Trailing bytes after the end of the stream (such as AES zero padding) are ignored
+			const int inflateResult = inflate(&zStream, Z_FINISH);
+
+			const int endResult = inflateEnd(&zStream);
+			if (endResult != Z_OK)
+				return false;
+
+			return (inflateResult == Z_STREAM_END);
+		}
+
+		bool InflateStreamed(const u8* inCompressedData, size_t inDataSize, const std::function<void(const u8* chunk, size_t chunkSize)>& perChunkFunc, size_t* outDecompressedSize)
+		{
+			constexpr size_t chunkStepSize = 0x4000;
+
+			z_stream zStream = {};
+			zStream.zalloc = ZLibTrackedAlloc;
+			zStream.zfree = ZLibTrackedFree;
+			zStream.opaque = Z_NULL;
+			zStream.avail_in = static_cast<uInt>(inDataSize);
+			zStream.next_in = static_cast<const Bytef*>(inCompressedData);
+
+			const int initResult = inflateInit2(&zStream, 31);
+			if (initResult != Z_OK)
+				return false;
+
+			int inflateResult = Z_OK;
+			size_t decompressedSize = 0;
+
+			do
+			{
+				std::array<u8, chunkStepSize> outputBuffer;
+
+				zStream.avail_out = chunkStepSize;
+				zStream.next_out = outputBuffer.data();
+
+				inflateResult = inflate(&zStream, Z_NO_FLUSH);
+				if (inflateResult != Z_OK && inflateResult != Z_STREAM_END)
+					break;
+
+				const auto decompressedChunkSize = chunkStepSize - zStream.avail_out;
+				if (decompressedChunkSize > 0)
+					perChunkFunc(outputBuffer.data(), decompressedChunkSize);
+
+				decompressedSize += decompressedChunkSize;
+			}
+			while (inflateResult != Z_STREAM_END);
+
+			inflateEnd(&zStream);
+
+			if (outDecompressedSize != nullptr)
+				*outDecompressedSize = decompressedSize;
+
+			return (inflateResult == Z_STREAM_END);
+		}
+
+		struct Inflater::State
+		{
+			z_stream ZStream;
+			bool Finished;
+		};
+
+		Inflater::Inflater() : state(std::make_unique<State>())
+		{
+			state->ZStream = {};
+			state->ZStream.zalloc = ZLibTrackedAlloc;
+			state->ZStream.zfree = ZLibTrackedFree;
+			state->ZStream.opaque = Z_NULL;
+			state->Finished = false;
+
+			int errorCode = inflateInit2(&state->ZStream, 31);
+			assert(errorCode == Z_OK);
+		}
+
+		Inflater::~Inflater()
+		{
+			inflateEnd(&state->ZStream);
+		}
+
+		bool Inflater::Update(const u8* inCompressedData, size_t inDataSize, const std::function<void(const u8* chunk, size_t chunkSize)>& perChunkFunc)
+		{
+			constexpr size_t chunkStepSize = 0x4000;
+			z_stream& zStream = state->ZStream;
+
+			if (state->Finished)
+				return true;
+
+			zStream.avail_in = static_cast<uInt>(inDataSize);
+			zStream.next_in = static_cast<const Bytef*>(inCompressedData);
+
+			do
+			{
+				std::array<u8, chunkStepSize> outputBuffer;
+
+				zStream.avail_out = chunkStepSize;
+				zStream.next_out = outputBuffer.data();
+
+				const int inflateResult = inflate(&zStream, Z_NO_FLUSH);
+				if (inflateResult != Z_OK && inflateResult != Z_STREAM_END && inflateResult != Z_BUF_ERROR)
+					return false;
+
+				const auto decompressedChunkSize = chunkStepSize - zStream.avail_out;
+				if (decompressedChunkSize > 0)
+					perChunkFunc(outputBuffer.data(), decompressedChunkSize);
+
+				if (inflateResult == Z_STREAM_END)
+				{
+					state->Finished = true;
+					break;
+				}
+			}
+			while (zStream.avail_in > 0 || zStream.avail_out == 0);
+
+			return true;
+		}
+
+		bool Inflater::IsFinished() const
+		{
+			return state->Finished;
+		}
+
+		size_t Deflate(const u8* inData, size_t inDataSize, u8* outCompressedData, size_t outDataSize)
+		{
+			Deflater deflater;
+			return deflater.Deflate(inData, inDataSize, outCompressedData, outDataSize);
+		}
+
+		struct Deflater::State
+		{
+			z_stream ZStream;
+		};
+
+		Deflater::Deflater() : state(std::make_unique<State>())
+		{
+			state->ZStream = {};
+			state->ZStream.zalloc = ZLibTrackedAlloc;
+			state->ZStream.zfree = ZLibTrackedFree;
+			state->ZStream.opaque = Z_NULL;
+
+			int errorCode = deflateInit2(&state->ZStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 31, 8, Z_DEFAULT_STRATEGY);
+			assert(errorCode == Z_OK);
+		}
+
+		Deflater::~Deflater()
+		{
+			deflateEnd(&state->ZStream);
+		}
+
+		bool Deflater::Update(const u8* inData, size_t inDataSize, const std::function<void(const u8* chunk, size_t chunkSize)>& perChunkFunc)
+		{
+			return DeflateStreamed(inData, inDataSize, Z_NO_FLUSH, perChunkFunc);
+		}
+
+		bool Deflater::Finish(const std::function<void(const u8* chunk, size_t chunkSize)>& perChunkFunc)
+		{
+			const bool success = DeflateStreamed(nullptr, 0, Z_FINISH, perChunkFunc);
+			deflateReset(&state->ZStream);
+			return success;
+		}
+
+		bool Deflater::DeflateStreamed(const u8* inData, size_t inDataSize, int flush, const std::function<void(const u8* chunk, size_t chunkSize)>& perChunkFunc)
+		{
+			constexpr size_t chunkStepSize = 0x4000;
+			z_stream& zStream = state->ZStream;
+
+			zStream.avail_in = static_cast<uInt>(inDataSize);
+			zStream.next_in = reinterpret_cast<const Bytef*>(inData);
+
+			int errorCode = Z_OK;
+			do
+			{
+				std::array<u8, chunkStepSize> outputBuffer;
+
+				zStream.avail_out = chunkStepSize;
+				zStream.next_out = outputBuffer.data();
+
+				errorCode = deflate(&zStream, flush);
+				if (errorCode == Z_STREAM_ERROR)
+					return false;
+
+				const auto compressedChunkSize = chunkStepSize - zStream.avail_out;
+				if (compressedChunkSize > 0)
+					perChunkFunc(outputBuffer.data(), compressedChunkSize);
+			}
+			while (zStream.avail_out == 0);
+
+			assert(zStream.avail_in == 0);
+			return (flush != Z_FINISH || errorCode == Z_STREAM_END);
+		}
+
+		size_t Deflater::Deflate(const u8* inData, size_t inDataSize, u8* outCompressedData, size_t outDataSize)
+		{
+			constexpr size_t chunkStepSize = 0x4000;
+			z_stream& zStream = state->ZStream;
+
+			const u8* inDataReadHeader = static_cast<const u8*>(inData);
+			size_t remainingSize = inDataSize;
+			size_t compressedSize = 0;
+			int errorCode = Z_OK;
+
+			while (remainingSize > 0)
+			{
+				const size_t chunkSize = std::min(remainingSize, chunkStepSize);
+
+				zStream.avail_in = static_cast<uInt>(chunkSize);
+				zStream.next_in = reinterpret_cast<const Bytef*>(inDataReadHeader);
+
+				inDataReadHeader += chunkSize;
+				remainingSize -= chunkSize;
+
+				do
+				{
+					std::array<u8, chunkStepSize> outputBuffer;
+
+					zStream.avail_out = chunkStepSize;
+					zStream.next_out = outputBuffer.data();
+
+					errorCode = deflate(&zStream, remainingSize == 0 ? Z_FINISH : Z_NO_FLUSH);
+					assert(errorCode != Z_STREAM_ERROR);
+
+					const auto compressedChunkSize = chunkStepSize - zStream.avail_out;
+					memcpy(&outCompressedData[compressedSize], outputBuffer.data(), compressedChunkSize);
+
+					compressedSize += compressedChunkSize;
+				}
+				while (zStream.avail_out == 0);
+				assert(zStream.avail_in == 0);
+			}
+
+			deflateReset(&zStream);
+
+			assert(errorCode == Z_STREAM_END);
+			return compressedSize;
+		}
+	}
+}
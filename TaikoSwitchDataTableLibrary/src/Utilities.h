@@ -0,0 +1,478 @@
+#pragma once
+#include "Types.h"
+#include <stdio.h>
+#include <thread>
+
+// NOTE: In case anyone is wondering... no, there is no particular reason for these names. 
+//		 I just like Peepo and it cheers me up after looking at code all day :WidePeepoHappy:
+#define EXIT_WIDEPEEPOHAPPY EXIT_SUCCESS
+#define EXIT_WIDEPEEPOSAD EXIT_FAILURE
+
+namespace PeepoHappy
+{
+	namespace ASCII
+	{
+		constexpr const char* WhiteSpaceCharacters = " \t\r\n";
+		constexpr char CaseDifference = ('A' - 'a');
+		constexpr char LowerCaseMin = 'a', LowerCaseMax = 'z';
+		constexpr char UpperCaseMin = 'A', UpperCaseMax = 'Z';
+
+		constexpr bool IsWhiteSpace(char c) { return (c == WhiteSpaceCharacters[0] || c == WhiteSpaceCharacters[1] || c == WhiteSpaceCharacters[2] || c == WhiteSpaceCharacters[3]); }
+		constexpr bool IsLowerCase(char c) { return (c >= LowerCaseMin && c <= LowerCaseMax); }
+		constexpr bool IsUpperCase(char c) { return (c >= UpperCaseMin && c <= UpperCaseMax); }
+		constexpr char ToLowerCase(char c) { return IsUpperCase(c) ? (c - CaseDifference) : c; }
+		constexpr char ToUpperCase(char c) { return IsLowerCase(c) ? (c + CaseDifference) : c; }
+
+		constexpr bool CaseSensitiveComparison(char a, char b) { return (a == b); }
+		constexpr bool CaseInsenitiveComparison(char a, char b) { return (ToLowerCase(a) == ToLowerCase(b)); }
+
+		constexpr bool Matches(std::string_view a, std::string_view b) { if (a.size() != b.size()) return false; for (auto i = 0; i < a.size(); i++) { if (!CaseSensitiveComparison(a[i], b[i])) return false; } return true; }
+		constexpr bool MatchesInsensitive(std::string_view a, std::string_view b) { if (a.size() != b.size()) return false; for (auto i = 0; i < a.size(); i++) { if (!CaseInsenitiveComparison(a[i], b[i])) return false; } return true; }
+		constexpr bool StartsWith(std::string_view s, std::string_view prefix) { return (s.size() >= prefix.size() && Matches(s.substr(0, prefix.size()), prefix)); }
+		constexpr bool StartsWithInsensitive(std::string_view s, std::string_view prefix) { return (s.size() >= prefix.size() && MatchesInsensitive(s.substr(0, prefix.size()), prefix)); }
+		constexpr bool EndsWith(std::string_view s, std::string_view suffix) { return (s.size() >= suffix.size() && Matches(s.substr(s.size() - suffix.size()), suffix)); }
+		constexpr bool EndsWithInsensitive(std::string_view s, std::string_view suffix) { return (s.size() >= suffix.size() && MatchesInsensitive(s.substr(s.size() - suffix.size()), suffix)); }
+
+		constexpr std::string_view StripPrefix(std::string_view s, std::string_view prefix) { return StartsWith(s, prefix) ? s.substr(prefix.size(), s.size() - prefix.size()) : s; }
+		constexpr std::string_view StripPrefixInsensitive(std::string_view s, std::string_view prefix) { return StartsWithInsensitive(s, prefix) ? s.substr(prefix.size(), s.size() - prefix.size()) : s; }
+		constexpr std::string_view StripSuffix(std::string_view s, std::string_view suffix) { return EndsWith(s, suffix) ? s.substr(0, s.size() - suffix.size()) : s; }
+		constexpr std::string_view StripSuffixInsensitive(std::string_view s, std::string_view suffix) { return EndsWithInsensitive(s, suffix) ? s.substr(0, s.size() - suffix.size()) : s; }
+
+		constexpr std::string_view TrimLeft(std::string_view s) { auto f = s.find_first_not_of(WhiteSpaceCharacters); return (f == std::string_view::npos) ? s : s.substr(f); }
+		constexpr std::string_view TrimRight(std::string_view s) { auto l = s.find_last_not_of(WhiteSpaceCharacters); return (l == std::string_view::npos) ? s : s.substr(0, l + 1); }
+		constexpr std::string_view Trim(std::string_view s) { return TrimRight(TrimLeft(s)); }
+	}
+
+	// NOTE: Following the "UTF-8 Everywhere" guidelines
+	namespace UTF8
+	{
+		// NOTE: Convert UTF-16 to UTF-8
+		std::string Narrow(std::wstring_view);
+
+		// NOTE: Convert UTF-8 to UTF-16
+		std::wstring Widen(std::string_view);
+
+		// NOTE: To avoid needless heap allocations for temporary wchar_t C-API function arguments
+		//		 Example: DummyU16FuncW(UTF8::WideArg(stringU8).c_str(), ...)
+		class WideArg : NonCopyable
+		{
+		public:
+			WideArg(std::string_view);
+			const wchar_t* c_str() const;
+
+		private:
+			std::unique_ptr<wchar_t[]> heapBuffer;
+			std::array<wchar_t, 260> stackBuffer;
+			int convertedLength;
+		};
+
+		// NOTE: By no means reliable but should be good enough to quickly detect UTF-16 text
+		bool AppearsToUse8BitCodeUnits(std::string_view uncertainUTF8Text);
+
+		// NOTE: Includes the program file path as first arguments
+		std::pair<int, const char**> GetCommandLineArguments();
+
+		std::string GetExecutableFilePath();
+		std::string GetExecutableDirectory();
+
+		// NOTE: NetBIOS name of the local computer, to tell apart processes running on different machines
+		std::string GetMachineName();
+	}
+
+	namespace Memory
+	{
+		// NOTE: Optional hook notified of every allocation (positive byte size) and deallocation (negative byte size)
+		//		 made through the functions below, called from whichever thread made them
+		using AllocationHook = void(*)(i64 byteSizeDelta);
+		void SetAllocationHook(AllocationHook hook);
+
+		struct TrackedBufferDeleter
+		{
+			size_t ByteSize;
+			void operator()(u8* buffer) const;
+		};
+
+		using TrackedBuffer = std::unique_ptr<u8[], TrackedBufferDeleter>;
+
+		// NOTE: Drop-in replacement for std::make_unique<u8[]>() (including zero initialization) that reports to the allocation hook
+		TrackedBuffer MakeTrackedBuffer(size_t byteSize);
+
+		// NOTE: For third party code with C style alloc/free callbacks that don't pass along the size when freeing
+		void* TrackedAlloc(size_t byteSize);
+		void TrackedFree(void* address);
+	}
+
+	namespace Path
+	{
+		std::string_view GetFileExtension(std::string_view filePath);
+		std::string_view GetFileName(std::string_view filePath, bool includeExtension = true);
+		std::string_view TrimFileExtension(std::string_view filePath);
+		std::string_view GetDirectoryName(std::string_view filePath);
+		bool HasFileExtension(std::string_view filePath, std::string_view extensionToCheckFor);
+	}
+
+	namespace IO
+	{
+		std::pair<Memory::TrackedBuffer, size_t> ReadEntireFile(std::string_view filePath);
+		bool WriteEntireFile(std::string_view filePath, const u8* fileContent, size_t fileSize);
+
+		// NOTE: Writes to a uniquely named temporary file next to the destination first which is then renamed,
+		//		 so that other threads and processes never observe a partially written file
+		bool WriteEntireFileAtomically(std::string_view filePath, const u8* fileContent, size_t fileSize);
+
+		// NOTE: Named to avoid clashing with the CopyFile / DeleteFile / CreateDirectory Win32 macros.
+		//		 Copies are done by the OS which can avoid moving data through user space (or even clone blocks on ReFS)
+		bool DuplicateFile(std::string_view sourceFilePath, std::string_view destinationFilePath);
+		bool RenameFile(std::string_view sourceFilePath, std::string_view destinationFilePath);
+		bool RemoveFile(std::string_view filePath);
+		bool RemoveEmptyDirectory(std::string_view directoryPath);
+		bool CreateDirectoryRecursive(std::string_view directoryPath);
+		bool SetLastWriteTimeToNow(std::string_view filePath);
+		// NOTE: Fails if the file already exists, which is decided atomically by the file system (including SMB shares) so that it can be used as a lock
+		bool CreateNewFile(std::string_view filePath, const u8* fileContent, size_t fileSize);
+
+		bool DirectoryExists(std::string_view directoryPath);
+
+		// NOTE: Without having to open (let alone read) the file, returns 0 if it doesn't exist
+		u64 GetFileSize(std::string_view filePath);
+
+		struct FileMetadata
+		{
+			u64 Size;
+			// NOTE: In 100-nanosecond intervals since January 1, 1601 (UTC), same as a FILETIME
+			u64 LastWriteTime;
+
+			constexpr bool operator==(const FileMetadata& other) const { return (Size == other.Size && LastWriteTime == other.LastWriteTime); }
+			constexpr bool operator!=(const FileMetadata& other) const { return !(*this == other); }
+		};
+
+		// NOTE: Same as GetFileSize() but including the last write time, both are 0 if the file doesn't exist
+		FileMetadata GetFileMetadata(std::string_view filePath);
+		// NOTE: The current system time in the same unit as FileMetadata::LastWriteTime
+		u64 GetCurrentFileTime();
+		// NOTE: The number of hard links (directory entries) sharing the data of the file, 0 if the file doesn't exist
+		u32 GetFileLinkCount(std::string_view filePath);
+
+		// NOTE: Reads up to bufferSize bytes from the start of the file, returns the number of bytes read (0 if the file doesn't exist)
+		size_t ReadFileHead(std::string_view filePath, u8* outBuffer, size_t bufferSize);
+
+		// NOTE: Recursively visits every file (but not the directories themselves) contained within the input directory
+		void ForEachFileInDirectory(std::string_view directoryPath, std::function<void(std::string_view filePath)> perFileFunc);
+
+		// NOTE: So that binary data piped through stdin / stdout doesn't get its line endings translated
+		void SetStandardStreamsToBinaryMode();
+
+		struct FileStreamDeleter
+		{
+			void operator()(FILE* stream) const;
+		};
+
+		using FileStream = std::unique_ptr<FILE, FileStreamDeleter>;
+
+		// NOTE: Buffered stdio stream for processing large files front to back without holding them in memory as a whole, null on failure
+		FileStream OpenFileStream(std::string_view filePath, const wchar_t* mode);
+
+		// NOTE: Resolves relative paths against the current working directory
+		std::string GetFullPath(std::string_view filePath);
+
+		// NOTE: Byte stream based local named pipe ("\\.\pipe\{name}"). Either side reads and writes whole buffers at a time
+		class NamedPipe : NonCopyable
+		{
+		public:
+			NamedPipe() = default;
+			~NamedPipe();
+
+			bool IsValid() const;
+
+			// NOTE: Server side, any number of instances can be created for the same pipe name with each serving one client at a time
+			bool Create(std::string_view pipeName);
+			bool WaitForClient();
+			void DisconnectClient();
+
+			// NOTE: Client side
+			bool Connect(std::string_view pipeName, u32 timeoutMilliseconds);
+
+			bool ReadExact(void* outData, size_t dataSize);
+			bool WriteAll(const void* data, size_t dataSize);
+
+		private:
+			void* pipeHandle = nullptr;
+		};
+
+		// NOTE: Makes a whole batch of output files durable at once instead of paying for a separate flush after every single one.
+		//		 Files are written to temporary files next to their destination and only flushed to disk and renamed into place by Commit(),
+		//		 so that an interrupted batch never leaves behind truncated output files. Stage() can be called from any number of threads
+		class GroupCommitWriter : NonCopyable
+		{
+		public:
+			GroupCommitWriter();
+			// NOTE: Removes all staged files that haven't been committed
+			~GroupCommitWriter();
+
+			bool Stage(std::string_view filePath, const u8* fileContent, size_t fileSize);
+			// NOTE: Must not be called while other threads are still staging files. If flushing any of the staged files fails
+			//		 none of them are renamed, otherwise returns false if any of the renames failed
+			bool Commit();
+
+			// NOTE: All files renamed into place by previous commits
+			const std::vector<std::string>& GetCommittedFilePaths() const;
+			// NOTE: All files that were staged but discarded by previous commits, which leaves their destination untouched
+			const std::vector<std::string>& GetDiscardedFilePaths() const;
+
+		private:
+			struct State;
+			std::unique_ptr<State> state;
+		};
+
+		enum class AsyncFileOperation : u8
+		{
+			Read,
+			Write,
+			// NOTE: Not an actual I/O operation but a notification sent using AsyncFileQueue::Post(), for example by another thread that finished processing a read
+			Posted,
+		};
+
+		struct AsyncFileCompletion
+		{
+			AsyncFileOperation Operation;
+			bool Success;
+			u64 Tag;
+			// NOTE: Only set for reads, the file content inside of the pooled buffer which stays valid until it is released
+			const u8* Data;
+			size_t Size;
+			u32 BufferIndex;
+		};
+
+		// NOTE: Keeps many whole file reads and writes in flight at once using overlapped I/O on an I/O completion port, so that a single thread
+		//		 can drive all of the I/O of a batch while other threads do nothing but compute. Reads go into a fixed set of pooled buffers allocated
+		//		 up front (limiting the number of reads in flight to the queue depth), writes are issued directly from the memory of the caller
+		//		 which has to stay valid until their completion. Apart from Post() all functions must be called from the same thread.
+		//		 With a non zero I/O thread count operations are instead performed using plain blocking I/O by that many dedicated threads,
+		//		 which post their completions to the same port (useful where overlapped I/O on regular files ends up completing synchronously anyway)
+		class AsyncFileQueue : NonCopyable
+		{
+		public:
+			static constexpr u32 InvalidBufferIndex = 0xFFFFFFFF;
+
+			AsyncFileQueue(u32 queueDepth, size_t bufferSize, u32 ioThreadCount = 0);
+			~AsyncFileQueue();
+
+			// NOTE: False if the completion port couldn't be created, in which case blocking I/O should be used instead
+			bool IsValid() const;
+			bool HasFreeBuffer() const;
+
+			// NOTE: Using overlapped I/O this fails right away (without any completion) for files that can't be opened or are larger than the buffer size,
+			//		 using I/O threads it only fails once all buffers are in use and reports everything else through a failed completion
+			bool SubmitRead(std::string_view filePath, u64 tag);
+			bool SubmitWrite(std::string_view filePath, const u8* fileContent, size_t fileSize, u64 tag);
+			// NOTE: Thread safe
+			void Post(u64 tag);
+
+			// NOTE: Blocks until the next read, write or posted notification has completed
+			AsyncFileCompletion WaitForCompletion();
+			void ReleaseBuffer(u32 bufferIndex);
+
+		private:
+			struct State;
+			std::unique_ptr<State> state;
+		};
+
+		// NOTE: Read-only view of an entire file mapped into the address space, so that large files can be accessed
+		//		 in place with the OS paging in only the parts actually touched instead of reading everything up front
+		class MemoryMappedFile : NonCopyable
+		{
+		public:
+			MemoryMappedFile() = default;
+			~MemoryMappedFile();
+
+			bool Open(std::string_view filePath);
+			bool IsValid() const;
+
+			const u8* GetData() const;
+			size_t GetSize() const;
+
+		private:
+			void* fileHandle = nullptr;
+			void* mappingHandle = nullptr;
+			const u8* mappedView = nullptr;
+			size_t mappedSize = 0;
+		};
+
+		// NOTE: Recursively watches a directory for files being created, written to or renamed
+		class DirectoryWatcher : NonCopyable
+		{
+		public:
+			DirectoryWatcher(std::string_view directoryPath);
+			~DirectoryWatcher();
+
+			bool IsValid() const;
+
+			// NOTE: Waits up to the timeout for changes, invoking the input function once per changed file path (relative to the watched directory).
+			//		 If changes happened faster than they could be recorded the function is invoked with an empty path instead.
+			//		 Returns false if the directory can no longer be watched
+			bool WaitForChanges(u32 timeoutMilliseconds, const std::function<void(std::string_view relativeFilePath)>& perChangedFileFunc);
+
+		private:
+			struct State;
+			std::unique_ptr<State> state;
+		};
+
+		void ParseIniFileContent(std::string_view iniFileContent, std::function<void(std::string_view section, std::string_view key, std::string_view value)> perEntryFunc);
+	}
+
+	namespace Threading
+	{
+		u32 GetHardwareThreadCount();
+
+		// NOTE: Makes the synchronous read or write (such as NamedPipe::ReadExact()) the thread is currently blocked on fail right away,
+		//		 does nothing if it isn't blocked on any
+		void CancelBlockingIO(std::thread& thread);
+
+		// NOTE: Invokes the input function once for every index in [0, indexCount) spread across up to threadCount worker threads
+		//		 with each worker pulling the next available index, only returns after all of them have finished
+		void ParallelForEachIndex(size_t indexCount, u32 threadCount, const std::function<void(size_t index)>& perIndexFunc);
+
+		// NOTE: Like ParallelForEachIndex() but starts the most costly indices first (so that the batch doesn't end up waiting on a single large straggler)
+		//		 and only admits a new index once the sum of the costs of all in-flight indices stays within the budget, otherwise the largest one that still fits is picked
+		//		 or the worker waits for others to finish. A single index costing more than the entire budget is only run once nothing else is in flight.
+		//		 A budget of 0 means unlimited
+		void BudgetedParallelForEachIndex(const std::vector<u64>& indexCosts, u32 threadCount, u64 costBudget, const std::function<void(size_t index)>& perIndexFunc);
+
+		// NOTE: Fixed set of worker threads running submitted tasks in submission order, for when the total amount of work isn't known up front.
+		//		 Destruction waits for all remaining tasks to finish
+		class ThreadPool : NonCopyable
+		{
+		public:
+			explicit ThreadPool(u32 threadCount);
+			~ThreadPool();
+
+			void Submit(std::function<void()> task);
+
+		private:
+			struct State;
+			std::unique_ptr<State> state;
+		};
+	}
+
+	namespace Crypto
+	{
+		constexpr size_t Aes128KeySize = 16;
+		constexpr size_t Aes256KeySize = 32;
+		constexpr size_t AesIVSize = 16;
+		constexpr size_t AesBlockAlignment = 16;
+
+		using Aes128KeyBytes = std::array<u8, Aes128KeySize>;
+		using Aes256KeyBytes = std::array<u8, Aes256KeySize>;
+		using AesIVBytes = std::array<u8, AesIVSize>;
+
+		constexpr size_t Align(size_t value, size_t alignment) { return (value + (alignment - 1)) & ~(alignment - 1); }
+
+		// NOTE: Keeps the algorithm provider open and the expanded key schedule around for repeated use,
+		//		 the functions below create a temporary one for every call instead. Mustn't be used by multiple threads at the same time
+		class AesCbcKey : NonCopyable
+		{
+		public:
+			AesCbcKey(const u8* key, size_t keySize);
+			~AesCbcKey();
+
+			bool IsValid() const;
+
+			bool Decrypt(const u8* inEncryptedData, u8* outDecryptedData, size_t inOutDataSize, AesIVBytes iv) const;
+			bool Encrypt(const u8* inDecryptedData, u8* outEncryptedData, size_t inOutDataSize, AesIVBytes iv) const;
+
+		private:
+			void* algorithmHandle;
+			void* keyHandle;
+			Memory::TrackedBuffer keyObject;
+		};
+
+		bool DecryptAes128Cbc(const u8* inEncryptedData, u8* outDecryptedData, size_t inOutDataSize, Aes128KeyBytes key, AesIVBytes iv);
+		bool EncryptAes128Cbc(const u8* inDecryptedData, u8* outEncryptedData, size_t inOutDataSize, Aes128KeyBytes key, AesIVBytes iv);
+
+		bool DecryptAes256Cbc(const u8* inEncryptedData, u8* outDecryptedData, size_t inOutDataSize, Aes256KeyBytes key, AesIVBytes iv);
+		bool EncryptAes256Cbc(const u8* inDecryptedData, u8* outEncryptedData, size_t inOutDataSize, Aes256KeyBytes key, AesIVBytes iv);
+
+		Aes128KeyBytes ParseAes128KeyHexByteString(std::string_view hexByteString);
+		Aes256KeyBytes ParseAes256KeyHexByteString(std::string_view hexByteString);
+
+		constexpr size_t Sha256DigestSize = 32;
+		using Sha256Digest = std::array<u8, Sha256DigestSize>;
+
+		// NOTE: For incrementally hashing data that isn't available as a single contiguous buffer
+		class Sha256Hasher : NonCopyable
+		{
+		public:
+			Sha256Hasher();
+			// NOTE: Computes an HMAC-SHA256 instead
+			Sha256Hasher(const u8* hmacKey, size_t hmacKeySize);
+			~Sha256Hasher();
+
+			void Update(const u8* data, size_t dataSize);
+			Sha256Digest Finish();
+
+		private:
+			void* algorithmHandle;
+			void* hashHandle;
+			Memory::TrackedBuffer hashObject;
+		};
+
+		Sha256Digest HashSha256(const u8* data, size_t dataSize);
+		Sha256Digest HmacSha256(const u8* key, size_t keySize, const u8* data, size_t dataSize);
+
+		// NOTE: As 64 lower case hex digits without any separators
+		std::string FormatSha256DigestHexString(const Sha256Digest& digest);
+		Sha256Digest ParseSha256DigestHexString(std::string_view hexByteString);
+	}
+
+	namespace Compression
+	{
+		bool HasValidGZipHeader(const u8* fileContent, size_t fileSize);
+
+		// NOTE: Only succeeds once the end of the stream (including the GZip CRC32 + size trailer) has been validated
+		bool Inflate(const u8* inCompressedData, size_t inDataSize, u8* outDecompressedData, size_t outDataSize);
+		// NOTE: Decompresses in fixed size chunks without the need for an output buffer large enough to hold everything
+		bool InflateStreamed(const u8* inCompressedData, size_t inDataSize, const std::function<void(const u8* chunk, size_t chunkSize)>& perChunkFunc, size_t* outDecompressedSize = nullptr);
+		size_t Deflate(const u8* inData, size_t inDataSize, u8* outCompressedData, size_t outDataSize);
+
+		// NOTE: Incremental counterpart to InflateStreamed() for compressed data arriving in chunks of any size (such as through stdin).
+		//		 Anything following the end of the stream (such as AES padding) is ignored
+		class Inflater : NonCopyable
+		{
+		public:
+			Inflater();
+			~Inflater();
+
+			// NOTE: Returns false for corrupted data
+			bool Update(const u8* inCompressedData, size_t inDataSize, const std::function<void(const u8* chunk, size_t chunkSize)>& perChunkFunc);
+			// NOTE: Only true once the end of the stream (including the GZip CRC32 + size trailer) has been validated
+			bool IsFinished() const;
+
+		private:
+			struct State;
+			std::unique_ptr<State> state;
+		};
+
+		// NOTE: Same as Deflate() but keeps the (~256KB) zlib stream state alive between calls,
+		//		 resetting it instead of reallocating and reinitializing it for every file
+		class Deflater : NonCopyable
+		{
+		public:
+			Deflater();
+			~Deflater();
+
+			size_t Deflate(const u8* inData, size_t inDataSize, u8* outCompressedData, size_t outDataSize);
+
+			// NOTE: For input arriving in chunks of any size, compressed data is passed on as soon as it becomes available.
+			//		 Finish() must be called once after the last Update() and leaves the deflater ready for reuse
+			bool Update(const u8* inData, size_t inDataSize, const std::function<void(const u8* chunk, size_t chunkSize)>& perChunkFunc);
+			bool Finish(const std::function<void(const u8* chunk, size_t chunkSize)>& perChunkFunc);
+
+		private:
+			bool DeflateStreamed(const u8* inData, size_t inDataSize, int flush, const std::function<void(const u8* chunk, size_t chunkSize)>& perChunkFunc);
+
+		private:
+			struct State;
+			std::unique_ptr<State> state;
+		};
+	}
+}
@@ -0,0 +1,414 @@
+#include "Tests.h"
+#include "RomFS.h"
+
+using namespace TaikoSwitchDataTableDecryptor;
+
+namespace
+{
+	// NOTE: Field offsets of the raw directory and file entries, used to corrupt otherwise valid images
+	constexpr size_t DirectoryEntryFirstFileOffset = 0x0C, DirectoryEntryNextInHashBucketOffset = 0x10, DirectoryEntryNameSizeOffset = 0x14;
+	constexpr size_t FileEntrySiblingOffset = 0x04, FileEntryDataOffsetOffset = 0x08, FileEntryNameSizeOffset = 0x1C;
+
+	constexpr size_t HeaderDirectoryHashTableOffsetOffset = 0x08, HeaderDirectoryMetaTableOffsetOffset = 0x18, HeaderFileMetaTableOffsetOffset = 0x38, HeaderFileMetaTableSizeOffset = 0x40;
+
+	void WriteU32(std::vector<u8>& data, size_t offset, u32 value) { memcpy(data.data() + offset, &value, sizeof(value)); }
+	void WriteU64(std::vector<u8>& data, size_t offset, u64 value) { memcpy(data.data() + offset, &value, sizeof(value)); }
+	u64 ReadU64(const std::vector<u8>& data, size_t offset) { u64 value = 0; memcpy(&value, data.data() + offset, sizeof(value)); return value; }
+
+	// NOTE: Same hash as RomFS.cpp, duplicated on purpose so that a change to either of them shows up as a failed lookup
+	u32 CalculateEntryNameHash(u32 parentOffset, std::string_view name)
+	{
+		u32 hash = parentOffset ^ 123456789;
+		for (const char c : name)
+		{
+			hash = (hash >> 5) | (hash << 27);
+			hash ^= static_cast<u8>(c);
+		}
+		return hash;
+	}
+
+	// NOTE: Builds minimal but complete level 3 RomFS images in memory, laid out the same way as the official tools do
+	class SyntheticRomFSImage
+	{
+	public:
+		static constexpr u32 RootDirectoryOffset = RomFSImage::RootDirectoryOffset;
+
+		struct Entry
+		{
+			u32 Offset;
+			u32 ParentOffset;
+			std::string Name;
+			u32 SiblingOffset = RomFSImage::InvalidEntryOffset;
+			u32 FirstChildDirectoryOffset = RomFSImage::InvalidEntryOffset;
+			u32 FirstFileOffset = RomFSImage::InvalidEntryOffset;
+			std::string Content;
+		};
+
+		SyntheticRomFSImage()
+		{
+			directories.push_back(Entry { RootDirectoryOffset, RootDirectoryOffset, "" });
+			directoryMetaTableSize = GetEntrySize(0x18, "");
+		}
+
+		u32 AddDirectory(u32 parentOffset, std::string_view name)
+		{
+			Entry entry = { directoryMetaTableSize, parentOffset, std::string(name) };
+			directoryMetaTableSize += GetEntrySize(0x18, name);
+
+			AppendToSiblingChain(directories, FindDirectory(parentOffset).FirstChildDirectoryOffset, entry.Offset);
+			directories.push_back(std::move(entry));
+			return directories.back().Offset;
+		}
+
+		u32 AddFile(u32 parentOffset, std::string_view name, std::string_view content)
+		{
+			Entry entry = { fileMetaTableSize, parentOffset, std::string(name) };
+			entry.Content = content;
+			fileMetaTableSize += GetEntrySize(0x20, name);
+
+			AppendToSiblingChain(files, FindDirectory(parentOffset).FirstFileOffset, entry.Offset);
+			files.push_back(std::move(entry));
+			return files.back().Offset;
+		}
+
+		std::vector<u8> Build(u32 bucketCount) const
+		{
+			const u64 directoryHashTableOffset = 0x50;
+			const u64 directoryMetaTableOffset = directoryHashTableOffset + (bucketCount * sizeof(u32));
+			const u64 fileHashTableOffset = directoryMetaTableOffset + directoryMetaTableSize;
+			const u64 fileMetaTableOffset = fileHashTableOffset + (bucketCount * sizeof(u32));
+			const u64 fileDataOffset = Align(fileMetaTableOffset + fileMetaTableSize, 0x10);
+
+			u64 fileDataSize = 0;
+			for (const Entry& file : files)
+				fileDataSize = Align(fileDataSize + file.Content.size(), 0x10);
+
+			std::vector<u8> image(static_cast<size_t>(fileDataOffset + fileDataSize));
+			const u64 header[] =
+			{
+				0x50,
+				directoryHashTableOffset, bucketCount * sizeof(u32), directoryMetaTableOffset, directoryMetaTableSize,
+				fileHashTableOffset, bucketCount * sizeof(u32), fileMetaTableOffset, fileMetaTableSize,
+				fileDataOffset,
+			};
+			memcpy(image.data(), header, sizeof(header));
+
+			WriteTable(image, directories, directoryHashTableOffset, directoryMetaTableOffset, bucketCount, false, 0);
+			WriteTable(image, files, fileHashTableOffset, fileMetaTableOffset, bucketCount, true, fileDataOffset);
+			return image;
+		}
+
+	private:
+		static u32 GetEntrySize(u32 entryHeaderSize, std::string_view name) { return entryHeaderSize + static_cast<u32>(Align(name.size(), 4)); }
+		static u64 Align(u64 value, u64 alignment) { return (value + (alignment - 1)) & ~(alignment - 1); }
+
+		Entry& FindDirectory(u32 directoryOffset)
+		{
+			return *std::find_if(directories.begin(), directories.end(), [&](const Entry& entry) { return entry.Offset == directoryOffset; });
+		}
+
+		static void AppendToSiblingChain(std::vector<Entry>& entries, u32& firstOffset, u32 newOffset)
+		{
+			if (firstOffset == RomFSImage::InvalidEntryOffset)
+			{
+				firstOffset = newOffset;
+				return;
+			}
+
+			Entry* last = &*std::find_if(entries.begin(), entries.end(), [&](const Entry& entry) { return entry.Offset == firstOffset; });
+			while (last->SiblingOffset != RomFSImage::InvalidEntryOffset)
+				last = &*std::find_if(entries.begin(), entries.end(), [&](const Entry& entry) { return entry.Offset == last->SiblingOffset; });
+			last->SiblingOffset = newOffset;
+		}
+
+		static void WriteTable(std::vector<u8>& image, const std::vector<Entry>& entries, u64 hashTableOffset, u64 metaTableOffset, u32 bucketCount, bool isFileTable, u64 fileDataOffset)
+		{
+			for (u32 bucket = 0; bucket < bucketCount; bucket++)
+				WriteU32(image, static_cast<size_t>(hashTableOffset + bucket * sizeof(u32)), RomFSImage::InvalidEntryOffset);
+
+			u64 nextFileDataOffset = 0;
+			for (const Entry& entry : entries)
+			{
+				// NOTE: New entries are pushed to the front of their bucket chain
+				const size_t bucketOffset = static_cast<size_t>(hashTableOffset + (CalculateEntryNameHash(entry.ParentOffset, entry.Name) % bucketCount) * sizeof(u32));
+				u32 nextInHashBucketOffset = 0;
+				memcpy(&nextInHashBucketOffset, image.data() + bucketOffset, sizeof(u32));
+				WriteU32(image, bucketOffset, entry.Offset);
+
+				const size_t entryOffset = static_cast<size_t>(metaTableOffset + entry.Offset);
+				WriteU32(image, entryOffset + 0x00, entry.ParentOffset);
+				WriteU32(image, entryOffset + 0x04, entry.SiblingOffset);
+
+				size_t nameOffset = 0;
+				if (isFileTable)
+				{
+					WriteU64(image, entryOffset + 0x08, nextFileDataOffset);
+					WriteU64(image, entryOffset + 0x10, entry.Content.size());
+					WriteU32(image, entryOffset + 0x18, nextInHashBucketOffset);
+					WriteU32(image, entryOffset + 0x1C, static_cast<u32>(entry.Name.size()));
+					nameOffset = entryOffset + 0x20;
+
+					memcpy(image.data() + fileDataOffset + nextFileDataOffset, entry.Content.data(), entry.Content.size());
+					nextFileDataOffset = Align(nextFileDataOffset + entry.Content.size(), 0x10);
+				}
+				else
+				{
+					WriteU32(image, entryOffset + 0x08, entry.FirstChildDirectoryOffset);
+					WriteU32(image, entryOffset + 0x0C, entry.FirstFileOffset);
+					WriteU32(image, entryOffset + 0x10, nextInHashBucketOffset);
+					WriteU32(image, entryOffset + 0x14, static_cast<u32>(entry.Name.size()));
+					nameOffset = entryOffset + 0x18;
+				}
+
+				memcpy(image.data() + nameOffset, entry.Name.data(), entry.Name.size());
+			}
+		}
+
+		std::vector<Entry> directories, files;
+		u32 directoryMetaTableSize = 0, fileMetaTableSize = 0;
+	};
+
+	std::string_view GetContent(const RomFSFile& file)
+	{
+		return std::string_view(reinterpret_cast<const char*>(file.Data), file.Size);
+	}
+}
+
+TEST_CASE(RomFS_NestedDirectories)
+{
+	SyntheticRomFSImage builder;
+	const u32 dataTable = builder.AddDirectory(SyntheticRomFSImage::RootDirectoryOffset, "datatable");
+	const u32 sound = builder.AddDirectory(SyntheticRomFSImage::RootDirectoryOffset, "sound");
+	const u32 song = builder.AddDirectory(sound, "song");
+	const u32 nestedDataTable = builder.AddDirectory(song, "datatable");
+	builder.AddFile(SyntheticRomFSImage::RootDirectoryOffset, "root.bin", "root");
+	builder.AddFile(dataTable, "musicinfo.bin", "musicinfo content");
+	builder.AddFile(dataTable, "wordlist.bin", "wordlist content");
+	builder.AddFile(dataTable, "readme.txt", "text");
+	builder.AddFile(nestedDataTable, "musicinfo.bin", "nested musicinfo content");
+
+	const std::vector<u8> imageData = builder.Build(7);
+	RomFSImage image;
+	CHECK(image.Parse(imageData.data(), imageData.size()));
+
+	CHECK(image.FindDirectory("") == RomFSImage::RootDirectoryOffset);
+	CHECK(image.FindDirectory("datatable") == dataTable);
+	CHECK(image.FindDirectory("/datatable/") == dataTable);
+	CHECK(image.FindDirectory("sound/song") == song);
+	CHECK(image.FindDirectory("sound//song/datatable") == nestedDataTable);
+	CHECK(image.FindDirectory("song") == RomFSImage::InvalidEntryOffset);
+	CHECK(image.FindDirectory("sound/datatable") == RomFSImage::InvalidEntryOffset);
+	CHECK(image.FindDirectory("DataTable") == RomFSImage::InvalidEntryOffset);
+	CHECK(image.FindDirectory("datatable/musicinfo.bin") == RomFSImage::InvalidEntryOffset);
+
+	std::vector<RomFSFile> files;
+	CHECK(image.GetFilesInDirectory(dataTable, files));
+	CHECK(files.size() == 3);
+	if (files.size() == 3)
+	{
+		CHECK(files[0].Name == "musicinfo.bin" && GetContent(files[0]) == "musicinfo content");
+		CHECK(files[1].Name == "wordlist.bin" && GetContent(files[1]) == "wordlist content");
+		CHECK(files[2].Name == "readme.txt" && GetContent(files[2]) == "text");
+	}
+
+	std::vector<RomFSFile> nestedFiles;
+	CHECK(image.GetFilesInDirectory(image.FindDirectory("sound/song/datatable"), nestedFiles));
+	CHECK(nestedFiles.size() == 1 && GetContent(nestedFiles[0]) == "nested musicinfo content");
+
+	std::vector<RomFSFile> rootFiles;
+	CHECK(image.GetFilesInDirectory(RomFSImage::RootDirectoryOffset, rootFiles));
+	CHECK(rootFiles.size() == 1 && rootFiles[0].Name == "root.bin");
+}
+
+TEST_CASE(RomFS_HashBucketCollisions)
+{
+	// NOTE: A single bucket puts every directory into the same chain while a few buckets mix shared and separate chains
+	for (const u32 bucketCount : { 1u, 3u, 64u })
+	{
+		SyntheticRomFSImage builder;
+		std::vector<std::pair<std::string, u32>> directories;
+		for (u32 i = 0; i < 24; i++)
+		{
+			const std::string name = "directory_" + std::to_string(i);
+			const u32 parentOffset = (i % 2 == 0 || directories.empty()) ? SyntheticRomFSImage::RootDirectoryOffset : directories.front().second;
+			const std::string path = (parentOffset == SyntheticRomFSImage::RootDirectoryOffset) ? name : (directories.front().first + "/" + name);
+			directories.emplace_back(path, builder.AddDirectory(parentOffset, name));
+		}
+
+		const std::vector<u8> imageData = builder.Build(bucketCount);
+		RomFSImage image;
+		CHECK(image.Parse(imageData.data(), imageData.size()));
+
+		for (const auto&[path, offset] : directories)
+			CHECK(image.FindDirectory(path) == offset);
+
+		CHECK(image.FindDirectory("directory_1") == RomFSImage::InvalidEntryOffset);
+		CHECK(image.FindDirectory("directory_24") == RomFSImage::InvalidEntryOffset);
+	}
+}
+
+TEST_CASE(RomFS_EmptyDirectory)
+{
+	SyntheticRomFSImage builder;
+	const u32 empty = builder.AddDirectory(SyntheticRomFSImage::RootDirectoryOffset, "empty");
+	const u32 dataTable = builder.AddDirectory(SyntheticRomFSImage::RootDirectoryOffset, "datatable");
+	builder.AddFile(dataTable, "musicinfo.bin", "musicinfo content");
+
+	const std::vector<u8> imageData = builder.Build(4);
+	RomFSImage image;
+	CHECK(image.Parse(imageData.data(), imageData.size()));
+	CHECK(image.FindDirectory("empty") == empty);
+
+	std::vector<RomFSFile> files;
+	CHECK(image.GetFilesInDirectory(empty, files));
+	CHECK(files.empty());
+
+	std::vector<RomFSFile> rootFiles;
+	CHECK(image.GetFilesInDirectory(RomFSImage::RootDirectoryOffset, rootFiles));
+	CHECK(rootFiles.empty());
+}
+
+TEST_CASE(RomFS_OutOfBoundsOffsets)
+{
+	SyntheticRomFSImage builder;
+	const u32 dataTable = builder.AddDirectory(SyntheticRomFSImage::RootDirectoryOffset, "datatable");
+	builder.AddFile(dataTable, "first.bin", "first content");
+	const u32 second = builder.AddFile(dataTable, "second.bin", "second content");
+	builder.AddFile(dataTable, "third.bin", "third content");
+
+	const std::vector<u8> validImageData = builder.Build(4);
+	const size_t directoryMetaTableOffset = static_cast<size_t>(ReadU64(validImageData, HeaderDirectoryMetaTableOffsetOffset));
+	const size_t fileMetaTableOffset = static_cast<size_t>(ReadU64(validImageData, HeaderFileMetaTableOffsetOffset));
+
+	RomFSImage image;
+	CHECK(!image.Parse(nullptr, 0));
+	CHECK(!image.Parse(validImageData.data(), 0x4F));
+	CHECK(!image.Parse(validImageData.data(), static_cast<size_t>(ReadU64(validImageData, HeaderFileMetaTableOffsetOffset))));
+
+	{
+		std::vector<u8> imageData = validImageData;
+		WriteU64(imageData, HeaderFileMetaTableSizeOffset, imageData.size());
+		CHECK(!image.Parse(imageData.data(), imageData.size()));
+	}
+
+	{
+		std::vector<u8> imageData = validImageData;
+		WriteU64(imageData, HeaderDirectoryHashTableOffsetOffset, ~0ull);
+		CHECK(!image.Parse(imageData.data(), imageData.size()));
+	}
+
+	{
+		// NOTE: The files before the broken one are still returned
+		std::vector<u8> imageData = validImageData;
+		WriteU64(imageData, fileMetaTableOffset + second + FileEntryDataOffsetOffset, imageData.size());
+		CHECK(image.Parse(imageData.data(), imageData.size()));
+
+		std::vector<RomFSFile> files;
+		CHECK(!image.GetFilesInDirectory(dataTable, files));
+		CHECK(files.size() == 1 && files[0].Name == "first.bin");
+	}
+
+	{
+		std::vector<u8> imageData = validImageData;
+		WriteU64(imageData, fileMetaTableOffset + second + FileEntryDataOffsetOffset, ~0ull - 4);
+		CHECK(image.Parse(imageData.data(), imageData.size()));
+
+		std::vector<RomFSFile> files;
+		CHECK(!image.GetFilesInDirectory(dataTable, files));
+	}
+
+	{
+		std::vector<u8> imageData = validImageData;
+		WriteU32(imageData, fileMetaTableOffset + second + FileEntryNameSizeOffset, 0x10000);
+		CHECK(image.Parse(imageData.data(), imageData.size()));
+
+		std::vector<RomFSFile> files;
+		CHECK(!image.GetFilesInDirectory(dataTable, files));
+	}
+
+	{
+		std::vector<u8> imageData = validImageData;
+		WriteU32(imageData, fileMetaTableOffset + second + FileEntrySiblingOffset, 0x7FFFFFF0);
+		CHECK(image.Parse(imageData.data(), imageData.size()));
+
+		std::vector<RomFSFile> files;
+		CHECK(!image.GetFilesInDirectory(dataTable, files));
+		CHECK(files.size() == 2);
+	}
+
+	{
+		std::vector<u8> imageData = validImageData;
+		WriteU32(imageData, directoryMetaTableOffset + dataTable + DirectoryEntryFirstFileOffset, 0x7FFFFFF0);
+		CHECK(image.Parse(imageData.data(), imageData.size()));
+
+		std::vector<RomFSFile> files;
+		CHECK(!image.GetFilesInDirectory(dataTable, files));
+		CHECK(files.empty());
+	}
+
+	{
+		std::vector<u8> imageData = validImageData;
+		WriteU32(imageData, directoryMetaTableOffset + dataTable + DirectoryEntryNameSizeOffset, 0x10000);
+		CHECK(image.Parse(imageData.data(), imageData.size()));
+		CHECK(image.FindDirectory("datatable") == RomFSImage::InvalidEntryOffset);
+
+		std::vector<RomFSFile> files;
+		CHECK(!image.GetFilesInDirectory(dataTable, files));
+	}
+
+	{
+		std::vector<u8> imageData = validImageData;
+		const size_t bucketCount = 4;
+		for (size_t bucket = 0; bucket < bucketCount; bucket++)
+			WriteU32(imageData, static_cast<size_t>(ReadU64(imageData, HeaderDirectoryHashTableOffsetOffset) + bucket * sizeof(u32)), 0x7FFFFFF0);
+		CHECK(image.Parse(imageData.data(), imageData.size()));
+		CHECK(image.FindDirectory("datatable") == RomFSImage::InvalidEntryOffset);
+	}
+
+	CHECK(image.Parse(validImageData.data(), validImageData.size()));
+	std::vector<RomFSFile> files;
+	CHECK(!image.GetFilesInDirectory(0x7FFFFFF0, files));
+	CHECK(!RomFSImage().GetFilesInDirectory(RomFSImage::RootDirectoryOffset, files));
+}
+
+TEST_CASE(RomFS_CyclicOffsets)
+{
+	SyntheticRomFSImage builder;
+	const u32 dataTable = builder.AddDirectory(SyntheticRomFSImage::RootDirectoryOffset, "datatable");
+	const u32 sound = builder.AddDirectory(SyntheticRomFSImage::RootDirectoryOffset, "sound");
+	const u32 first = builder.AddFile(dataTable, "first.bin", "first content");
+	const u32 second = builder.AddFile(dataTable, "second.bin", "second content");
+
+	const std::vector<u8> validImageData = builder.Build(1);
+	const size_t directoryMetaTableOffset = static_cast<size_t>(ReadU64(validImageData, HeaderDirectoryMetaTableOffsetOffset));
+	const size_t fileMetaTableOffset = static_cast<size_t>(ReadU64(validImageData, HeaderFileMetaTableOffsetOffset));
+
+	RomFSImage image;
+	{
+		std::vector<u8> imageData = validImageData;
+		WriteU32(imageData, fileMetaTableOffset + second + FileEntrySiblingOffset, first);
+		CHECK(image.Parse(imageData.data(), imageData.size()));
+
+		std::vector<RomFSFile> files;
+		CHECK(!image.GetFilesInDirectory(dataTable, files));
+	}
+
+	{
+		std::vector<u8> imageData = validImageData;
+		WriteU32(imageData, fileMetaTableOffset + first + FileEntrySiblingOffset, first);
+		CHECK(image.Parse(imageData.data(), imageData.size()));
+
+		std::vector<RomFSFile> files;
+		CHECK(!image.GetFilesInDirectory(dataTable, files));
+	}
+
+	{
+		// NOTE: With a single bucket every directory shares one chain, looping it back onto itself must not hang the lookup of a missing name.
+		//		 The chain starts at the most recently added "sound" directory and ends at the root directory
+		std::vector<u8> imageData = validImageData;
+		WriteU32(imageData, directoryMetaTableOffset + SyntheticRomFSImage::RootDirectoryOffset + DirectoryEntryNextInHashBucketOffset, sound);
+		CHECK(image.Parse(imageData.data(), imageData.size()));
+		CHECK(image.FindDirectory("missing") == RomFSImage::InvalidEntryOffset);
+		CHECK(image.FindDirectory("datatable") == dataTable);
+	}
+}
@@ -0,0 +1,147 @@
+#include "Tests.h"
+#include "ShardClaims.h"
+#include <Windows.h>
+#include <chrono>
+
+using namespace TaikoSwitchDataTableDecryptor;
+using namespace TaikoSwitchDataTableTests;
+
+namespace
+{
+	constexpr size_t ShardCount = 12;
+	constexpr size_t SurvivingWorkerCount = 3;
+	constexpr u32 ClaimTimeoutSeconds = 1;
+	constexpr int KilledWorkerExitCode = 3;
+
+	constexpr auto WorkerPollInterval = std::chrono::milliseconds(100);
+	constexpr auto SimulatedConversionDuration = std::chrono::milliseconds(50);
+
+	std::string FormatShardName(size_t shardIndex)
+	{
+		char shardName[32];
+		sprintf_s(shardName, "shard_%02zu", shardIndex);
+		return shardName;
+	}
+
+	// NOTE: Marker files recording which worker converted (or took over the stale claim of) which shard
+	std::string FormatMarkerFilePath(std::string_view directoryPath, size_t shardIndex, std::string_view markerName, std::string_view workerName)
+	{
+		return std::string(directoryPath) + "/" + FormatShardName(shardIndex) + "." + std::string(markerName) + "_by_" + std::string(workerName);
+	}
+
+	bool CreateMarkerFile(std::string_view directoryPath, size_t shardIndex, std::string_view markerName, std::string_view workerName)
+	{
+		return PeepoHappy::IO::CreateNewFile(FormatMarkerFilePath(directoryPath, shardIndex, markerName, workerName), reinterpret_cast<const u8*>(workerName.data()), workerName.size());
+	}
+
+	bool MarkerFileExists(std::string_view directoryPath, size_t shardIndex, std::string_view markerName, std::string_view workerName)
+	{
+		return (PeepoHappy::IO::GetFileSize(FormatMarkerFilePath(directoryPath, shardIndex, markerName, workerName)) > 0);
+	}
+}
+
+// NOTE: Arguments: {shared_directory} {worker_name} [kill]. Walks all shards the same way ConvertAllInputFilesUsingSharedShards() does,
+//		 except that "converting" a shard only creates a marker file. With "kill" the worker terminates itself as soon as it holds its first claim
+TEST_CHILD_PROCESS(ShardWorker)
+{
+	if (arguments.size() < 2)
+		return EXIT_WIDEPEEPOSAD;
+
+	const std::string_view directoryPath = arguments[0];
+	const std::string_view workerName = arguments[1];
+	const bool killWhileHoldingClaim = (arguments.size() > 2 && arguments[2] == "kill");
+
+	ShardClaimDirectory claims(directoryPath, ClaimTimeoutSeconds);
+	if (!claims.IsValid())
+		return EXIT_WIDEPEEPOSAD;
+
+	std::array<bool, ShardCount> finished = {};
+	size_t remainingCount = ShardCount;
+	while (remainingCount > 0)
+	{
+		for (size_t shardIndex = 0; shardIndex < ShardCount; shardIndex++)
+		{
+			if (finished[shardIndex])
+				continue;
+
+			const std::string shardName = FormatShardName(shardIndex);
+			const ShardClaimResult claimResult = claims.TryClaim(shardName);
+			if (claimResult == ShardClaimResult::ClaimedByOther)
+				continue;
+
+			if (claimResult != ShardClaimResult::Done)
+			{
+				// NOTE: Terminated the hard way so that neither the heartbeat thread nor any destructor gets to clean up after the claim
+				if (killWhileHoldingClaim)
+					::TerminateProcess(::GetCurrentProcess(), KilledWorkerExitCode);
+
+				if (claimResult == ShardClaimResult::TakenOver && !CreateMarkerFile(directoryPath, shardIndex, "taken_over", workerName))
+					return EXIT_WIDEPEEPOSAD;
+
+				std::this_thread::sleep_for(SimulatedConversionDuration);
+				if (!CreateMarkerFile(directoryPath, shardIndex, "converted", workerName) || !claims.Finish(shardName, workerName))
+					return EXIT_WIDEPEEPOSAD;
+			}
+
+			finished[shardIndex] = true;
+			remainingCount--;
+		}
+
+		if (remainingCount > 0)
+			std::this_thread::sleep_for(WorkerPollInterval);
+	}
+
+	return EXIT_WIDEPEEPOHAPPY;
+}
+
+TEST_CASE(ShardClaims_WorkerKilledWhileHoldingClaim)
+{
+	char directoryPathBuffer[64];
+	sprintf_s(directoryPathBuffer, "TaikoSwitchDataTableTests_shards_%lu", static_cast<unsigned long>(::GetCurrentProcessId()));
+	const std::string directoryPath = directoryPathBuffer;
+	CHECK(PeepoHappy::IO::CreateDirectoryRecursive(directoryPath));
+
+	// NOTE: The killed worker runs on its own first so that it is guaranteed to die holding the claim of the very first shard,
+	//		 which the remaining workers (all running at the same time) then have to take over once it has become stale
+	ChildProcess killedWorker = StartChildProcess("ShardWorker", { directoryPath, "killed", "kill" });
+	CHECK(WaitForChildProcess(killedWorker) == KilledWorkerExitCode);
+	CHECK(PeepoHappy::IO::GetFileSize(directoryPath + "/" + FormatShardName(0) + ".claim.0") > 0);
+
+	std::vector<std::string> workerNames;
+	std::vector<ChildProcess> workers;
+	for (size_t i = 0; i < SurvivingWorkerCount; i++)
+	{
+		workerNames.push_back("worker" + std::to_string(i));
+		workers.push_back(StartChildProcess("ShardWorker", { directoryPath, workerNames.back() }));
+	}
+
+	for (ChildProcess& worker : workers)
+		CHECK(WaitForChildProcess(worker) == EXIT_WIDEPEEPOHAPPY);
+
+	for (size_t shardIndex = 0; shardIndex < ShardCount; shardIndex++)
+	{
+		size_t convertedCount = 0, takenOverCount = 0;
+		for (const std::string& workerName : workerNames)
+		{
+			convertedCount += MarkerFileExists(directoryPath, shardIndex, "converted", workerName);
+			takenOverCount += MarkerFileExists(directoryPath, shardIndex, "taken_over", workerName);
+		}
+
+		CHECK(convertedCount == 1);
+		CHECK(takenOverCount == ((shardIndex == 0) ? 1 : 0));
+		CHECK(PeepoHappy::IO::GetFileSize(directoryPath + "/" + FormatShardName(shardIndex) + ".done") > 0);
+	}
+
+	// NOTE: Removing the directory only succeeds if finishing the shards also removed every claim file, including the one left behind by the killed worker
+	for (size_t shardIndex = 0; shardIndex < ShardCount; shardIndex++)
+	{
+		PeepoHappy::IO::RemoveFile(directoryPath + "/" + FormatShardName(shardIndex) + ".done");
+		for (const std::string& workerName : workerNames)
+		{
+			PeepoHappy::IO::RemoveFile(FormatMarkerFilePath(directoryPath, shardIndex, "converted", workerName));
+			PeepoHappy::IO::RemoveFile(FormatMarkerFilePath(directoryPath, shardIndex, "taken_over", workerName));
+		}
+	}
+
+	CHECK(PeepoHappy::IO::RemoveEmptyDirectory(directoryPath));
+}
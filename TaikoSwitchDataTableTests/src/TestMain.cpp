@@ -0,0 +1,100 @@
+#include "Tests.h"
+#include <Windows.h>
+
+namespace TaikoSwitchDataTableTests
+{
+	namespace
+	{
+		size_t ThisTestCaseFailureCount = 0;
+	}
+
+	std::vector<TestCase>& GetRegisteredTestCases()
+	{
+		// NOTE: Function local so that it is guaranteed to be constructed before the first static registration uses it
+		static std::vector<TestCase> registeredTestCases;
+		return registeredTestCases;
+	}
+
+	std::vector<ChildProcessEntryPoint>& GetRegisteredChildProcessEntryPoints()
+	{
+		static std::vector<ChildProcessEntryPoint> registeredEntryPoints;
+		return registeredEntryPoints;
+	}
+
+	ChildProcess StartChildProcess(std::string_view entryPointName, const std::vector<std::string>& arguments)
+	{
+		// NOTE: None of the arguments passed by the tests contain any quotes themselves so simply quoting each one is enough
+		std::string commandLine = "\"" + PeepoHappy::UTF8::GetExecutableFilePath() + "\" --child " + std::string(entryPointName);
+		for (const std::string& argument : arguments)
+			commandLine += " \"" + argument + "\"";
+
+		std::wstring wideCommandLine = PeepoHappy::UTF8::Widen(commandLine);
+
+		::STARTUPINFOW startupInfo = {};
+		startupInfo.cb = sizeof(startupInfo);
+		::PROCESS_INFORMATION processInformation = {};
+		if (!::CreateProcessW(nullptr, wideCommandLine.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startupInfo, &processInformation))
+			return ChildProcess { nullptr };
+
+		::CloseHandle(processInformation.hThread);
+		return ChildProcess { processInformation.hProcess };
+	}
+
+	int WaitForChildProcess(ChildProcess& childProcess)
+	{
+		if (childProcess.ProcessHandle == nullptr)
+			return -1;
+
+		DWORD exitCode = 0;
+		::WaitForSingleObject(childProcess.ProcessHandle, INFINITE);
+		::GetExitCodeProcess(childProcess.ProcessHandle, &exitCode);
+
+		::CloseHandle(childProcess.ProcessHandle);
+		childProcess.ProcessHandle = nullptr;
+		return static_cast<int>(exitCode);
+	}
+
+	void ReportCheckFailure(const char* expression, const char* filePath, int lineNumber)
+	{
+		fprintf(stderr, "%s(%d): CHECK(%s) failed\n", filePath, lineNumber, expression);
+		ThisTestCaseFailureCount++;
+	}
+}
+
+int main()
+{
+	using namespace TaikoSwitchDataTableTests;
+	const auto[argc, argv] = PeepoHappy::UTF8::GetCommandLineArguments();
+
+	if (argc > 2 && std::string_view(argv[1]) == "--child")
+	{
+		for (const ChildProcessEntryPoint& entryPoint : GetRegisteredChildProcessEntryPoints())
+		{
+			if (std::string_view(entryPoint.Name) == argv[2])
+				return entryPoint.Function(std::vector<std::string_view>(argv + 3, argv + argc));
+		}
+
+		fprintf(stderr, "Unknown child process entry point '%s'\n", argv[2]);
+		return EXIT_WIDEPEEPOSAD;
+	}
+
+	// NOTE: Optionally only runs the test cases whose name contains the given filter text
+	const std::string_view filter = (argc > 1) ? argv[1] : "";
+
+	size_t runCount = 0, failedCount = 0;
+	for (const TestCase& testCase : GetRegisteredTestCases())
+	{
+		if (!filter.empty() && std::string_view(testCase.Name).find(filter) == std::string_view::npos)
+			continue;
+
+		ThisTestCaseFailureCount = 0;
+		testCase.Function();
+
+		printf("[%s] %s\n", (ThisTestCaseFailureCount == 0) ? " OK " : "FAIL", testCase.Name);
+		failedCount += (ThisTestCaseFailureCount > 0);
+		runCount++;
+	}
+
+	printf("%zu of %zu test case(s) passed\n", runCount - failedCount, runCount);
+	return (failedCount == 0 && runCount > 0) ? EXIT_WIDEPEEPOHAPPY : EXIT_WIDEPEEPOSAD;
+}
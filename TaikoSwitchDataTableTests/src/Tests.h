@@ -0,0 +1,60 @@
+#pragma once
+#include "Types.h"
+#include "Utilities.h"
+
+namespace TaikoSwitchDataTableTests
+{
+	struct TestCase
+	{
+		const char* Name;
+		void(*Function)();
+	};
+
+	std::vector<TestCase>& GetRegisteredTestCases();
+
+	struct TestCaseRegistration
+	{
+		TestCaseRegistration(const char* name, void(*function)()) { GetRegisteredTestCases().push_back(TestCase { name, function }); }
+	};
+
+	// NOTE: Run instead of the test cases when this executable is started using "--child {name} {arguments...}",
+	//		 for test cases that need more than one process (such as several workers sharing a directory)
+	struct ChildProcessEntryPoint
+	{
+		const char* Name;
+		int(*Function)(const std::vector<std::string_view>& arguments);
+	};
+
+	std::vector<ChildProcessEntryPoint>& GetRegisteredChildProcessEntryPoints();
+
+	struct ChildProcessEntryPointRegistration
+	{
+		ChildProcessEntryPointRegistration(const char* name, int(*function)(const std::vector<std::string_view>&)) { GetRegisteredChildProcessEntryPoints().push_back(ChildProcessEntryPoint { name, function }); }
+	};
+
+	struct ChildProcess
+	{
+		void* ProcessHandle;
+	};
+
+	// NOTE: Starts this same executable again running only the given child process entry point, the process handle is null if that failed
+	ChildProcess StartChildProcess(std::string_view entryPointName, const std::vector<std::string>& arguments);
+	// NOTE: Returns the exit code of the child process, or -1 if it was never started
+	int WaitForChildProcess(ChildProcess& childProcess);
+
+	// NOTE: Failed checks are only counted instead of ending the test case early, so that a single run lists every failure
+	void ReportCheckFailure(const char* expression, const char* filePath, int lineNumber);
+}
+
+#define TEST_CASE(name) \
+	static void name(); \
+	static const ::TaikoSwitchDataTableTests::TestCaseRegistration name##Registration(#name, name); \
+	static void name()
+
+#define TEST_CHILD_PROCESS(name) \
+	static int name(const std::vector<std::string_view>& arguments); \
+	static const ::TaikoSwitchDataTableTests::ChildProcessEntryPointRegistration name##Registration(#name, name); \
+	static int name(const std::vector<std::string_view>& arguments)
+
+#define CHECK(expression) \
+	do { if (!(expression)) ::TaikoSwitchDataTableTests::ReportCheckFailure(#expression, __FILE__, __LINE__); } while (false)